@@ -0,0 +1,125 @@
+/*
+ file name: BinaryReader.h
+ author: Hall, Ashley
+ The BinaryReader class reads back the fixed-width integers and
+ length-prefixed strings written by a BinaryWriter, in the order they were
+ written. Strings are returned as views into the bytes, so nothing is copied.
+ Every read checks that enough bytes remain and reports a short read by
+ returning false, which lets a truncated file be detected instead of read
+ past its end.
+ */
+
+#ifndef BINARYREADER_H
+#define BINARYREADER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+class BinaryReader
+{
+public:
+
+   /**
+    BinaryReader constructor.
+    @param bytes The bytes to read.
+    @pre The characters viewed by bytes must outlive the BinaryReader and the strings it returns.
+    @post A reader positioned at the first byte will be created.
+    */
+   explicit BinaryReader(std::string_view bytes) : bytes(bytes), position(0) {}
+
+   /**
+    Reads an 8-bit value.
+    @param value Set to the value.
+    @return True if the value was read. False if too few bytes remain.
+    @pre None.
+    @post The reader will be advanced past the value if it was read.
+    */
+   bool getU8(std::uint8_t& value) { return getRaw(&value, sizeof(value)); }
+
+   /**
+    Reads a 32-bit value.
+    @param value Set to the value.
+    @return True if the value was read. False if too few bytes remain.
+    @pre None.
+    @post The reader will be advanced past the value if it was read.
+    */
+   bool getU32(std::uint32_t& value) { return getRaw(&value, sizeof(value)); }
+
+   /**
+    Reads a signed 32-bit value.
+    @param value Set to the value.
+    @return True if the value was read. False if too few bytes remain.
+    @pre None.
+    @post The reader will be advanced past the value if it was read.
+    */
+   bool getInt(std::int32_t& value) { return getRaw(&value, sizeof(value)); }
+
+   /**
+    Reads a 64-bit value.
+    @param value Set to the value.
+    @return True if the value was read. False if too few bytes remain.
+    @pre None.
+    @post The reader will be advanced past the value if it was read.
+    */
+   bool getU64(std::uint64_t& value) { return getRaw(&value, sizeof(value)); }
+
+   /**
+    Reads a string preceded by its length.
+    @param text Set to a view of the string's characters.
+    @return True if the string was read. False if too few bytes remain.
+    @pre None.
+    @post The reader will be advanced past the string if it was read.
+    */
+   bool getString(std::string_view& text)
+   {
+      std::uint32_t length;
+      std::size_t start = position;
+      if ( !getU32(length) || bytes.size() - position < length )
+      {
+         position = start;
+         return false;
+      }
+      text = bytes.substr(position, length);
+      position += length;
+      return true;
+   }
+
+   /**
+    Returns the number of bytes read so far.
+    @pre None.
+    @post The position of the next byte to read will be returned.
+    */
+   std::size_t getPosition() const { return position; }
+
+   /**
+    Determines whether every byte has been read.
+    @pre None.
+    @post True will be returned if no bytes remain. False otherwise.
+    */
+   bool atEnd() const { return position == bytes.size(); }
+
+private:
+
+   /**
+    Copies the bytes of a value.
+    @param value The address to copy to.
+    @param size The number of bytes.
+    @return True if the bytes were copied. False if too few bytes remain.
+    @pre value must point to size bytes.
+    @post The reader will be advanced past the bytes if they were copied.
+    */
+   bool getRaw(void* value, std::size_t size)
+   {
+      if ( bytes.size() - position < size )
+         return false;
+      std::memcpy(value, bytes.data() + position, size);
+      position += size;
+      return true;
+   }
+
+   std::string_view bytes; //bytes being read
+   std::size_t position; //position of the next byte to read
+};
+
+#endif
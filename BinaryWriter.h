@@ -0,0 +1,91 @@
+/*
+ file name: BinaryWriter.h
+ author: Hall, Ashley
+ The BinaryWriter class appends fixed-width integers and length-prefixed
+ strings to a byte string, for the store's write-ahead log and checkpoint
+ files. Integers are copied in the machine's own byte order, so the files are
+ read back by the same build on the same kind of machine. A BinaryReader reads
+ the values back in the order they were written.
+ */
+
+#ifndef BINARYWRITER_H
+#define BINARYWRITER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+class BinaryWriter
+{
+public:
+
+   /**
+    BinaryWriter constructor.
+    @param bytes The string the values are appended to.
+    @pre bytes must outlive the BinaryWriter.
+    @post A writer appending to the end of bytes will be created.
+    */
+   explicit BinaryWriter(std::string& bytes) : bytes(bytes) {}
+
+   /**
+    Appends an 8-bit value.
+    @param value The value.
+    @pre None.
+    @post One byte will be appended.
+    */
+   void putU8(std::uint8_t value) { bytes.push_back(static_cast<char>(value)); }
+
+   /**
+    Appends a 32-bit value.
+    @param value The value.
+    @pre None.
+    @post Four bytes will be appended.
+    */
+   void putU32(std::uint32_t value) { putRaw(&value, sizeof(value)); }
+
+   /**
+    Appends a signed 32-bit value.
+    @param value The value.
+    @pre None.
+    @post Four bytes will be appended.
+    */
+   void putInt(std::int32_t value) { putRaw(&value, sizeof(value)); }
+
+   /**
+    Appends a 64-bit value.
+    @param value The value.
+    @pre None.
+    @post Eight bytes will be appended.
+    */
+   void putU64(std::uint64_t value) { putRaw(&value, sizeof(value)); }
+
+   /**
+    Appends a string preceded by its length.
+    @param text The string.
+    @pre text must be shorter than 4 GiB.
+    @post The length as a 32-bit value and then the characters of text will be appended.
+    */
+   void putString(std::string_view text)
+   {
+      putU32(static_cast<std::uint32_t>(text.size()));
+      bytes.append(text.data(), text.size());
+   }
+
+private:
+
+   /**
+    Appends the bytes of a value.
+    @param value The address of the value.
+    @param size The number of bytes.
+    @pre value must point to size bytes.
+    @post The bytes will be appended.
+    */
+   void putRaw(const void* value, std::size_t size)
+   {
+      bytes.append(static_cast<const char*>(value), size);
+   }
+
+   std::string& bytes; //string the values are appended to
+};
+
+#endif
@@ -25,26 +25,116 @@ Coin::Coin()
 Coin::~Coin() {}
 
 /**
- Sets the data members of a Coin object to elements in the 'data' vector.
- @pre The elements in the 'data' vector must contain appropriate data and the vector must contain at
- least three elements.
+ Sets the data members of a Coin object to the fields in 'data'.
+ @pre The fields in 'data' must contain appropriate data and there must be at least three fields.
  @post The data members 'year', 'grade', and 'type' will be set to the values in data[0], data[1], and
  data[2], respectively.
  */
-bool Coin::setData(const std::vector<std::string>& data)
+bool Coin::setData(const FieldSpan& data)
 {
    //ensure data is valid
-   if ( !isValidYear(data[YEAR]) || !isValidNumber(data[GRADE])
-      || !validDataVector(data, DATA_LENGTH))
+   int yearValue;
+   int gradeValue;
+   if ( !validDataVector(data, DATA_LENGTH) || !parseYear(data[YEAR], yearValue)
+      || !parseNumber(data[GRADE], gradeValue))
    {
       return false;
    }
-   year = stoi(data[YEAR]);
-   grade = stoi(data[GRADE]);
-   type = data[TYPE];
+   year = yearValue;
+   grade = gradeValue;
+   type.assign(data[TYPE]);
    return true;
 }
 
+/**
+ Returns the number of fields setData reads.
+ @pre None.
+ @post Three, the number of fields of a Coin object, will be returned.
+ */
+int Coin::getFieldCount() const
+{
+   return DATA_LENGTH;
+}
+
+/**
+ Writes the Coin object's data fields into an output buffer in the order setData reads them.
+ @param buffer The buffer to write to.
+ @pre None.
+ @post The year, grade, and type will be appended to the buffer, separated by commas, so
+ that splitting the text and passing the fields to setData recreates the object.
+ */
+void Coin::formatData(OutputBuffer& buffer) const
+{
+   buffer.appendInt(year).append(", ").appendInt(grade).append(", ")
+      .append(type);
+}
+
+/**
+ Writes the Coin object's data fields in binary form for a store snapshot.
+ @param writer The writer to append the fields to.
+ @pre None.
+ @post The year, grade, and type will be appended in the order readData reads them.
+ */
+void Coin::writeData(BinaryWriter& writer) const
+{
+   writer.putInt(year);
+   writer.putInt(grade);
+   writer.putString(type);
+}
+
+/**
+ Sets the data members of a Coin object to the fields written by writeData.
+ @param reader The reader positioned at the fields.
+ @return True if every field could be read. False if the bytes ended first.
+ @pre The fields must have been written by Coin::writeData.
+ @post The year, grade, and type will be set and the reader advanced past them.
+ */
+bool Coin::readData(BinaryReader& reader)
+{
+   std::int32_t yearValue;
+   std::int32_t gradeValue;
+   std::string_view typeField;
+   if ( !reader.getInt(yearValue) || !reader.getInt(gradeValue)
+       || !reader.getString(typeField) )
+      return false;
+   year = yearValue;
+   grade = gradeValue;
+   type.assign(typeField);
+   return true;
+}
+
+/**
+ Allocates memory for a Coin object from the calling thread's Coin object pool.
+ @param size The size of the object being allocated.
+ @return A pointer to memory for the object.
+ @pre None.
+ @post Memory recycled from a previously deleted Coin will be returned when available. Objects of
+ classes derived from Coin are allocated by the global allocator.
+ */
+void* Coin::operator new(std::size_t size)
+{
+   if ( size != sizeof(Coin) )
+      return ::operator new(size);
+   return ObjectPool<Coin>::allocate();
+}
+
+/**
+ Returns the memory for a Coin object to the Coin object pool it was allocated from.
+ @param memory The memory of the destroyed object.
+ @param size The size of the destroyed object.
+ @pre memory must have been allocated by Coin::operator new.
+ @post The memory will be available to the next Coin allocation.
+ */
+void Coin::operator delete(void* memory, std::size_t size)
+{
+   if ( size != sizeof(Coin) )
+   {
+      ::operator delete(memory);
+      return;
+   }
+   ObjectPool<Coin>::deallocate(memory);
+}
+
 /**
  Returns a pointer to a Coin object.
  @pre None
@@ -55,6 +145,16 @@ Collectible* Coin::create() const
    return new Coin;
 }
 
+/**
+ Returns a pointer to a copy of the Coin object.
+ @pre None
+ @post A Coin object holding the same data will be created and a pointer to it will be returned.
+ */
+Collectible* Coin::clone() const
+{
+   return new Coin(*this);
+}
+
 /**
  Determines if two Coin objects are equal.
  @pre The operands must be of type Coin.
@@ -132,17 +232,13 @@ bool Coin::operator>( const Comparable& comparable ) const
 
 
 /**
- Returns the Coin object's type, year, and grade as a string.
- @return The string containing the Coin object's data.
- @pre None.
- @post The string containing the Coin object's data will be returned.
+ Writes the Coin object's type, year, and grade into an output buffer.
+ @param buffer The buffer to write to.
+ @pre buffer must be an OutputBuffer object.
+ @post The Coin object's data will be appended to the buffer, separated by commas.
  */
-std::string Coin::toString() const
+void Coin::format(OutputBuffer& buffer) const
 {
-   return type + ", " + std::to_string(year)
-   + ", " + std::to_string(grade);
+   buffer.append(type).append(", ").appendInt(year)
+      .append(", ").appendInt(grade);
 }
-
-
-
-
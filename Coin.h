@@ -9,6 +9,7 @@
 #define COIN_H
 
 #include "Collectible.h"
+#include "ObjectPool.h"
 
 class Coin : public Collectible
 {
@@ -28,14 +29,65 @@ public:
    virtual ~Coin();
    
    /**
-    Sets the data members of a Coin object to elements in the 'data' vector.
+    Sets the data members of a Coin object to the fields in 'data'.
     @param data The data needed to set the data members of the Coin object.
-    @pre The elements in the 'data' vector must contain appropriate data and the vector must contain at
-    least three elements.
+    @pre The fields in 'data' must contain appropriate data and there must be at least three fields.
     @post The data members 'year', 'grade', and 'type' will be set to the values in data[0], data[1], and
     data[2], respectively.
     */
-   virtual bool setData(const std::vector<std::string>& data);
+   virtual bool setData(const FieldSpan& data);
+   
+   /**
+    Returns the number of fields setData reads.
+    @pre None.
+    @post Three, the number of fields of a Coin object, will be returned.
+    */
+   virtual int getFieldCount() const;
+   
+   /**
+    Writes the Coin object's data fields into an output buffer in the order setData reads them.
+    @param buffer The buffer to write to.
+    @pre None.
+    @post The year, grade, and type will be appended to the buffer, separated by commas, so
+    that splitting the text and passing the fields to setData recreates the object.
+    */
+   virtual void formatData(OutputBuffer& buffer) const;
+   
+   /**
+    Writes the Coin object's data fields in binary form for a store snapshot.
+    @param writer The writer to append the fields to.
+    @pre None.
+    @post The year, grade, and type will be appended in the order readData reads them.
+    */
+   virtual void writeData(BinaryWriter& writer) const;
+   
+   /**
+    Sets the data members of a Coin object to the fields written by writeData.
+    @param reader The reader positioned at the fields.
+    @return True if every field could be read. False if the bytes ended first.
+    @pre The fields must have been written by Coin::writeData.
+    @post The year, grade, and type will be set and the reader advanced past them.
+    */
+   virtual bool readData(BinaryReader& reader);
+   
+   /**
+    Allocates memory for a Coin object from the calling thread's Coin object pool.
+    @param size The size of the object being allocated.
+    @return A pointer to memory for the object.
+    @pre None.
+    @post Memory recycled from a previously deleted Coin will be returned when available. Objects of
+    classes derived from Coin are allocated by the global allocator.
+    */
+   static void* operator new(std::size_t size);
+   
+   /**
+    Returns the memory for a Coin object to the Coin object pool it was allocated from.
+    @param memory The memory of the destroyed object.
+    @param size The size of the destroyed object.
+    @pre memory must have been allocated by Coin::operator new.
+    @post The memory will be available to the next Coin allocation.
+    */
+   static void operator delete(void* memory, std::size_t size);
    
    /**
     Returns a pointer to a Coin object.
@@ -44,6 +96,13 @@ public:
     */
    virtual Collectible* create() const;
    
+   /**
+    Returns a pointer to a copy of the Coin object.
+    @pre None
+    @post A Coin object holding the same data will be created and a pointer to it will be returned.
+    */
+   virtual Collectible* clone() const;
+   
    /**
     Determines if two Coin objects are equal.
     @pre The operands must be of type Coin.
@@ -84,12 +143,12 @@ protected:
    //protected methods
    
    /**
-    Returns the Coin object's type, year, and grade as a string.
-    @return The string containing the Coin object's data.
-    @pre None.
-    @post The string containing the Coin object's data will be returned.
+    Writes the Coin object's type, year, and grade into an output buffer.
+    @param buffer The buffer to write to.
+    @pre buffer must be an OutputBuffer object.
+    @post The Coin object's data will be appended to the buffer, separated by commas.
     */
-   virtual std::string toString() const;
+   virtual void format(OutputBuffer& buffer) const;
    
    
    //protected data members
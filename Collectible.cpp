@@ -10,6 +10,8 @@
  manufacturer, then grade.
  */
 
+#include <charconv>
+
 #include "Collectible.h"
 
 /**
@@ -23,62 +25,56 @@ Collectible::Collectible() {}
 Collectible::~Collectible() {}
 
 /**
- Determines whether a string represents an integer no less than 1.
- @param numStr The string representing the integer.
- @return True if the string represents a valid integer no less than 1. False otherwise.
- @pre numStr must be a string.
- @post True will be returned if the string represents a valid integer no less than 1. False will be
- returned otherwise.
+ Determines whether a field represents an integer no less than 1 and converts it.
+ @param numStr The field representing the integer.
+ @param number Set to the value of the integer if it is valid.
+ @return True if the field represents a valid integer no less than 1. False otherwise.
+ @pre None.
+ @post True will be returned and number will be set if numStr contains only digits and its value is
+ no less than 1 and fits in an int. False will be returned otherwise.
  */
-bool Collectible::isValidNumber(const std::string& numStr) const
+bool Collectible::parseNumber(std::string_view numStr, int& number) const
 {
-   //numStr must contain only digits
-   bool invalidNum = false;
-   for ( int i = 0; i < numStr.length(); i++ )
-   {
-      if ( !isdigit(numStr[i]) )
-         invalidNum = true;
-   }
+   const char* first = numStr.data();
+   const char* last = numStr.data() + numStr.size();
+   //from_chars rejects a leading sign, so only digits are accepted
+   std::from_chars_result result = std::from_chars(first, last, number);
    //numStr must be greater than 0
-   if ( invalidNum || stoi(numStr) < 1 )
-   {
-      return false;
-   }
-   return true;
+   return numStr.size() > 0 && result.ec == std::errc() && result.ptr == last
+      && number >= 1;
 }
 
 /**
- Determines whether a string represents a valid year from 0 to the current year.
- @param yearStr The string representing the year.
- @return True if the string represents a valid year. False otherwise.
- @pre yearStr must be a string.
- @post True will be returned if the string represents a valid year. False otherwise.
+ Determines whether a field represents a valid year from 1 to the current year and converts it.
+ @param yearStr The field representing the year.
+ @param yearValue Set to the value of the year if it is valid.
+ @return True if the field represents a valid year. False otherwise.
+ @pre None.
+ @post True will be returned and yearValue will be set if the field represents a valid year. False
+ will be returned otherwise.
  */
-bool Collectible::isValidYear(const std::string& yearStr) const
+bool Collectible::parseYear(std::string_view yearStr, int& yearValue) const
 {
-   if ( isValidNumber(yearStr) && stoi(yearStr) <= currYear )
-      return true;
-   else
-      return false;
+   return parseNumber(yearStr, yearValue) && yearValue <= currYear;
 }
 
 /**
- Determines whether the data vector is the correct length and contains no empty strings.
- @param data The data vector.
- @param numElements The number of elements that must be in the vector.
- @return True if the data vector is the correct length and contains no empty strings.
- @pre data must be a vector of strings. numElements must be of type int.
- @post True will be returned if the data vector is the correct length and contains no empty strings.
+ Determines whether the data fields are the correct number and contain no empty fields.
+ @param data The data fields.
+ @param numElements The number of fields that must be in data.
+ @return True if data holds numElements fields and none of them is empty.
+ @pre numElements must be of type int.
+ @post True will be returned if data holds numElements fields and none of them is empty.
  False otherwise.
  */
-bool Collectible::validDataVector(const std::vector<std::string>& data,
+bool Collectible::validDataVector(const FieldSpan& data,
                      int numElements) const
 {
    if ( data.size() != numElements )
       return false;
    for ( int i = 0; i < numElements; i++ )
    {
-      if ( data[i] == "" )
+      if ( data[i].empty() )
          return false;
    }
    return true;
@@ -118,12 +114,14 @@ char Collectible::getSymbol() const
 }
 
 /**
- Inserts the Collectible subclass object into the output stream.
- @param outputStream The outputStream to insert the object.
- @pre outputStream must be an ostream object.
- @post The Collectible object is inserted into the output stream.
+ Returns the Collectible subclass object as a string.
+ @return The string representing the object.
+ @pre None.
+ @post The string containing the Collectible subclass object's data will be returned.
  */
-void Collectible::print(std::ostream& outputStream) const
+std::string Collectible::toString() const
 {
-   outputStream << toString();
+   OutputBuffer buffer;
+   format(buffer);
+   return buffer.str();
 }
@@ -15,7 +15,11 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include "Comparable.h"
+#include "FieldSpan.h"
+#include "BinaryReader.h"
+#include "BinaryWriter.h"
 
 class Collectible : public Comparable
 {
@@ -33,12 +37,46 @@ public:
    virtual ~Collectible();
    
    /**
-    Sets the data members of a Collectible object to elements in the 'data' vector.
+    Sets the data members of a Collectible object to the fields in 'data'.
     @param data The data to set the Collectible subclass object.
-    @pre The elements in the 'data' vector must contain appropriate data.
-    @post The data members of the Collectible object will be set to the values in the 'data' vector.
+    @pre The fields in 'data' must contain appropriate data.
+    @post The data members of the Collectible object will be set to the values of the fields in 'data'.
     */
-   virtual bool setData(const std::vector<std::string>& data) = 0;
+   virtual bool setData(const FieldSpan& data) = 0;
+   
+   /**
+    Returns the number of fields setData reads.
+    @pre None.
+    @post The number of data fields of the Collectible subclass will be returned.
+    */
+   virtual int getFieldCount() const = 0;
+   
+   /**
+    Writes the data fields of a Collectible object into an output buffer in the order setData reads them.
+    @param buffer The buffer to write to.
+    @pre None.
+    @post The fields will be appended to the buffer, separated by commas, so that splitting the text and
+    passing the fields to setData recreates the object.
+    */
+   virtual void formatData(OutputBuffer& buffer) const = 0;
+   
+   /**
+    Writes the data fields of a Collectible object in binary form for a store snapshot.
+    @param writer The writer to append the fields to.
+    @pre None.
+    @post The fields will be appended in the order readData reads them.
+    */
+   virtual void writeData(BinaryWriter& writer) const = 0;
+   
+   /**
+    Sets the data members of a Collectible object to the fields written by writeData.
+    @param reader The reader positioned at the fields.
+    @return True if every field could be read. False if the bytes ended first.
+    @pre The fields must have been written by writeData of the same subclass.
+    @post The data members will be set without parsing or validating text, and the reader will be
+    advanced past the fields.
+    */
+   virtual bool readData(BinaryReader& reader) = 0;
 
    
    /**
@@ -47,7 +85,7 @@ public:
     @pre None.
     @post The string containing the Collectible subclass object's data will be returned.
     */
-   virtual std::string toString() const = 0;
+   virtual std::string toString() const;
    
    /**
     Returns a pointer to a Collectible object.
@@ -57,34 +95,45 @@ public:
    virtual Collectible* create() const = 0;
    
    /**
-    Determines whether a string represents an integer no less than 1.
-    @param numStr The string representing the integer.
-    @return True if the string represents a valid integer no less than 1. False otherwise.
-    @pre numStr must be a string.
-    @post True will be returned if the string represents a valid integer no less than 1. False will be
-    returned otherwise.
+    Returns a pointer to a copy of the Collectible object.
+    @pre None
+    @post An object of the same subclass holding the same data will be created and a pointer to it will
+    be returned.
+    */
+   virtual Collectible* clone() const = 0;
+   
+   /**
+    Determines whether a field represents an integer no less than 1 and converts it.
+    @param numStr The field representing the integer.
+    @param number Set to the value of the integer if it is valid.
+    @return True if the field represents a valid integer no less than 1. False otherwise.
+    @pre None.
+    @post True will be returned and number will be set if numStr contains only digits and its value is
+    no less than 1 and fits in an int. False will be returned otherwise.
     */
-   virtual bool isValidNumber(const std::string& numStr) const;
+   virtual bool parseNumber(std::string_view numStr, int& number) const;
    
    /**
-    Determines whether a string represents a valid year from 0 to the current year.
-    @param yearStr The string representing the year.
-    @return True if the string represents a valid year. False otherwise.
-    @pre yearStr must be a string.
-    @post True will be returned if the string represents a valid year. False otherwise.
+    Determines whether a field represents a valid year from 1 to the current year and converts it.
+    @param yearStr The field representing the year.
+    @param yearValue Set to the value of the year if it is valid.
+    @return True if the field represents a valid year. False otherwise.
+    @pre None.
+    @post True will be returned and yearValue will be set if the field represents a valid year. False
+    will be returned otherwise.
     */
-   virtual bool isValidYear(const std::string& yearStr) const;
+   virtual bool parseYear(std::string_view yearStr, int& yearValue) const;
    
    /**
-    Determines whether the data vector is the correct length and contains no empty strings.
-    @param data The data vector.
-    @param numElements The number of elements that must be in the vector.
-    @return True if the data vector is the correct length and contains no empty strings.
-    @pre data must be a vector of strings. numElements must be of type int.
-    @post True will be returned if the data vector is the correct length and contains no empty strings.
+    Determines whether the data fields are the correct number and contain no empty fields.
+    @param data The data fields.
+    @param numElements The number of fields that must be in data.
+    @return True if data holds numElements fields and none of them is empty.
+    @pre numElements must be of type int.
+    @post True will be returned if data holds numElements fields and none of them is empty.
     False otherwise.
     */
-   virtual bool validDataVector(const std::vector<std::string>& data,
+   virtual bool validDataVector(const FieldSpan& data,
                         int numElements) const;
    
    /**
@@ -113,14 +162,6 @@ protected:
     */
    virtual void setSymbol(char itemSymbol);
    
-   /**
-    Inserts the Collectible subclass object into the output stream.
-    @param outputStream The outputStream to insert the object.
-    @pre outputStream must be an ostream object.
-    @post The Collectible object is inserted into the output stream.
-    */
-   virtual void print(std::ostream& outputStream) const;
-   
    char symbol; //symbol for Collectible
    int currYear = 2020; //current year
    int year; //year of Collectible
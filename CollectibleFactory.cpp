@@ -2,7 +2,10 @@
  file name: CollectibleFactory.cpp
  author: Hall, Ashley
  The CollectibleFactory class employs a factory method to create subclasses of
- the Collectible class.
+ the Collectible class. Each subclass recycles the memory of its objects
+ through ObjectPools of its own, one for each thread, so objects handed out by
+ the factory are taken from the calling thread's pool and deleting them
+ returns their memory to the pool they came from.
  */
 
 #include "CollectibleFactory.h"
@@ -10,6 +13,7 @@
 #include "SportsCard.h"
 #include "Comic.h"
 #include "Coin.h"
+#include "Trace.h"
 
 /**
  Constructs a CollectibleFactory object and initializes the collectFactory array with addresses of
@@ -52,6 +56,7 @@ CollectibleFactory::~CollectibleFactory()
  */
 Collectible* CollectibleFactory::createObject(char objectType) const
 {
+   TRACE_SPAN("createObject");
    //find appropriate index in factoryVector
    int index = hash(objectType);
    if ( index < 0 )
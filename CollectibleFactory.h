@@ -2,7 +2,10 @@
  file name: CollectibleFactory.h
  author: Hall, Ashley
  The CollectibleFactory class employs a factory method to create subclasses of
- the Collectible class.
+ the Collectible class. Each subclass recycles the memory of its objects
+ through ObjectPools of its own, one for each thread, so objects handed out by
+ the factory are taken from the calling thread's pool and deleting them
+ returns their memory to the pool they came from.
  */
 
 #ifndef COLLECTIBLEFACTORY_H
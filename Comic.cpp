@@ -21,26 +21,118 @@ Comic::Comic()
 Comic::~Comic() {}
 
 /**
- Sets the data members of a Comic object to elements in the 'data' vector.
- @pre The elements in the 'data' vector must contain appropriate data and the vector must contain at
- least four elements.
+ Sets the data members of a Comic object to the fields in 'data'.
+ @pre The fields in 'data' must contain appropriate data and there must be at least four fields.
  @post The data members 'year', 'grade',  'title' , and 'publisher' will be set to the values in
  data[0], data[1],  data[2], and data[3], respectively.
  */
-bool Comic::setData(const std::vector<std::string>& data)
+bool Comic::setData(const FieldSpan& data)
 {
-   if ( !isValidYear(data[YEAR]) || !validDataVector(data, 4))
+   int yearValue;
+   if ( !validDataVector(data, DATA_LENGTH) || !parseYear(data[YEAR], yearValue))
    {
       return false;
    }
    
-   year = stoi(data[YEAR]);
-   grade = data[GRADE];
-   title = data[TITLE];
-   publisher = data[PUBLISHER];
+   year = yearValue;
+   grade.assign(data[GRADE]);
+   title.assign(data[TITLE]);
+   publisher.assign(data[PUBLISHER]);
    return true;
 }
 
+/**
+ Returns the number of fields setData reads.
+ @pre None.
+ @post Four, the number of fields of a Comic object, will be returned.
+ */
+int Comic::getFieldCount() const
+{
+   return DATA_LENGTH;
+}
+
+/**
+ Writes the Comic object's data fields into an output buffer in the order setData reads them.
+ @param buffer The buffer to write to.
+ @pre None.
+ @post The year, grade, title, and publisher will be appended to the buffer, separated by commas, so
+ that splitting the text and passing the fields to setData recreates the object.
+ */
+void Comic::formatData(OutputBuffer& buffer) const
+{
+   buffer.appendInt(year).append(", ").append(grade).append(", ")
+      .append(title).append(", ").append(publisher);
+}
+
+/**
+ Writes the Comic object's data fields in binary form for a store snapshot.
+ @param writer The writer to append the fields to.
+ @pre None.
+ @post The year, grade, title, and publisher will be appended in the order readData reads them.
+ */
+void Comic::writeData(BinaryWriter& writer) const
+{
+   writer.putInt(year);
+   writer.putString(grade);
+   writer.putString(title);
+   writer.putString(publisher);
+}
+
+/**
+ Sets the data members of a Comic object to the fields written by writeData.
+ @param reader The reader positioned at the fields.
+ @return True if every field could be read. False if the bytes ended first.
+ @pre The fields must have been written by Comic::writeData.
+ @post The year, grade, title, and publisher will be set and the reader advanced past them.
+ */
+bool Comic::readData(BinaryReader& reader)
+{
+   std::int32_t yearValue;
+   std::string_view gradeField;
+   std::string_view titleField;
+   std::string_view publisherField;
+   if ( !reader.getInt(yearValue) || !reader.getString(gradeField)
+       || !reader.getString(titleField) || !reader.getString(publisherField) )
+      return false;
+   year = yearValue;
+   grade.assign(gradeField);
+   title.assign(titleField);
+   publisher.assign(publisherField);
+   return true;
+}
+
+/**
+ Allocates memory for a Comic object from the calling thread's Comic object pool.
+ @param size The size of the object being allocated.
+ @return A pointer to memory for the object.
+ @pre None.
+ @post Memory recycled from a previously deleted Comic will be returned when available. Objects of
+ classes derived from Comic are allocated by the global allocator.
+ */
+void* Comic::operator new(std::size_t size)
+{
+   if ( size != sizeof(Comic) )
+      return ::operator new(size);
+   return ObjectPool<Comic>::allocate();
+}
+
+/**
+ Returns the memory for a Comic object to the Comic object pool it was allocated from.
+ @param memory The memory of the destroyed object.
+ @param size The size of the destroyed object.
+ @pre memory must have been allocated by Comic::operator new.
+ @post The memory will be available to the next Comic allocation.
+ */
+void Comic::operator delete(void* memory, std::size_t size)
+{
+   if ( size != sizeof(Comic) )
+   {
+      ::operator delete(memory);
+      return;
+   }
+   ObjectPool<Comic>::deallocate(memory);
+}
+
 /**
  Returns a pointer to a Comic object.
  @pre None
@@ -51,6 +143,16 @@ Collectible* Comic::create() const
    return new Comic;
 }
 
+/**
+ Returns a pointer to a copy of the Comic object.
+ @pre None
+ @post A Comic object holding the same data will be created and a pointer to it will be returned.
+ */
+Collectible* Comic::clone() const
+{
+   return new Comic(*this);
+}
+
 /**
  Determines if two Comic objects are equal.
  @pre The operands must be of type Comic.
@@ -140,14 +242,13 @@ bool Comic::operator>( const Comparable& rhsComparable ) const
 
 
 /**
- Returns the Comic object's publisher, title, year and grade as a string.
- @return The string containing the Comic object's data.
- @pre None.
- @post The string containing the Comic object's data will be returned.
+ Writes the Comic object's publisher, title, year and grade into an output buffer.
+ @param buffer The buffer to write to.
+ @pre buffer must be an OutputBuffer object.
+ @post The Comic object's data will be appended to the buffer, separated by commas.
  */
-std::string Comic::toString() const
+void Comic::format(OutputBuffer& buffer) const
 {
-   return publisher + ", " + title + ", " + std::to_string(year)
-      + ", " + grade;
+   buffer.append(publisher).append(", ").append(title).append(", ")
+      .appendInt(year).append(", ").append(grade);
 }
-
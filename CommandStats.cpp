@@ -0,0 +1,220 @@
+/*
+ file name: CommandStats.cpp
+ author: Hall, Ashley
+ The CommandStats class collects the run-time statistics of a store's
+ commands: a LatencyHistogram of the execution times of each command type,
+ the number of commands of each type that succeeded and failed, the number of
+ errors of each kind, and counters of the items created, the transactions
+ added, and the inventory tree operations performed. A command type's
+ histogram is only allocated when the first command of the type is recorded,
+ so a store that runs few command types keeps its statistics small. The
+ statistics are written as text for the stats command or as JSON.
+ */
+
+#include "CommandStats.h"
+
+const char* const CommandStats::ERROR_NAMES[ERROR_KINDS] = {
+   "invalid_customer_id", "customer_not_found", "invalid_item_type",
+   "invalid_data", "item_not_found", "invalid_arguments"};
+
+/**
+ CommandStats constructor.
+ @pre None.
+ @post Statistics with every count 0 will be created.
+ */
+CommandStats::CommandStats() : commands(COMMAND_TYPES, nullptr), errors(),
+   itemsCreated(0), transactions(0), treeOperations(0) {}
+
+/**
+ CommandStats destructor.
+ @pre None.
+ @post The histograms of the command types will be deallocated.
+ */
+CommandStats::~CommandStats()
+{
+   for ( std::size_t i = 0; i < commands.size(); i++ )
+      delete commands[i];
+}
+
+/**
+ Counts one executed command.
+ @param command The command's letter, from 'A' to 'Z'.
+ @param succeeded True if the command succeeded.
+ @param nanoseconds The time the command took.
+ @pre None.
+ @post The command's time will be recorded in the histogram of its type and its success or failure
+ counted. Other characters are ignored.
+ */
+void CommandStats::recordCommand(char command, bool succeeded,
+                                 std::uint64_t nanoseconds)
+{
+   if ( command < 'A' || command > 'Z' )
+      return;
+   CommandCounts& counts = countsOf(command - 'A');
+   counts.latencies.record(nanoseconds);
+   if ( succeeded )
+      counts.succeeded++;
+   else
+      counts.failed++;
+}
+
+/**
+ Counts one error.
+ @param kind The kind of error.
+ @pre kind must be less than ERROR_KINDS.
+ @post The count of the kind will be incremented.
+ */
+void CommandStats::countError(ErrorKind kind)
+{
+   errors[kind]++;
+}
+
+/**
+ Counts items created by commands.
+ @param count The number of Collectible objects allocated.
+ @pre None.
+ @post The count of items created will be increased by count.
+ */
+void CommandStats::countItemsCreated(std::uint64_t count)
+{
+   itemsCreated += count;
+}
+
+/**
+ Counts transactions added to customers' histories.
+ @param count The number of transactions.
+ @pre None.
+ @post The count of transactions will be increased by count.
+ */
+void CommandStats::countTransactions(std::uint64_t count)
+{
+   transactions += count;
+}
+
+/**
+ Counts inventory tree operations.
+ @param count The number of item lookups, inserts, count changes, and removals.
+ @pre None.
+ @post The count of tree operations will be increased by count.
+ */
+void CommandStats::countTreeOperations(std::uint64_t count)
+{
+   treeOperations += count;
+}
+
+/**
+ Adds the statistics of another store.
+ @param other The statistics to add.
+ @pre None.
+ @post The statistics will hold the commands and counts of both.
+ */
+void CommandStats::merge(const CommandStats& other)
+{
+   for ( int i = 0; i < COMMAND_TYPES; i++ )
+   {
+      if ( other.commands[i] == nullptr )
+         continue;
+      CommandCounts& counts = countsOf(i);
+      counts.latencies.merge(other.commands[i]->latencies);
+      counts.succeeded += other.commands[i]->succeeded;
+      counts.failed += other.commands[i]->failed;
+   }
+   for ( int i = 0; i < ERROR_KINDS; i++ )
+      errors[i] += other.errors[i];
+   itemsCreated += other.itemsCreated;
+   transactions += other.transactions;
+   treeOperations += other.treeOperations;
+}
+
+/**
+ Writes the statistics as text.
+ @param buffer The buffer to write to.
+ @pre None.
+ @post A line for each command type recorded, with its counts and latencies in microseconds,
+ followed by a line of error counts and a line of the other counters, will be appended.
+ */
+void CommandStats::format(OutputBuffer& buffer) const
+{
+   for ( int i = 0; i < COMMAND_TYPES; i++ )
+   {
+      if ( commands[i] == nullptr )
+         continue;
+      buffer.append(static_cast<char>('A' + i)).append(": succeeded ")
+         .appendUnsigned(commands[i]->succeeded).append(" failed ")
+         .appendUnsigned(commands[i]->failed).append(' ');
+      commands[i]->latencies.format(buffer);
+   }
+
+   buffer.append("errors:");
+   for ( int i = 0; i < ERROR_KINDS; i++ )
+   {
+      buffer.append(' ').append(ERROR_NAMES[i]).append(' ')
+         .appendUnsigned(errors[i]);
+   }
+   buffer.append("\nitems created ").appendUnsigned(itemsCreated)
+      .append(" transactions ").appendUnsigned(transactions)
+      .append(" tree operations ").appendUnsigned(treeOperations)
+      .append('\n');
+}
+
+/**
+ Writes the statistics as a JSON object.
+ @param buffer The buffer to write to.
+ @pre None.
+ @post An object with "commands", "errors", and "counters" members will be appended. The
+ latencies are in nanoseconds.
+ */
+void CommandStats::formatJson(OutputBuffer& buffer) const
+{
+   const double PERCENTILES[] = {50, 90, 99, 99.9};
+   const char* PERCENTILE_NAMES[] = {"p50", "p90", "p99", "p99_9"};
+   const int PERCENTILE_COUNT = 4;
+
+   buffer.append("{\"commands\": {");
+   bool first = true;
+   for ( int i = 0; i < COMMAND_TYPES; i++ )
+   {
+      if ( commands[i] == nullptr )
+         continue;
+      const LatencyHistogram& latencies = commands[i]->latencies;
+      buffer.append(first ? "\n  \"" : ",\n  \"")
+         .append(static_cast<char>('A' + i)).append("\": {\"succeeded\": ")
+         .appendUnsigned(commands[i]->succeeded).append(", \"failed\": ")
+         .appendUnsigned(commands[i]->failed)
+         .append(", \"latency_ns\": {\"count\": ")
+         .appendUnsigned(latencies.getCount()).append(", \"mean\": ")
+         .appendUnsigned(static_cast<std::uint64_t>(latencies.getMean()));
+      for ( int p = 0; p < PERCENTILE_COUNT; p++ )
+      {
+         buffer.append(", \"").append(PERCENTILE_NAMES[p]).append("\": ")
+            .appendUnsigned(latencies.getPercentile(PERCENTILES[p]));
+      }
+      buffer.append(", \"max\": ").appendUnsigned(latencies.getMax())
+         .append("}}");
+      first = false;
+   }
+
+   buffer.append(first ? "},\n \"errors\": {" : "\n },\n \"errors\": {");
+   for ( int i = 0; i < ERROR_KINDS; i++ )
+   {
+      buffer.append(i == 0 ? "\"" : ", \"").append(ERROR_NAMES[i])
+         .append("\": ").appendUnsigned(errors[i]);
+   }
+   buffer.append("},\n \"counters\": {\"items_created\": ")
+      .appendUnsigned(itemsCreated).append(", \"transactions\": ")
+      .appendUnsigned(transactions).append(", \"tree_operations\": ")
+      .appendUnsigned(treeOperations).append("}}\n");
+}
+
+/**
+ Returns the statistics of a command type, allocating them if needed.
+ @param index The command's letter minus 'A'.
+ @pre index must be less than COMMAND_TYPES.
+ @post The command type's statistics will be returned.
+ */
+CommandStats::CommandCounts& CommandStats::countsOf(int index)
+{
+   if ( commands[index] == nullptr )
+      commands[index] = new CommandCounts;
+   return *commands[index];
+}
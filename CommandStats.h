@@ -0,0 +1,157 @@
+/*
+ file name: CommandStats.h
+ author: Hall, Ashley
+ The CommandStats class collects the run-time statistics of a store's
+ commands: a LatencyHistogram of the execution times of each command type,
+ the number of commands of each type that succeeded and failed, the number of
+ errors of each kind, and counters of the items created, the transactions
+ added, and the inventory tree operations performed. A command type's
+ histogram is only allocated when the first command of the type is recorded,
+ so a store that runs few command types keeps its statistics small. The
+ statistics are written as text for the stats command or as JSON.
+ */
+
+#ifndef COMMANDSTATS_H
+#define COMMANDSTATS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "LatencyHistogram.h"
+#include "OutputBuffer.h"
+
+class CommandStats
+{
+public:
+
+   /*
+    The kinds of errors a command can report.
+    */
+   enum ErrorKind
+   {
+      INVALID_CUSTOMER_ID, //the customer ID is not a valid number
+      CUSTOMER_NOT_FOUND, //no customer has the ID
+      INVALID_ITEM_TYPE, //the item type is unknown
+      INVALID_DATA, //the item's data fields are invalid
+      ITEM_NOT_FOUND, //an item to sell is not in the inventory
+      INVALID_ARGUMENTS, //any other argument is missing or invalid
+      ERROR_KINDS //the number of kinds
+   };
+
+   /**
+    CommandStats constructor.
+    @pre None.
+    @post Statistics with every count 0 will be created.
+    */
+   CommandStats();
+
+   /**
+    CommandStats destructor.
+    @pre None.
+    @post The histograms of the command types will be deallocated.
+    */
+   virtual ~CommandStats();
+
+   CommandStats(const CommandStats&) = delete;
+   CommandStats& operator=(const CommandStats&) = delete;
+
+   /**
+    Counts one executed command.
+    @param command The command's letter, from 'A' to 'Z'.
+    @param succeeded True if the command succeeded.
+    @param nanoseconds The time the command took.
+    @pre None.
+    @post The command's time will be recorded in the histogram of its type and its success or failure
+    counted. Other characters are ignored.
+    */
+   void recordCommand(char command, bool succeeded, std::uint64_t nanoseconds);
+
+   /**
+    Counts one error.
+    @param kind The kind of error.
+    @pre kind must be less than ERROR_KINDS.
+    @post The count of the kind will be incremented.
+    */
+   void countError(ErrorKind kind);
+
+   /**
+    Counts items created by commands.
+    @param count The number of Collectible objects allocated.
+    @pre None.
+    @post The count of items created will be increased by count.
+    */
+   void countItemsCreated(std::uint64_t count);
+
+   /**
+    Counts transactions added to customers' histories.
+    @param count The number of transactions.
+    @pre None.
+    @post The count of transactions will be increased by count.
+    */
+   void countTransactions(std::uint64_t count);
+
+   /**
+    Counts inventory tree operations.
+    @param count The number of item lookups, inserts, count changes, and removals.
+    @pre None.
+    @post The count of tree operations will be increased by count.
+    */
+   void countTreeOperations(std::uint64_t count);
+
+   /**
+    Adds the statistics of another store.
+    @param other The statistics to add.
+    @pre None.
+    @post The statistics will hold the commands and counts of both.
+    */
+   void merge(const CommandStats& other);
+
+   /**
+    Writes the statistics as text.
+    @param buffer The buffer to write to.
+    @pre None.
+    @post A line for each command type recorded, with its counts and latencies in microseconds,
+    followed by a line of error counts and a line of the other counters, will be appended.
+    */
+   void format(OutputBuffer& buffer) const;
+
+   /**
+    Writes the statistics as a JSON object.
+    @param buffer The buffer to write to.
+    @pre None.
+    @post An object with "commands", "errors", and "counters" members will be appended. The
+    latencies are in nanoseconds.
+    */
+   void formatJson(OutputBuffer& buffer) const;
+
+private:
+
+   /*
+    The statistics of one command type.
+    */
+   struct CommandCounts
+   {
+      LatencyHistogram latencies; //execution time of each command in nanoseconds
+      std::uint64_t succeeded = 0; //commands that succeeded
+      std::uint64_t failed = 0; //commands that reported an error
+   };
+
+   /**
+    Returns the statistics of a command type, allocating them if needed.
+    @param index The command's letter minus 'A'.
+    @pre index must be less than COMMAND_TYPES.
+    @post The command type's statistics will be returned.
+    */
+   CommandCounts& countsOf(int index);
+
+   static const int COMMAND_TYPES = 26; //the letters 'A' to 'Z'
+   static const char* const ERROR_NAMES[ERROR_KINDS]; //names used in output
+
+   std::vector<CommandCounts*> commands; //each command type's statistics or nullptr
+   std::uint64_t errors[ERROR_KINDS]; //count of each kind of error
+   std::uint64_t itemsCreated; //Collectible objects allocated by commands
+   std::uint64_t transactions; //transactions added to customers
+   std::uint64_t treeOperations; //inventory tree operations by commands
+};
+
+#endif
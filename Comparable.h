@@ -10,6 +10,8 @@
 #ifndef COMPARABLE_H
 #define COMPARABLE_H
 
+#include "OutputBuffer.h"
+
 class Comparable
 {
 public:
@@ -58,6 +60,14 @@ public:
     */
    virtual bool operator>( const Comparable& right ) const = 0;
    
+   /**
+    Writes the Comparable object's data into an output buffer.
+    @param buffer The buffer to write to.
+    @pre buffer must be an OutputBuffer object.
+    @post The Comparable object's data will be appended to the buffer.
+    */
+   virtual void format(OutputBuffer& buffer) const = 0;
+   
    /**
     Overloads the stream insertion operator to display Comparable objects.
     @pre outputStream must be an ostream object and outputComparable must be a Comparable.
@@ -72,11 +82,18 @@ public:
    
 protected:
    /**
-    Inserts the Comparable object into the output stream.
+    Inserts the Comparable object into the output stream. The object is formatted into a reusable
+    buffer which is written to the stream with a single write.
     @pre outputStream must be an ostream object.
     @post The Comparable object is inserted into the output stream.
     */
-   virtual void print(std::ostream& outputStream) const = 0;
+   virtual void print(std::ostream& outputStream) const
+   {
+      static thread_local OutputBuffer buffer;
+      buffer.clear();
+      format(buffer);
+      buffer.writeTo(outputStream);
+   }
 };
 
 #endif
@@ -1,28 +1,33 @@
 /*
  file name: Customer.cpp
  author: Hall, Ashley
- The Customer class holds each customer’s 3 digit ID, their name, and their
+ The Customer class holds each customer’s numeric ID, their name, and their
  transaction history. Customer objects are sorted alphabetically by name.
- The transaction history is represented by a vector of pointers to Transaction
- structs which hold Collectible pointers and action chars.
- The Customer class will assume ownership for the memory of pointed-to
- Transaction structs in the transactions vector and the Collectible pointers
- they contain.
+ The transactions themselves are records in the store's TransactionLog, which
+ every Customer of a store shares. The transaction history is represented by
+ a vector holding the positions of the customer's records in the log, in
+ chronological order, so no memory is allocated per transaction beyond the
+ vector and the log's columns.
  */
 #include "Customer.h"
 
 /**
  Customer constructor. Sets the customer's ID and name.
- @pre custID and custName must be of type string.
+ @param custID The customer's ID as written in the customer file.
+ @param custKey The numeric value of the customer's ID.
+ @param custName The customer's name.
+ @param log The store's transaction log.
+ @pre custID and custName must be of type string. log must outlive the Customer.
  @post The customer's ID and name will be set to custID and custName, respectively.
  */
-Customer::Customer( const std::string& custID, const std::string& custName )
-: idNumber(custID), name(custName)
+Customer::Customer( const std::string& custID, unsigned long long custKey,
+                   const std::string& custName, TransactionLog* log )
+: idNumber(custID), name(custName), key(custKey), transactionLog(log)
 {
 }
 
 /**
- Customer destructor. Deallocates memory for items in the transactions vector and transaction structs.
+ Customer destructor.
  */
 Customer::~Customer()
 {
@@ -30,29 +35,45 @@ Customer::~Customer()
 }
 
 /**
- Deallocates memory for items in the transactions vector and transaction structs.
+ Removes every transaction from the customer's history.
  @pre None
- @post Memory allocated in the transactions vector will be deallocated.
+ @post The size of the transactions vector will be set to 0 and the customer's totals will be reset.
+ The records remain in the log.
  */
 void Customer::clearTransactions()
 {
-   for ( int i = 0; i < transactions.size(); i++ )
-   {
-      if ( transactions[i] != nullptr )
-      {
-         //delete collectible
-         if ( transactions[i]->item != nullptr )
-         {
-            delete transactions[i]->item;
-            transactions[i]->item = nullptr;
-         }
-         
-         //delete transaction struct
-         delete transactions[i];
-         transactions[i] = nullptr;
-     }
-   }
    transactions.resize(0);
+   typeTotals.resize(0);
+}
+
+/**
+ Returns the numeric value of the customer's ID.
+ @pre None
+ @post The customer's numeric ID will be returned.
+ */
+unsigned long long Customer::getKey() const
+{
+   return key;
+}
+
+/**
+ Returns the customer's name.
+ @pre None
+ @post The customer's name will be returned.
+ */
+const std::string& Customer::getName() const
+{
+   return name;
+}
+
+/**
+ Returns the customer's ID as written in the customer file.
+ @pre None
+ @post The customer's ID will be returned.
+ */
+const std::string& Customer::getIdNumber() const
+{
+   return idNumber;
 }
 
 
@@ -110,13 +131,16 @@ bool Customer::operator>( const Comparable& rhsComparable ) const
 
 /**
  Appends a transaction to the customer's transaction history.
- @pre 'action' must be the char 'B' or 'S'. 'item' must be a Collectible pointer.
- @post The transaction will be added to the customer's transaction list and true will be returned.
- The newly added transaction will be the last element of the transactions vector.
- If item is nullptr or action is not one of the valid chars an error message will be output and false will
- be returned.
+ @param action The char 'B' or 'S'.
+ @param itemId The catalog ID of the item bought or sold.
+ @pre 'action' must be the char 'B' or 'S'. 'itemId' must be an ID in the log's catalog.
+ @post The transaction will be appended to the transaction log and true will be returned.
+ The position of the newly added record will be the last element of the transactions vector and the
+ customer's totals for the item's symbol will be updated.
+ If itemId is not in the catalog or action is not one of the valid chars an error message will be output
+ and false will be returned.
  */
-bool Customer::addTransaction(char actionType, Collectible* collectItem)
+bool Customer::addTransaction(char actionType, int itemId)
 {
    if ( actionType != 'B' && actionType != 'S' )
    {
@@ -124,69 +148,209 @@ bool Customer::addTransaction(char actionType, Collectible* collectItem)
       return false;
    }
    
-   if ( collectItem == nullptr )
+   const Collectible* item = transactionLog == nullptr ? nullptr
+      : transactionLog->getCatalog()->getItem(itemId);
+   if ( item == nullptr )
    {
-      std::cerr << "addTransaction invalid arg: nullptr passed in" << std::endl;
+      std::cerr << "addTransaction invalid arg: item ID " << itemId
+      << " not in catalog" << std::endl;
       return false;
    }
    
-   //create transaction object with given values
-   Transaction* transaction = new Transaction;
-   transaction->action = actionType;
-   transaction->item = collectItem;
+   //find the totals for the item's symbol, keeping them ordered by symbol
+   char symbol = item->getSymbol();
+   std::vector<TypeTotals>::iterator totals = typeTotals.begin();
+   while ( totals != typeTotals.end() && totals->symbol < symbol )
+      totals++;
+   if ( totals == typeTotals.end() || totals->symbol != symbol )
+      totals = typeTotals.insert(totals, TypeTotals{symbol, 0, 0});
+   if ( actionType == 'B' )
+      totals->numBought++;
+   else
+      totals->numSold++;
    
-   //add to end of transactions list
-   transactions.push_back(transaction);
+   //append the record to the log and add its position to the end of the
+   //transactions list
+   transactions.push_back(transactionLog->append(key, actionType, itemId));
    
    return true;
 }
 
 /**
- Inserts the Customer object and their transactions into the output stream.
- @pre outputStream must be an ostream object.
- @post The Customer object and their transactions are inserted into the output stream.
+ Appends a group of transactions of the same action to the customer's transaction history.
+ @param action The char 'B' or 'S'.
+ @param itemIds The catalog IDs of the items bought or sold, in the order to record them.
+ @param count The number of IDs.
+ @return True if the transactions were appended. False otherwise.
+ @pre 'action' must be the char 'B' or 'S'. Every ID must be an ID in the log's catalog.
+ @post Every ID will be checked before any transaction is appended, so either all of the
+ transactions or none of them will be added, as addTransaction adds one.
  */
-void Customer::print(std::ostream& outputStream) const
+bool Customer::addTransactions(char actionType, const int* itemIds,
+                               std::size_t count)
+{
+   if ( actionType != 'B' && actionType != 'S' )
+   {
+      std::cerr << "addTransactions invalid arg: " << actionType << std::endl;
+      return false;
+   }
+   
+   const ItemCatalog* catalog = transactionLog == nullptr ? nullptr
+      : transactionLog->getCatalog();
+   for ( std::size_t i = 0; i < count; i++ )
+   {
+      if ( catalog == nullptr || catalog->getItem(itemIds[i]) == nullptr )
+      {
+         std::cerr << "addTransactions invalid arg: item ID " << itemIds[i]
+         << " not in catalog" << std::endl;
+         return false;
+      }
+   }
+   
+   for ( std::size_t i = 0; i < count; i++ )
+      addTransaction(actionType, itemIds[i]);
+   
+   return true;
+}
+
+/**
+ Writes the Customer object and their transactions into an output buffer.
+ @param buffer The buffer to write to.
+ @pre buffer must be an OutputBuffer object.
+ @post The Customer object and their transactions are appended to the buffer.
+ */
+void Customer::format(OutputBuffer& buffer) const
 {
    //print id and name
-   outputStream << toString() << std::endl;
+   formatHeader(buffer);
+   buffer.append('\n');
    //print transaction list in chronological order
-   insertTransactions(outputStream);
-   outputStream << std::endl;
+   insertTransactions(buffer);
+   buffer.append('\n');
 }
 
 /**
- Inserts the Customer's transactions into the output stream.
- @param outputStream The outputStream
- @pre outputStream must be of type std::ostream
- @post The transactions will be inserted into the output stream. If no transactions were made
- the string "none" will be inserted into the output stream.
+ Writes the Customer's ID and name into an output buffer.
+ @param buffer The buffer to write to.
+ @pre buffer must be an OutputBuffer object.
+ @post The line "Customer: ID, name" without a line break will be appended to the buffer.
  */
-void Customer::insertTransactions( std::ostream& outputStream) const
+void Customer::formatHeader(OutputBuffer& buffer) const
 {
-   outputStream << "Transactions:" << std::endl;
-   if ( transactions.size() == 0 )
+   buffer.append("Customer: ").append(idNumber).append(", ").append(name);
+}
+
+/**
+ Writes the Customer object and a window of their transactions into an output buffer.
+ @param buffer The buffer to write to.
+ @param offset The number of transactions to skip from the start of the history.
+ @param limit The greatest number of transactions to write.
+ @pre buffer must be an OutputBuffer object.
+ @post The Customer's ID and name, a line giving the range of transactions shown, and at most limit
+ transactions starting at position offset in chronological order will be appended to the buffer,
+ followed by a blank line. If the window holds no transactions "none" will be written in their place.
+ Only the transactions in the window are visited.
+ */
+void Customer::formatPage(OutputBuffer& buffer, std::size_t offset,
+                          std::size_t limit) const
+{
+   formatHeader(buffer);
+   buffer.append('\n');
+   
+   //clamp the window to the transaction history
+   std::size_t first = offset < transactions.size() ? offset
+      : transactions.size();
+   std::size_t last = limit < transactions.size() - first ? first + limit
+      : transactions.size();
+   
+   if ( first == last )
    {
-      outputStream << "none" << std::endl;
+      buffer.append("Transactions 0 of ").appendUnsigned(transactions.size())
+         .append(":\nnone\n\n");
       return;
    }
    
-   for ( int i = 0; i < transactions.size(); i++ )
+   buffer.append("Transactions ").appendUnsigned(first + 1).append('-')
+      .appendUnsigned(last).append(" of ").appendUnsigned(transactions.size())
+      .append(":\n");
+   for ( std::size_t i = first; i < last; i++ )
+      transactionLog->formatRecord(transactions[i], buffer);
+   buffer.append('\n');
+}
+
+/**
+ Returns the number of transactions in the customer's history.
+ @pre None
+ @post The number of transactions made by the customer will be returned.
+ */
+std::size_t Customer::getTransactionCount() const
+{
+   return transactions.size();
+}
+
+/**
+ Writes the Customer object and the totals of their transactions into an output buffer.
+ @param buffer The buffer to write to.
+ @pre buffer must be an OutputBuffer object.
+ @post The Customer's ID and name, their number of transactions with the sequence numbers of the
+ first and last, and the number of items bought and sold for each item symbol will be appended to the
+ buffer, followed by a blank line. The cost does not depend on the length of the history.
+ */
+void Customer::formatSummary(OutputBuffer& buffer) const
+{
+   formatHeader(buffer);
+   buffer.append("\nSummary:\nTransactions: ")
+      .appendUnsigned(transactions.size());
+   
+   //the first and last sequence numbers are read from the ends of the index
+   if ( transactions.size() > 0 )
+   {
+      buffer.append(" (first #")
+         .appendUnsigned(transactionLog->getSequence(transactions.front()))
+         .append(", last #")
+         .appendUnsigned(transactionLog->getSequence(transactions.back()))
+         .append(')');
+   }
+   buffer.append('\n');
+   
+   for ( std::size_t i = 0; i < typeTotals.size(); i++ )
+   {
+      buffer.append(typeTotals[i].symbol).append(": ")
+         .appendUnsigned(typeTotals[i].numBought).append(" bought, ")
+         .appendUnsigned(typeTotals[i].numSold).append(" sold\n");
+   }
+   buffer.append('\n');
+}
+
+/**
+ Inserts the Customer's transactions into an output buffer.
+ @param buffer The buffer to write to.
+ @pre buffer must be an OutputBuffer object.
+ @post The transactions will be appended to the buffer. If no transactions were made
+ the string "none" will be appended to the buffer.
+ */
+void Customer::insertTransactions( OutputBuffer& buffer) const
+{
+   buffer.append("Transactions:\n");
+   if ( transactions.size() == 0 )
    {
-      outputStream << transactions[i]->action << ": ";
-      outputStream << *transactions[i]->item << std::endl;
+      buffer.append("none\n");
+      return;
    }
+   
+   for ( int i = 0; i < transactions.size(); i++ )
+      transactionLog->formatRecord(transactions[i], buffer);
 }
 
 /**
- Returns the Customer's ID, name, and each transaction made in chronological order with 1 transaction
- per line.
- @return The string containing the Comic object's data.
+ Returns the Customer's ID and name as a string.
+ @return The string containing the Customer's ID and name.
  @pre None.
- @post The string containing the Comic object's data will be returned.
+ @post The string "Customer: ID, name" will be returned.
  */
 std::string Customer::toString() const
 {
-   return "Customer: " + idNumber
-   + ", " + name;
+   OutputBuffer buffer;
+   formatHeader(buffer);
+   return buffer.str();
 }
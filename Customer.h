@@ -1,13 +1,13 @@
 /*
  file name: Customer.h
  author: Hall, Ashley
- The Customer class holds each customer’s 3 digit ID, their name, and their
+ The Customer class holds each customer’s numeric ID, their name, and their
  transaction history. Customer objects are sorted alphabetically by name.
- The transaction history is represented by a vector of pointers to Transaction
- structs which hold Collectible pointers and action chars.
- The Customer class will assume ownership for the memory of pointed-to
- Transaction structs in the transactions vector and the Collectible pointers
- they contain.
+ The transactions themselves are records in the store's TransactionLog, which
+ every Customer of a store shares. The transaction history is represented by
+ a vector holding the positions of the customer's records in the log, in
+ chronological order, so no memory is allocated per transaction beyond the
+ vector and the log's columns.
 */
 
 #ifndef CUSTOMER_H
@@ -15,6 +15,7 @@
 
 #include "Comparable.h"
 #include "Collectible.h"
+#include "TransactionLog.h"
 
 class Customer : public Comparable
 
@@ -23,24 +24,50 @@ public:
 
    /**
     Customer constructor. Sets the customer's ID and name.
-    @pre custID and custName must be of type string.
+    @param custID The customer's ID as written in the customer file.
+    @param custKey The numeric value of the customer's ID.
+    @param custName The customer's name.
+    @param log The store's transaction log.
+    @pre custID and custName must be of type string. log must outlive the Customer.
     @post The customer's ID and name will be set to custID and custName, respectively.
     */
-   Customer( const std::string& custID, const std::string& custName);
+   Customer( const std::string& custID, unsigned long long custKey,
+            const std::string& custName, TransactionLog* log);
 
    /**
-    Customer destructor. Deallocates memory for items in the transactions vector and transaction structs.
+    Customer destructor.
     */
    virtual ~Customer();
 
    /**
-    Deallocates memory for items in the transactions vector and transaction structs.
+    Removes every transaction from the customer's history.
     @pre None
-    @post Memory allocated in the transactions vector will be deallocated. The size of the
-    transactions struct will be set to 0.
+    @post The size of the transactions vector will be set to 0 and the customer's totals will be reset.
+    The records remain in the log.
     */
    virtual void clearTransactions();
    
+   /**
+    Returns the numeric value of the customer's ID.
+    @pre None
+    @post The customer's numeric ID will be returned.
+    */
+   unsigned long long getKey() const;
+   
+   /**
+    Returns the customer's name.
+    @pre None
+    @post The customer's name will be returned.
+    */
+   const std::string& getName() const;
+   
+   /**
+    Returns the customer's ID as written in the customer file.
+    @pre None
+    @post The customer's ID will be returned.
+    */
+   const std::string& getIdNumber() const;
+   
    /**
     Determines if two Customer objects are equal.
     @pre The operands must be of type Customer.
@@ -78,52 +105,116 @@ public:
 
    /**
     Appends a transaction to the customer's transaction history.
-    @pre 'action' must be the char 'B' or 'S'. 'item' must be a Collectible pointer.
-    @post The transaction will be added to the customer's transaction list and true will be returned.
-    The newly added transaction will be the last element of the transactions vector.
-    If item is nullptr or action is not one of the valid chars an error message will be output and false will
-    be returned.
+    @param action The char 'B' or 'S'.
+    @param itemId The catalog ID of the item bought or sold.
+    @pre 'action' must be the char 'B' or 'S'. 'itemId' must be an ID in the log's catalog.
+    @post The transaction will be appended to the transaction log and true will be returned.
+    The position of the newly added record will be the last element of the transactions vector and the
+    customer's totals for the item's symbol will be updated.
+    If itemId is not in the catalog or action is not one of the valid chars an error message will be output
+    and false will be returned.
     */
-   virtual bool addTransaction(char action, Collectible* item);
+   virtual bool addTransaction(char action, int itemId);
    
-
-protected:
-
-   struct Transaction
-   {
-      char action; //'B' or 'S'
-  
-      Collectible* item = nullptr;
-   };
+   /**
+    Appends a group of transactions of the same action to the customer's transaction history.
+    @param action The char 'B' or 'S'.
+    @param itemIds The catalog IDs of the items bought or sold, in the order to record them.
+    @param count The number of IDs.
+    @return True if the transactions were appended. False otherwise.
+    @pre 'action' must be the char 'B' or 'S'. Every ID must be an ID in the log's catalog.
+    @post Every ID will be checked before any transaction is appended, so either all of the
+    transactions or none of them will be added, as addTransaction adds one.
+    */
+   virtual bool addTransactions(char action, const int* itemIds,
+                                std::size_t count);
    
    /**
-    Inserts the Customer object and their transactions into the output stream.
-    @pre outputStream must be an ostream object.
-    @post The Customer object and their transactions are inserted into the output stream.
+    Writes the Customer object and their transactions into an output buffer.
+    @param buffer The buffer to write to.
+    @pre buffer must be an OutputBuffer object.
+    @post The Customer object and their transactions are appended to the buffer.
     */
-   virtual void print(std::ostream& outputStream) const;
+   virtual void format(OutputBuffer& buffer) const;
    
    /**
-    Inserts the Customer's transactions into the output stream.
-    @param outputStream The outputStream
-    @pre outputStream must be of type std::ostream
-    @post The transactions will be inserted into the output stream. If no transactions were made
-    the string "none" will be inserted into the output stream.
+    Writes the Customer's ID and name into an output buffer.
+    @param buffer The buffer to write to.
+    @pre buffer must be an OutputBuffer object.
+    @post The line "Customer: ID, name" without a line break will be appended to the buffer.
     */
-   virtual void insertTransactions( std::ostream& outputStream) const;
+   virtual void formatHeader(OutputBuffer& buffer) const;
    
    /**
-    Returns the Customer's ID, name, and each transaction made in chronological order with 1 transaction
-    per line.
-    @return The string containing the Comic object's data.
+    Writes the Customer object and a window of their transactions into an output buffer.
+    @param buffer The buffer to write to.
+    @param offset The number of transactions to skip from the start of the history.
+    @param limit The greatest number of transactions to write.
+    @pre buffer must be an OutputBuffer object.
+    @post The Customer's ID and name, a line giving the range of transactions shown, and at most limit
+    transactions starting at position offset in chronological order will be appended to the buffer,
+    followed by a blank line. If the window holds no transactions "none" will be written in their place.
+    Only the transactions in the window are visited.
+    */
+   virtual void formatPage(OutputBuffer& buffer, std::size_t offset,
+                           std::size_t limit) const;
+   
+   /**
+    Returns the number of transactions in the customer's history.
+    @pre None
+    @post The number of transactions made by the customer will be returned.
+    */
+   std::size_t getTransactionCount() const;
+   
+   /**
+    Writes the Customer object and the totals of their transactions into an output buffer.
+    @param buffer The buffer to write to.
+    @pre buffer must be an OutputBuffer object.
+    @post The Customer's ID and name, their number of transactions with the sequence numbers of the
+    first and last, and the number of items bought and sold for each item symbol will be appended to the
+    buffer, followed by a blank line. The cost does not depend on the length of the history.
+    */
+   virtual void formatSummary(OutputBuffer& buffer) const;
+   
+
+protected:
+
+   /**
+    Inserts the Customer's transactions into an output buffer.
+    @param buffer The buffer to write to.
+    @pre buffer must be an OutputBuffer object.
+    @post The transactions will be appended to the buffer. If no transactions were made
+    the string "none" will be appended to the buffer.
+    */
+   virtual void insertTransactions( OutputBuffer& buffer) const;
+   
+   /**
+    Returns the Customer's ID and name as a string.
+    @return The string containing the Customer's ID and name.
     @pre None.
-    @post The string containing the Comic object's data will be returned.
+    @post The string "Customer: ID, name" will be returned.
     */
    virtual std::string toString() const;
 
-   std::string idNumber; //customer's 3 digit ID number
+   std::string idNumber; //customer's ID number as written in the customer file
    std::string name; //customer's name
-   std::vector<Transaction*> transactions; //customer's transaction history
+   /*
+    Running totals of the items bought and sold of one Collectible subclass.
+    */
+   struct TypeTotals
+   {
+      char symbol; //symbol of the Collectible subclass
+      std::uint32_t numBought;
+      std::uint32_t numSold;
+   };
+   
+   unsigned long long key; //numeric value of the customer's ID
+   //positions of the customer's records in the transaction log
+   std::vector<std::uint32_t> transactions;
+   TransactionLog* transactionLog; //log holding the customer's transactions
+   //totals for each item symbol traded, ordered by symbol and updated by
+   //addTransaction
+   std::vector<TypeTotals> typeTotals;
    
    
 };
@@ -0,0 +1,143 @@
+/*
+ file name: CustomerIndex.cpp
+ author: Hall, Ashley
+ The CustomerIndex class maps numeric customer IDs to Customer pointers. It
+ is an open-addressing hash table with linear probing: every entry is a slot
+ holding a 64-bit ID and a Customer pointer stored contiguously in a single
+ array, and empty slots hold nullptr. The table doubles when it is more than
+ three quarters full, so lookups stay O(1) and the memory used per customer
+ is bounded by a small multiple of the slot size. The CustomerIndex does not
+ own the Customer objects it points to.
+ */
+
+#include "CustomerIndex.h"
+
+/**
+ CustomerIndex constructor.
+ @pre None.
+ @post An empty CustomerIndex will be created.
+ */
+CustomerIndex::CustomerIndex() : entryCount(0) {}
+
+/**
+ Makes room for a number of customers so the table will not grow while they are inserted.
+ @param count The number of customers the index should hold without growing.
+ @pre None.
+ @post The table will have enough slots for count customers at its maximum load.
+ */
+void CustomerIndex::reserve(std::size_t count)
+{
+   //keep the load at or below three quarters
+   std::size_t slotCount = MIN_SLOTS;
+   while ( slotCount / 4 * 3 < count )
+      slotCount *= 2;
+   if ( slotCount > slots.size() )
+      rehash(slotCount);
+}
+
+/**
+ Associates a customer ID with a Customer.
+ @param id The customer's numeric ID.
+ @param customer The pointer to the Customer.
+ @return True if the ID was not in the index before. False if an existing entry was replaced.
+ @pre customer must not be nullptr.
+ @post find(id) will return customer.
+ */
+bool CustomerIndex::insert(unsigned long long id, Customer* customer)
+{
+   //grow before the table becomes more than three quarters full
+   if ( (entryCount + 1) > slots.size() / 4 * 3 )
+      rehash(slots.empty() ? MIN_SLOTS : slots.size() * 2);
+
+   std::size_t mask = slots.size() - 1;
+   std::size_t index = hash(id) & mask;
+   //probe until the ID or an empty slot is found
+   while ( slots[index].customer != nullptr )
+   {
+      if ( slots[index].id == id )
+      {
+         slots[index].customer = customer;
+         return false;
+      }
+      index = (index + 1) & mask;
+   }
+   slots[index].id = id;
+   slots[index].customer = customer;
+   entryCount++;
+   return true;
+}
+
+/**
+ Finds the Customer with the given ID.
+ @param id The customer's numeric ID.
+ @return The pointer to the Customer or nullptr if the ID is not in the index.
+ @pre None.
+ @post The Customer associated with id will be returned. The index will not change.
+ */
+Customer* CustomerIndex::find(unsigned long long id) const
+{
+   if ( slots.empty() )
+      return nullptr;
+
+   std::size_t mask = slots.size() - 1;
+   std::size_t index = hash(id) & mask;
+   //an empty slot ends the probe sequence
+   while ( slots[index].customer != nullptr )
+   {
+      if ( slots[index].id == id )
+         return slots[index].customer;
+      index = (index + 1) & mask;
+   }
+   return nullptr;
+}
+
+/**
+ Returns the number of customers in the index.
+ @pre None.
+ @post The number of IDs in the index will be returned.
+ */
+std::size_t CustomerIndex::size() const
+{
+   return entryCount;
+}
+
+/**
+ Mixes the bits of a customer ID so that consecutive IDs spread over the table.
+ @param id The customer's numeric ID.
+ @return The hashed value of the ID.
+ @pre None.
+ @post A hash of id will be returned.
+ */
+std::size_t CustomerIndex::hash(unsigned long long id)
+{
+   //finalizer from the splitmix64 generator
+   id ^= id >> 30;
+   id *= 0xbf58476d1ce4e5b9ULL;
+   id ^= id >> 27;
+   id *= 0x94d049bb133111ebULL;
+   id ^= id >> 31;
+   return static_cast<std::size_t>(id);
+}
+
+/**
+ Replaces the table with one of the given number of slots and reinserts every entry.
+ @param slotCount The number of slots in the new table.
+ @pre slotCount must be a power of 2 large enough to hold every entry.
+ @post Every entry will be in the new table.
+ */
+void CustomerIndex::rehash(std::size_t slotCount)
+{
+   std::vector<Slot> oldSlots(slotCount);
+   oldSlots.swap(slots);
+
+   std::size_t mask = slots.size() - 1;
+   for ( std::size_t i = 0; i < oldSlots.size(); i++ )
+   {
+      if ( oldSlots[i].customer == nullptr )
+         continue;
+      std::size_t index = hash(oldSlots[i].id) & mask;
+      while ( slots[index].customer != nullptr )
+         index = (index + 1) & mask;
+      slots[index] = oldSlots[i];
+   }
+}
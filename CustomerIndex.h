@@ -0,0 +1,113 @@
+/*
+ file name: CustomerIndex.h
+ author: Hall, Ashley
+ The CustomerIndex class maps numeric customer IDs to Customer pointers. It
+ is an open-addressing hash table with linear probing: every entry is a slot
+ holding a 64-bit ID and a Customer pointer stored contiguously in a single
+ array, and empty slots hold nullptr. The table doubles when it is more than
+ three quarters full, so lookups stay O(1) and the memory used per customer
+ is bounded by a small multiple of the slot size. The CustomerIndex does not
+ own the Customer objects it points to.
+ */
+
+#ifndef CUSTOMERINDEX_H
+#define CUSTOMERINDEX_H
+
+#include <cstddef>
+#include <vector>
+
+#include "Customer.h"
+
+class CustomerIndex
+{
+public:
+
+   /**
+    CustomerIndex constructor.
+    @pre None.
+    @post An empty CustomerIndex will be created.
+    */
+   CustomerIndex();
+
+   /**
+    Makes room for a number of customers so the table will not grow while they are inserted.
+    @param count The number of customers the index should hold without growing.
+    @pre None.
+    @post The table will have enough slots for count customers at its maximum load.
+    */
+   void reserve(std::size_t count);
+
+   /**
+    Associates a customer ID with a Customer.
+    @param id The customer's numeric ID.
+    @param customer The pointer to the Customer.
+    @return True if the ID was not in the index before. False if an existing entry was replaced.
+    @pre customer must not be nullptr.
+    @post find(id) will return customer.
+    */
+   bool insert(unsigned long long id, Customer* customer);
+
+   /**
+    Finds the Customer with the given ID.
+    @param id The customer's numeric ID.
+    @return The pointer to the Customer or nullptr if the ID is not in the index.
+    @pre None.
+    @post The Customer associated with id will be returned. The index will not change.
+    */
+   Customer* find(unsigned long long id) const;
+
+   /**
+    Returns the number of customers in the index.
+    @pre None.
+    @post The number of IDs in the index will be returned.
+    */
+   std::size_t size() const;
+
+   /**
+    Calls a function with every ID and Customer in the index.
+    @param visit The function, called as visit(id, customer).
+    @pre visit must not insert into the index.
+    @post visit will have been called once for each entry, in the order of the table's slots.
+    */
+   template<typename Visitor>
+   void visit(Visitor visit) const
+   {
+      for ( std::size_t i = 0; i < slots.size(); i++ )
+      {
+         if ( slots[i].customer != nullptr )
+            visit(slots[i].id, slots[i].customer);
+      }
+   }
+
+private:
+
+   struct Slot
+   {
+      unsigned long long id; //customer's numeric ID
+      Customer* customer = nullptr; //nullptr marks an empty slot
+   };
+
+   /**
+    Mixes the bits of a customer ID so that consecutive IDs spread over the table.
+    @param id The customer's numeric ID.
+    @return The hashed value of the ID.
+    @pre None.
+    @post A hash of id will be returned.
+    */
+   static std::size_t hash(unsigned long long id);
+
+   /**
+    Replaces the table with one of the given number of slots and reinserts every entry.
+    @param slotCount The number of slots in the new table.
+    @pre slotCount must be a power of 2 large enough to hold every entry.
+    @post Every entry will be in the new table.
+    */
+   void rehash(std::size_t slotCount);
+
+   std::vector<Slot> slots; //hash table, size is 0 or a power of 2
+   std::size_t entryCount; //number of occupied slots
+
+   static const std::size_t MIN_SLOTS = 16;
+};
+
+#endif
@@ -0,0 +1,135 @@
+/*
+ file name: FieldSpan.h
+ author: Hall, Ashley
+ The FieldSpan class is a read-only view of a contiguous run of fields taken
+ from one line of an input file. Each field is a std::string_view into the
+ line, so neither the fields nor the span own any characters, and a span of
+ the trailing fields can be taken without copying. A FieldSpan is only valid
+ while the line and the array of fields it refers to are unchanged.
+ */
+
+#ifndef FIELDSPAN_H
+#define FIELDSPAN_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+class FieldSpan
+{
+public:
+
+   /**
+    FieldSpan constructor.
+    @pre None.
+    @post An empty FieldSpan will be created.
+    */
+   FieldSpan() : fields(nullptr), count(0) {}
+
+   /**
+    FieldSpan constructor.
+    @param first Pointer to the first field.
+    @param fieldCount The number of fields.
+    @pre first must point to at least fieldCount fields.
+    @post A FieldSpan over the fieldCount fields starting at first will be created.
+    */
+   FieldSpan(const std::string_view* first, std::size_t fieldCount)
+   : fields(first), count(fieldCount) {}
+
+   /**
+    FieldSpan constructor.
+    @param allFields The fields to view.
+    @pre allFields must not be modified while the FieldSpan is in use.
+    @post A FieldSpan over every field in allFields will be created.
+    */
+   FieldSpan(const std::vector<std::string_view>& allFields)
+   : fields(allFields.data()), count(allFields.size()) {}
+
+   /**
+    Returns the number of fields in the span.
+    @pre None.
+    @post The number of fields will be returned.
+    */
+   std::size_t size() const
+   {
+      return count;
+   }
+
+   /**
+    Determines whether the span holds no fields.
+    @pre None.
+    @post True will be returned if the span is empty. False otherwise.
+    */
+   bool isEmpty() const
+   {
+      return count == 0;
+   }
+
+   /**
+    Returns a field of the span.
+    @param index The position of the field in the span.
+    @pre index must be less than size().
+    @post The field will be returned.
+    */
+   const std::string_view& operator[](std::size_t index) const
+   {
+      return fields[index];
+   }
+
+   /**
+    Returns a span of the fields from a given position to the end.
+    @param offset The position of the first field in the new span.
+    @pre None.
+    @post A FieldSpan over the fields after the first offset will be returned. It will be empty if offset
+    is not less than size().
+    */
+   FieldSpan subspan(std::size_t offset) const
+   {
+      if ( offset >= count )
+         return FieldSpan();
+      return FieldSpan(fields + offset, count - offset);
+   }
+
+   /**
+    Returns a span of a given number of fields from a given position.
+    @param offset The position of the first field in the new span.
+    @param length The largest number of fields in the new span.
+    @pre None.
+    @post A FieldSpan over up to length fields after the first offset will be returned. It will be
+    shorter if the span ends first.
+    */
+   FieldSpan subspan(std::size_t offset, std::size_t length) const
+   {
+      FieldSpan rest = subspan(offset);
+      if ( length < rest.count )
+         rest.count = length;
+      return rest;
+   }
+
+   /**
+    Returns a pointer to the first field, allowing the span to be used in a range-based for loop.
+    @pre None.
+    @post A pointer to the first field will be returned.
+    */
+   const std::string_view* begin() const
+   {
+      return fields;
+   }
+
+   /**
+    Returns a pointer past the last field, allowing the span to be used in a range-based for loop.
+    @pre None.
+    @post A pointer past the last field will be returned.
+    */
+   const std::string_view* end() const
+   {
+      return fields + count;
+   }
+
+private:
+
+   const std::string_view* fields; //first field of the span
+   std::size_t count; //number of fields in the span
+};
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ file name: ItemCatalog.cpp
+ author: Hall, Ashley
+ The ItemCatalog class holds one copy of every distinct Collectible item that
+ has appeared in a transaction and assigns each one a small integer ID.
+ Transaction records refer to items by their catalog ID instead of owning a
+ copy of the item, so an item traded many times is stored only once. Items are
+ ordered first by their symbol and then by their subclass's sorting order to
+ find existing entries. The ItemCatalog class assumes ownership of the memory
+ for the Collectible objects it holds. IDs are never reused.
+ */
+
+#include "ItemCatalog.h"
+
+/**
+ ItemCatalog constructor.
+ @pre None.
+ @post An empty ItemCatalog will be created.
+ */
+ItemCatalog::ItemCatalog() {}
+
+/**
+ ItemCatalog destructor. Deallocates memory for the items in the catalog.
+ @pre None.
+ @post Memory for every Collectible in the catalog will be deallocated.
+ */
+ItemCatalog::~ItemCatalog()
+{
+   itemIds.clear();
+   for ( std::size_t i = 0; i < items.size(); i++ )
+   {
+      delete items[i];
+      items[i] = nullptr;
+   }
+}
+
+/**
+ Returns the catalog ID of an item, adding a copy of the item to the catalog if it is not already in it.
+ @param item The item to look up.
+ @return The ID of the catalog entry equal to item.
+ @pre item must hold valid data.
+ @post If no equal item is in the catalog, a copy of item will be added under the next unused ID. The
+ ID of the entry equal to item will be returned. The caller keeps ownership of item.
+ */
+int ItemCatalog::intern(const Collectible& item)
+{
+   std::map<const Collectible*, int, ItemOrder>::const_iterator found =
+      itemIds.find(&item);
+   if ( found != itemIds.end() )
+      return found->second;
+
+   //new item, store a copy under the next ID
+   Collectible* itemCopy = item.clone();
+   int itemId = items.size();
+   items.push_back(itemCopy);
+   itemIds.emplace(itemCopy, itemId);
+   return itemId;
+}
+
+/**
+ Returns the item with the given catalog ID.
+ @param itemId The catalog ID.
+ @return A pointer to the catalog's item, or nullptr if itemId is not a valid ID.
+ @pre None.
+ @post The item will be returned. The catalog will not change.
+ */
+const Collectible* ItemCatalog::getItem(int itemId) const
+{
+   if ( itemId < 0 || static_cast<std::size_t>(itemId) >= items.size() )
+      return nullptr;
+   return items[itemId];
+}
+
+/**
+ Returns the number of distinct items in the catalog.
+ @pre None.
+ @post The number of items in the catalog will be returned.
+ */
+int ItemCatalog::size() const
+{
+   return items.size();
+}
+
+/**
+ Orders Collectible pointers by the symbol of the item and then by the item's own sorting order.
+ @param left The item on the left side of the comparison.
+ @param right The item on the right side of the comparison.
+ @return True if left is ordered before right. False otherwise.
+ @pre left and right must not be nullptr.
+ @post Returns true if left's symbol is less than right's, or if the symbols are equal and left is less
+ than right. Returns false otherwise.
+ */
+bool ItemCatalog::ItemOrder::operator()(const Collectible* left,
+                                        const Collectible* right) const
+{
+   //items of different subclasses can only be compared by their symbols
+   if ( left->getSymbol() != right->getSymbol() )
+      return left->getSymbol() < right->getSymbol();
+   return *left < *right;
+}
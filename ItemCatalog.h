@@ -0,0 +1,83 @@
+/*
+ file name: ItemCatalog.h
+ author: Hall, Ashley
+ The ItemCatalog class holds one copy of every distinct Collectible item that
+ has appeared in a transaction and assigns each one a small integer ID.
+ Transaction records refer to items by their catalog ID instead of owning a
+ copy of the item, so an item traded many times is stored only once. Items are
+ ordered first by their symbol and then by their subclass's sorting order to
+ find existing entries. The ItemCatalog class assumes ownership of the memory
+ for the Collectible objects it holds. IDs are never reused.
+ */
+
+#ifndef ITEMCATALOG_H
+#define ITEMCATALOG_H
+
+#include <map>
+#include <vector>
+
+#include "Collectible.h"
+
+class ItemCatalog
+{
+public:
+
+   /**
+    ItemCatalog constructor.
+    @pre None.
+    @post An empty ItemCatalog will be created.
+    */
+   ItemCatalog();
+
+   /**
+    ItemCatalog destructor. Deallocates memory for the items in the catalog.
+    @pre None.
+    @post Memory for every Collectible in the catalog will be deallocated.
+    */
+   virtual ~ItemCatalog();
+
+   ItemCatalog(const ItemCatalog&) = delete;
+   ItemCatalog& operator=(const ItemCatalog&) = delete;
+
+   /**
+    Returns the catalog ID of an item, adding a copy of the item to the catalog if it is not already in it.
+    @param item The item to look up.
+    @return The ID of the catalog entry equal to item.
+    @pre item must hold valid data.
+    @post If no equal item is in the catalog, a copy of item will be added under the next unused ID. The
+    ID of the entry equal to item will be returned. The caller keeps ownership of item.
+    */
+   int intern(const Collectible& item);
+
+   /**
+    Returns the item with the given catalog ID.
+    @param itemId The catalog ID.
+    @return A pointer to the catalog's item, or nullptr if itemId is not a valid ID.
+    @pre None.
+    @post The item will be returned. The catalog will not change.
+    */
+   const Collectible* getItem(int itemId) const;
+
+   /**
+    Returns the number of distinct items in the catalog.
+    @pre None.
+    @post The number of items in the catalog will be returned.
+    */
+   int size() const;
+
+private:
+
+   /*
+    Orders Collectible pointers by the symbol of the item and then by the
+    item's own sorting order.
+    */
+   struct ItemOrder
+   {
+      bool operator()(const Collectible* left, const Collectible* right) const;
+   };
+
+   std::vector<Collectible*> items; //catalog items indexed by ID
+   std::map<const Collectible*, int, ItemOrder> itemIds; //ID of each item
+};
+
+#endif
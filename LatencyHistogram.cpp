@@ -0,0 +1,202 @@
+/*
+ file name: LatencyHistogram.cpp
+ author: Hall, Ashley
+ The LatencyHistogram class counts measured durations in logarithmic buckets,
+ in the style of an HDR histogram: values below 32 have a bucket each, and
+ every higher power of two is divided into 32 buckets, so any value is kept to
+ within about 3% of its size. Recording a value is a few instructions and
+ never allocates, and the memory used is fixed however many values are
+ recorded, so a histogram can stay in a long-running process. Percentiles are
+ read back from the bucket counts.
+ */
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ LatencyHistogram constructor.
+ @pre None.
+ @post An empty histogram will be created.
+ */
+LatencyHistogram::LatencyHistogram() : buckets(BUCKET_COUNT, 0), totalCount(0),
+   maxValue(0), sum(0) {}
+
+/**
+ Counts a value.
+ @param value The value, usually a duration in nanoseconds.
+ @param count The number of times to count it.
+ @pre None.
+ @post The bucket holding value will be incremented by count.
+ */
+void LatencyHistogram::record(std::uint64_t value, std::uint64_t count)
+{
+   buckets[bucketIndex(value)] += count;
+   totalCount += count;
+   maxValue = std::max(maxValue, value);
+   sum += static_cast<long double>(value) * count;
+}
+
+/**
+ Adds the counts of another histogram.
+ @param other The histogram to add.
+ @pre None.
+ @post The histogram will hold the values recorded in both histograms.
+ */
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+   for ( int i = 0; i < BUCKET_COUNT; i++ )
+      buckets[i] += other.buckets[i];
+   totalCount += other.totalCount;
+   maxValue = std::max(maxValue, other.maxValue);
+   sum += other.sum;
+}
+
+/**
+ Removes every value.
+ @pre None.
+ @post The histogram will be empty.
+ */
+void LatencyHistogram::reset()
+{
+   std::fill(buckets.begin(), buckets.end(), 0);
+   totalCount = 0;
+   maxValue = 0;
+   sum = 0;
+}
+
+/**
+ Returns the number of values recorded.
+ @pre None.
+ @post The total count will be returned.
+ */
+std::uint64_t LatencyHistogram::getCount() const
+{
+   return totalCount;
+}
+
+/**
+ Returns the largest value recorded.
+ @pre None.
+ @post The exact maximum will be returned, or 0 if the histogram is empty.
+ */
+std::uint64_t LatencyHistogram::getMax() const
+{
+   return maxValue;
+}
+
+/**
+ Returns the mean of the values recorded.
+ @pre None.
+ @post The exact mean will be returned, or 0 if the histogram is empty.
+ */
+double LatencyHistogram::getMean() const
+{
+   if ( totalCount == 0 )
+      return 0;
+   return static_cast<double>(sum / totalCount);
+}
+
+/**
+ Returns the value below which a given percentage of the values fall.
+ @param percent The percentage, from 0 to 100.
+ @return The highest value of the bucket holding the percentile, but no more than the maximum.
+ @pre None.
+ @post The percentile will be returned, or 0 if the histogram is empty.
+ */
+std::uint64_t LatencyHistogram::getPercentile(double percent) const
+{
+   if ( totalCount == 0 )
+      return 0;
+
+   //the rank of the value wanted, counting from 1
+   double fraction = std::min(std::max(percent, 0.0), 100.0) / 100;
+   std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(fraction * totalCount));
+   if ( rank < 1 )
+      rank = 1;
+
+   std::uint64_t seen = 0;
+   for ( int i = 0; i < BUCKET_COUNT; i++ )
+   {
+      seen += buckets[i];
+      if ( seen >= rank )
+         return std::min(bucketHighest(i), maxValue);
+   }
+   return maxValue;
+}
+
+/**
+ Writes the count, mean, common percentiles, and maximum in microseconds.
+ @param buffer The buffer to write to.
+ @pre The values must be durations in nanoseconds.
+ @post One line of the form "count N mean X p50 X p90 X p99 X p99.9 X max X (us)" will be appended.
+ */
+void LatencyHistogram::format(OutputBuffer& buffer) const
+{
+   buffer.append("count ").appendUnsigned(totalCount).append(" mean ");
+   appendMicroseconds(buffer, getMean());
+   buffer.append(" p50 ");
+   appendMicroseconds(buffer, getPercentile(50));
+   buffer.append(" p90 ");
+   appendMicroseconds(buffer, getPercentile(90));
+   buffer.append(" p99 ");
+   appendMicroseconds(buffer, getPercentile(99));
+   buffer.append(" p99.9 ");
+   appendMicroseconds(buffer, getPercentile(99.9));
+   buffer.append(" max ");
+   appendMicroseconds(buffer, maxValue);
+   buffer.append(" (us)\n");
+}
+
+/**
+ Finds the bucket of a value.
+ @param value The value.
+ @return The index of the bucket.
+ @pre None.
+ @post The index will be less than BUCKET_COUNT.
+ */
+int LatencyHistogram::bucketIndex(std::uint64_t value)
+{
+   if ( value < SUB_BUCKETS )
+      return static_cast<int>(value);
+
+   //the highest set bit picks the group, the bits below it the sub-bucket
+   int highestBit = 63 - __builtin_clzll(value);
+   int shift = highestBit - SUB_BUCKET_BITS;
+   int subBucket = static_cast<int>(value >> shift) & (SUB_BUCKETS - 1);
+   return (shift + 1) * SUB_BUCKETS + subBucket;
+}
+
+/**
+ Returns the highest value of a bucket.
+ @param index The index of the bucket.
+ @return The largest value that bucketIndex maps to index.
+ @pre index must be less than BUCKET_COUNT.
+ @post The value will be returned.
+ */
+std::uint64_t LatencyHistogram::bucketHighest(int index)
+{
+   if ( index < SUB_BUCKETS )
+      return index;
+
+   int shift = index / SUB_BUCKETS - 1;
+   std::uint64_t lowest =
+      static_cast<std::uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+   return lowest + ((std::uint64_t(1) << shift) - 1);
+}
+
+/**
+ Appends a duration in nanoseconds as microseconds with one decimal.
+ @param buffer The buffer to write to.
+ @param nanoseconds The duration.
+ @pre None.
+ @post The duration will be appended.
+ */
+void LatencyHistogram::appendMicroseconds(OutputBuffer& buffer,
+                                          double nanoseconds)
+{
+   unsigned long long tenths =
+      static_cast<unsigned long long>(nanoseconds / 100 + 0.5);
+   buffer.appendUnsigned(tenths / 10).append('.').appendUnsigned(tenths % 10);
+}
@@ -0,0 +1,135 @@
+/*
+ file name: LatencyHistogram.h
+ author: Hall, Ashley
+ The LatencyHistogram class counts measured durations in logarithmic buckets,
+ in the style of an HDR histogram: values below 32 have a bucket each, and
+ every higher power of two is divided into 32 buckets, so any value is kept to
+ within about 3% of its size. Recording a value is a few instructions and
+ never allocates, and the memory used is fixed however many values are
+ recorded, so a histogram can stay in a long-running process. Percentiles are
+ read back from the bucket counts.
+ */
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <cstdint>
+#include <vector>
+
+#include "OutputBuffer.h"
+
+class LatencyHistogram
+{
+public:
+
+   /**
+    LatencyHistogram constructor.
+    @pre None.
+    @post An empty histogram will be created.
+    */
+   LatencyHistogram();
+
+   /**
+    Counts a value.
+    @param value The value, usually a duration in nanoseconds.
+    @param count The number of times to count it.
+    @pre None.
+    @post The bucket holding value will be incremented by count.
+    */
+   void record(std::uint64_t value, std::uint64_t count = 1);
+
+   /**
+    Adds the counts of another histogram.
+    @param other The histogram to add.
+    @pre None.
+    @post The histogram will hold the values recorded in both histograms.
+    */
+   void merge(const LatencyHistogram& other);
+
+   /**
+    Removes every value.
+    @pre None.
+    @post The histogram will be empty.
+    */
+   void reset();
+
+   /**
+    Returns the number of values recorded.
+    @pre None.
+    @post The total count will be returned.
+    */
+   std::uint64_t getCount() const;
+
+   /**
+    Returns the largest value recorded.
+    @pre None.
+    @post The exact maximum will be returned, or 0 if the histogram is empty.
+    */
+   std::uint64_t getMax() const;
+
+   /**
+    Returns the mean of the values recorded.
+    @pre None.
+    @post The exact mean will be returned, or 0 if the histogram is empty.
+    */
+   double getMean() const;
+
+   /**
+    Returns the value below which a given percentage of the values fall.
+    @param percent The percentage, from 0 to 100.
+    @return The highest value of the bucket holding the percentile, but no more than the maximum.
+    @pre None.
+    @post The percentile will be returned, or 0 if the histogram is empty.
+    */
+   std::uint64_t getPercentile(double percent) const;
+
+   /**
+    Writes the count, mean, common percentiles, and maximum in microseconds.
+    @param buffer The buffer to write to.
+    @pre The values must be durations in nanoseconds.
+    @post One line of the form "count N mean X p50 X p90 X p99 X p99.9 X max X (us)" will be appended.
+    */
+   void format(OutputBuffer& buffer) const;
+
+private:
+
+   /**
+    Finds the bucket of a value.
+    @param value The value.
+    @return The index of the bucket.
+    @pre None.
+    @post The index will be less than BUCKET_COUNT.
+    */
+   static int bucketIndex(std::uint64_t value);
+
+   /**
+    Returns the highest value of a bucket.
+    @param index The index of the bucket.
+    @return The largest value that bucketIndex maps to index.
+    @pre index must be less than BUCKET_COUNT.
+    @post The value will be returned.
+    */
+   static std::uint64_t bucketHighest(int index);
+
+   /**
+    Appends a duration in nanoseconds as microseconds with one decimal.
+    @param buffer The buffer to write to.
+    @param nanoseconds The duration.
+    @pre None.
+    @post The duration will be appended.
+    */
+   static void appendMicroseconds(OutputBuffer& buffer, double nanoseconds);
+
+   //bits of a value below its highest set bit that choose its bucket
+   static const int SUB_BUCKET_BITS = 5;
+   static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+   //exact buckets for values below SUB_BUCKETS, then SUB_BUCKETS per power of two
+   static const int BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+   std::vector<std::uint64_t> buckets; //count of values in each bucket
+   std::uint64_t totalCount; //number of values recorded
+   std::uint64_t maxValue; //largest value recorded
+   long double sum; //sum of the values recorded
+};
+
+#endif
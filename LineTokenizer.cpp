@@ -0,0 +1,112 @@
+/*
+ file name: LineTokenizer.cpp
+ author: Hall, Ashley
+ The LineTokenizer class splits one line of an input file into its comma
+ separated fields. Each field is returned as a std::string_view into the line
+ with a single leading space removed, so no characters are copied. The
+ tokenizer keeps its array of fields between lines, so once it has grown to the
+ longest line read, splitting a line does not allocate memory. The fields
+ returned by split are valid until the next call to split or until the line is
+ modified. The tokenizer also finds the lines of a block of text, such as the
+ contents of a MappedFile, in the same way std::getline reads them.
+ */
+
+#include "LineTokenizer.h"
+
+/**
+ LineTokenizer constructor.
+ @pre None.
+ @post A LineTokenizer with room for a typical command line's fields will be created.
+ */
+LineTokenizer::LineTokenizer()
+{
+   fields.reserve(INITIAL_FIELDS);
+}
+
+/**
+ Splits a line into comma separated fields.
+ @param line The line to split.
+ @return The fields of the line.
+ @pre line must outlive the returned FieldSpan.
+ @post The fields will be the text between the commas of line, with one leading space removed from
+ each. A comma at the end of the line does not start a new field, and an empty line has no fields.
+ */
+FieldSpan LineTokenizer::split(std::string_view line)
+{
+   fields.clear();
+
+   std::size_t start = 0;
+   while ( start < line.size() )
+   {
+      std::size_t comma = line.find(',', start);
+      if ( comma == std::string_view::npos )
+         comma = line.size();
+
+      std::string_view field = line.substr(start, comma - start);
+      //erase leading space
+      if ( !field.empty() && field[0] == ' ' )
+         field.remove_prefix(1);
+      fields.push_back(field);
+
+      start = comma + 1;
+   }
+   return FieldSpan(fields);
+}
+
+/**
+ Finds the next line of a block of text.
+ @param text The text to read.
+ @param position The position of the first character of the next line. It is advanced past the line
+ and its line break.
+ @param line Set to the line, without its line break.
+ @return True if a line was found. False if position is at the end of text.
+ @pre position must not be greater than text.size().
+ @post The lines are returned in the same way std::getline returns them: a line break at the end of
+ the text does not start another line.
+ */
+bool LineTokenizer::nextLine(std::string_view text, std::size_t& position,
+                             std::string_view& line)
+{
+   if ( position >= text.size() )
+      return false;
+
+   std::size_t lineEnd = text.find('\n', position);
+   if ( lineEnd == std::string_view::npos )
+      lineEnd = text.size();
+   line = text.substr(position, lineEnd - position);
+   position = lineEnd + 1;
+   return true;
+}
+
+/**
+ Divides a block of text into chunks that each hold whole lines.
+ @param text The text to divide.
+ @param chunkCount The number of chunks wanted.
+ @param chunks Set to the chunks in the order they appear in text.
+ @pre chunkCount must be at least 1.
+ @post The chunks will be about the same length, will end just after a line break or at the end of
+ text, and together will hold every character of text. There may be fewer than chunkCount chunks
+ if text has few lines.
+ */
+void LineTokenizer::splitChunks(std::string_view text,
+                                std::size_t chunkCount,
+                                std::vector<std::string_view>& chunks)
+{
+   chunks.clear();
+   std::size_t targetLength = text.size() / chunkCount + 1;
+
+   std::size_t start = 0;
+   while ( start < text.size() )
+   {
+      //end the chunk after the first line break past its target length
+      std::size_t end = text.size();
+      if ( text.size() - start > targetLength )
+      {
+         std::size_t lineEnd = text.find('\n', start + targetLength - 1);
+         if ( lineEnd != std::string_view::npos )
+            end = lineEnd + 1;
+      }
+      chunks.push_back(text.substr(start, end - start));
+      start = end;
+   }
+}
@@ -0,0 +1,158 @@
+/*
+ file name: MappedFile.cpp
+ author: Hall, Ashley
+ The MappedFile class gives read-only access to the whole contents of an
+ input file as one contiguous block of characters. A regular file is mapped
+ into memory with mmap and the kernel is advised that it will be read
+ sequentially, so the loaders parse the file's pages in place without
+ copying them into stream buffers. Files that cannot be mapped, such as pipes
+ and FIFOs, are read into a buffer owned by the MappedFile instead. The
+ contents stay valid until the MappedFile is destroyed.
+ */
+
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ MappedFile constructor.
+ @pre None.
+ @post A MappedFile with no open file and empty contents will be created.
+ */
+MappedFile::MappedFile() : mapping(nullptr), mappingLength(0) {}
+
+/**
+ MappedFile destructor. Unmaps the file and releases its buffer.
+ @pre None.
+ @post The mapping and buffer will be released and the contents will no longer be valid.
+ */
+MappedFile::~MappedFile()
+{
+   close();
+}
+
+/**
+ Opens a file and makes its contents available.
+ @param fileName The name of the file to open.
+ @return True if the file was opened and read. False otherwise.
+ @pre None.
+ @post Any previously opened file will be released. If the file is a regular file it will be mapped
+ into memory with a sequential access hint. Otherwise it will be read into a buffer until end of file.
+ */
+bool MappedFile::open(const std::string& fileName)
+{
+   close();
+
+   int fileDescriptor = ::open(fileName.c_str(), O_RDONLY);
+   if ( fileDescriptor < 0 )
+      return false;
+
+   struct stat fileStatus;
+   if ( fstat(fileDescriptor, &fileStatus) != 0 )
+   {
+      ::close(fileDescriptor);
+      return false;
+   }
+
+   //map regular files, an empty file cannot be mapped and has no contents
+   if ( S_ISREG(fileStatus.st_mode) )
+   {
+      if ( fileStatus.st_size == 0 )
+      {
+         ::close(fileDescriptor);
+         return true;
+      }
+
+      void* address = mmap(nullptr, fileStatus.st_size, PROT_READ,
+                           MAP_PRIVATE, fileDescriptor, 0);
+      if ( address != MAP_FAILED )
+      {
+         //the mapping holds its own reference to the file
+         ::close(fileDescriptor);
+         madvise(address, fileStatus.st_size, MADV_SEQUENTIAL);
+         mapping = static_cast<const char*>(address);
+         mappingLength = fileStatus.st_size;
+         return true;
+      }
+   }
+
+   //pipes, FIFOs, and files that could not be mapped are read into the buffer
+   bool complete = readAll(fileDescriptor);
+   ::close(fileDescriptor);
+   return complete;
+}
+
+/**
+ Returns the contents of the open file.
+ @pre None.
+ @post A view of every character in the file will be returned. It is empty if no file is open.
+ */
+std::string_view MappedFile::getContents() const
+{
+   if ( mapping != nullptr )
+      return std::string_view(mapping, mappingLength);
+   return buffer;
+}
+
+/**
+ Determines whether the contents are mapped from the file rather than read into a buffer.
+ @pre None.
+ @post True will be returned if the contents are a memory mapping. False otherwise.
+ */
+bool MappedFile::isMapped() const
+{
+   return mapping != nullptr;
+}
+
+/**
+ Releases the open file.
+ @pre None.
+ @post The mapping and buffer will be released and the contents will be empty.
+ */
+void MappedFile::close()
+{
+   if ( mapping != nullptr )
+   {
+      munmap(const_cast<char*>(mapping), mappingLength);
+      mapping = nullptr;
+      mappingLength = 0;
+   }
+   std::string().swap(buffer);
+}
+
+/**
+ Reads from a file descriptor into the buffer until end of file.
+ @param fileDescriptor The descriptor to read from.
+ @return True if end of file was reached. False if a read failed.
+ @pre fileDescriptor must be open for reading.
+ @post The characters read will be in the buffer.
+ */
+bool MappedFile::readAll(int fileDescriptor)
+{
+   std::size_t used = 0;
+   while ( true )
+   {
+      //grow the buffer so each read has READ_SIZE bytes of room
+      if ( buffer.size() < used + READ_SIZE )
+         buffer.resize(used + READ_SIZE < buffer.size() * 2
+                       ? buffer.size() * 2 : used + READ_SIZE);
+
+      ssize_t bytesRead = ::read(fileDescriptor, &buffer[used], READ_SIZE);
+      if ( bytesRead == 0 )
+         break;
+      if ( bytesRead < 0 )
+      {
+         if ( errno == EINTR )
+            continue;
+         buffer.resize(used);
+         return false;
+      }
+      used += bytesRead;
+   }
+   buffer.resize(used);
+   return true;
+}
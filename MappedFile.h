@@ -0,0 +1,90 @@
+/*
+ file name: MappedFile.h
+ author: Hall, Ashley
+ The MappedFile class gives read-only access to the whole contents of an
+ input file as one contiguous block of characters. A regular file is mapped
+ into memory with mmap and the kernel is advised that it will be read
+ sequentially, so the loaders parse the file's pages in place without
+ copying them into stream buffers. Files that cannot be mapped, such as pipes
+ and FIFOs, are read into a buffer owned by the MappedFile instead. The
+ contents stay valid until the MappedFile is destroyed.
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+class MappedFile
+{
+public:
+
+   /**
+    MappedFile constructor.
+    @pre None.
+    @post A MappedFile with no open file and empty contents will be created.
+    */
+   MappedFile();
+
+   /**
+    MappedFile destructor. Unmaps the file and releases its buffer.
+    @pre None.
+    @post The mapping and buffer will be released and the contents will no longer be valid.
+    */
+   virtual ~MappedFile();
+
+   MappedFile(const MappedFile&) = delete;
+   MappedFile& operator=(const MappedFile&) = delete;
+
+   /**
+    Opens a file and makes its contents available.
+    @param fileName The name of the file to open.
+    @return True if the file was opened and read. False otherwise.
+    @pre None.
+    @post Any previously opened file will be released. If the file is a regular file it will be mapped
+    into memory with a sequential access hint. Otherwise it will be read into a buffer until end of file.
+    */
+   bool open(const std::string& fileName);
+
+   /**
+    Returns the contents of the open file.
+    @pre None.
+    @post A view of every character in the file will be returned. It is empty if no file is open.
+    */
+   std::string_view getContents() const;
+
+   /**
+    Determines whether the contents are mapped from the file rather than read into a buffer.
+    @pre None.
+    @post True will be returned if the contents are a memory mapping. False otherwise.
+    */
+   bool isMapped() const;
+
+   /**
+    Releases the open file.
+    @pre None.
+    @post The mapping and buffer will be released and the contents will be empty.
+    */
+   void close();
+
+private:
+
+   /**
+    Reads from a file descriptor into the buffer until end of file.
+    @param fileDescriptor The descriptor to read from.
+    @return True if end of file was reached. False if a read failed.
+    @pre fileDescriptor must be open for reading.
+    @post The characters read will be in the buffer.
+    */
+   bool readAll(int fileDescriptor);
+
+   static const std::size_t READ_SIZE = 1 << 16; //bytes per buffered read
+
+   const char* mapping; //start of the mapping, or nullptr if not mapped
+   std::size_t mappingLength; //length of the mapping in bytes
+   std::string buffer; //contents of a file that could not be mapped
+};
+
+#endif
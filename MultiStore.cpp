@@ -0,0 +1,236 @@
+/*
+ file name: MultiStore.cpp
+ author: Hall, Ashley
+ The MultiStore class hosts many StoreInventory objects, one for each store
+ location, in a single process. The stores are divided into shards, one per
+ thread, and every store belongs to exactly one shard, so a store is only ever
+ touched by its own thread and needs no lock. The items a shard creates come
+ from its thread's own ObjectPools, and an item freed on another thread goes
+ back to its pool with a lock-free push, so once each thread has been given
+ its pools the shards execute their commands without taking a lock shared
+ between them. They still share the general-purpose allocator used for strings
+ and vectors. Each command line names its store with a numeric prefix, as in
+ "12:S, 255, M, 1985, 29, Liberty". The calling thread reads the lines and
+ routes them in batches to the shard of their store through a single-producer
+ single-consumer queue per shard, and the commands of each store are executed
+ in the order they were read. The MultiStore class assumes ownership of the
+ memory for its StoreInventory objects.
+ */
+
+#include "MultiStore.h"
+
+#include <charconv>
+#include <thread>
+
+#include "LineTokenizer.h"
+#include "WorkerPool.h"
+
+/**
+ MultiStore constructor.
+ @param threadCount The number of shards, each executing its stores' commands on a thread of its
+ own.
+ @pre None.
+ @post A MultiStore with no stores will be created. A threadCount below 1 is treated as 1.
+ */
+MultiStore::MultiStore(int threadCount)
+: shardCount(threadCount < 1 ? 1 : threadCount) {}
+
+/**
+ MultiStore destructor.
+ @pre None.
+ @post Every store will have been deleted.
+ */
+MultiStore::~MultiStore()
+{
+   for ( std::size_t i = 0; i < stores.size(); i++ )
+      delete stores[i];
+}
+
+/**
+ Adds an empty store.
+ @param storeId The store's number, used as the prefix of its commands.
+ @return A pointer to the new store, or nullptr if the number is already used or larger than
+ MAX_STORE_ID.
+ @pre None.
+ @post The store will be assigned to the next shard in turn.
+ */
+StoreInventory* MultiStore::addStore(unsigned long storeId)
+{
+   if ( storeId > MAX_STORE_ID || findStore(storeId) != nullptr )
+      return nullptr;
+
+   if ( storeId >= storeIndexes.size() )
+      storeIndexes.resize(storeId + 1, -1);
+   storeIndexes[storeId] = stores.size();
+   stores.push_back(new StoreInventory);
+   storeIds.push_back(storeId);
+   storeShards.push_back(storeIndexes[storeId] % shardCount);
+   return stores.back();
+}
+
+/**
+ Finds a store by its number.
+ @param storeId The store's number.
+ @return A pointer to the store, or nullptr if there is no store with that number.
+ @pre None.
+ @post The MultiStore will not change.
+ */
+StoreInventory* MultiStore::findStore(unsigned long storeId) const
+{
+   if ( storeId >= storeIndexes.size() || storeIndexes[storeId] < 0 )
+      return nullptr;
+   return stores[storeIndexes[storeId]];
+}
+
+/**
+ Returns the number of stores.
+ @pre None.
+ @post The number of stores added will be returned.
+ */
+std::size_t MultiStore::getStoreCount() const
+{
+   return stores.size();
+}
+
+/**
+ Returns the number of shards.
+ @pre None.
+ @post The number of threads that execute commands will be returned.
+ */
+int MultiStore::getShardCount() const
+{
+   return shardCount;
+}
+
+/**
+ Calls a function with every store, for example to load them, using the shards' threads.
+ @param task The function, called as task(storeId, store).
+ @pre task must be safe to call from several threads at once for different stores.
+ @post task will have been called once for every store and every call will have returned.
+ */
+void MultiStore::forEachStore(
+   const std::function<void(unsigned long, StoreInventory&)>& task)
+{
+   WorkerPool workers(shardCount);
+   workers.run(stores.size(), [this, &task](std::size_t index)
+      {
+         task(storeIds[index], *stores[index]);
+      });
+}
+
+/**
+ Processes store commands from the contents of a command file.
+ @param contents The text of the file. Every line starts with a store number and a colon.
+ @pre The stores must not be used by any other thread.
+ @post Every line will have been executed by its store, in order for each store, and the output of
+ every store written. Lines without the number of a store are ignored, as lines with an unknown
+ command are.
+ */
+void MultiStore::processCommandsFromText(std::string_view contents)
+{
+   //start a thread and a queue for each shard
+   std::vector<SpscQueue<Batch>*> queues;
+   std::vector<std::thread> threads;
+   for ( int shard = 0; shard < shardCount; shard++ )
+   {
+      queues.push_back(new SpscQueue<Batch>(SHARD_QUEUE_CAPACITY));
+      threads.emplace_back(&MultiStore::executeBatches, this, shard,
+                           std::ref(*queues[shard]));
+   }
+
+   //the batch each shard is filling, or nullptr
+   std::vector<Batch*> filling(shardCount, nullptr);
+
+   std::size_t position = 0;
+   std::string_view line;
+   std::string_view command;
+   while ( LineTokenizer::nextLine(contents, position, line) )
+   {
+      int index = routeLine(line, command);
+      if ( index < 0 )
+         continue;
+      int shard = storeShards[index];
+
+      if ( filling[shard] == nullptr )
+      {
+         filling[shard] = &queues[shard]->beginPush();
+         filling[shard]->routes.clear();
+         filling[shard]->last = false;
+      }
+      filling[shard]->routes.push_back({stores[index], command});
+      if ( filling[shard]->routes.size() >= BATCH_LINES )
+      {
+         queues[shard]->endPush();
+         filling[shard] = nullptr;
+      }
+   }
+
+   //send the rest of the lines and mark the end of each shard's batches
+   for ( int shard = 0; shard < shardCount; shard++ )
+   {
+      if ( filling[shard] == nullptr )
+      {
+         filling[shard] = &queues[shard]->beginPush();
+         filling[shard]->routes.clear();
+      }
+      filling[shard]->last = true;
+      queues[shard]->endPush();
+   }
+
+   for ( int shard = 0; shard < shardCount; shard++ )
+   {
+      threads[shard].join();
+      delete queues[shard];
+   }
+}
+
+/**
+ Executes the batches of one shard. Runs on the shard's thread.
+ @param shard The number of the shard.
+ @param queue The shard's queue.
+ @pre Every route must name a store of the shard.
+ @post Every batch up to the last will have been executed and the output of the shard's stores
+ written.
+ */
+void MultiStore::executeBatches(int shard, SpscQueue<Batch>& queue)
+{
+   bool last = false;
+   while ( !last )
+   {
+      Batch& batch = queue.front();
+      for ( std::size_t i = 0; i < batch.routes.size(); i++ )
+         batch.routes[i].store->processCommand(batch.routes[i].line);
+      last = batch.last;
+      queue.popFront();
+   }
+
+   //apply the trades left in each store's window
+   for ( std::size_t i = 0; i < stores.size(); i++ )
+   {
+      if ( storeShards[i] == shard )
+         stores[i]->finishCommands();
+   }
+}
+
+/**
+ Splits the store prefix from a command line.
+ @param line The command line.
+ @param command Set to the rest of the line after the colon.
+ @return The index of the store in the order the stores were added, or -1 if the line does not
+ start with the number of a store.
+ @pre None.
+ @post The MultiStore will not change.
+ */
+int MultiStore::routeLine(std::string_view line,
+                          std::string_view& command) const
+{
+   unsigned long storeId = 0;
+   std::from_chars_result result =
+      std::from_chars(line.data(), line.data() + line.size(), storeId);
+   if ( result.ec != std::errc() || result.ptr == line.data() + line.size()
+       || *result.ptr != ':' || storeId >= storeIndexes.size() )
+      return -1;
+
+   command = line.substr(result.ptr + 1 - line.data());
+   return storeIndexes[storeId];
+}
@@ -0,0 +1,158 @@
+/*
+ file name: MultiStore.h
+ author: Hall, Ashley
+ The MultiStore class hosts many StoreInventory objects, one for each store
+ location, in a single process. The stores are divided into shards, one per
+ thread, and every store belongs to exactly one shard, so a store is only ever
+ touched by its own thread and needs no lock. The items a shard creates come
+ from its thread's own ObjectPools, and an item freed on another thread goes
+ back to its pool with a lock-free push, so once each thread has been given
+ its pools the shards execute their commands without taking a lock shared
+ between them. They still share the general-purpose allocator used for strings
+ and vectors. Each command line names its store with a numeric prefix, as in
+ "12:S, 255, M, 1985, 29, Liberty". The calling thread reads the lines and
+ routes them in batches to the shard of their store through a single-producer
+ single-consumer queue per shard, and the commands of each store are executed
+ in the order they were read. The MultiStore class assumes ownership of the
+ memory for its StoreInventory objects.
+ */
+
+#ifndef MULTISTORE_H
+#define MULTISTORE_H
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include "StoreInventory.h"
+#include "SpscQueue.h"
+
+class MultiStore
+{
+public:
+
+   /**
+    MultiStore constructor.
+    @param threadCount The number of shards, each executing its stores' commands on a thread of its
+    own.
+    @pre None.
+    @post A MultiStore with no stores will be created. A threadCount below 1 is treated as 1.
+    */
+   explicit MultiStore(int threadCount);
+
+   /**
+    MultiStore destructor.
+    @pre None.
+    @post Every store will have been deleted.
+    */
+   virtual ~MultiStore();
+
+   MultiStore(const MultiStore&) = delete;
+   MultiStore& operator=(const MultiStore&) = delete;
+
+   /**
+    Adds an empty store.
+    @param storeId The store's number, used as the prefix of its commands.
+    @return A pointer to the new store, or nullptr if the number is already used or larger than
+    MAX_STORE_ID.
+    @pre None.
+    @post The store will be assigned to the next shard in turn.
+    */
+   StoreInventory* addStore(unsigned long storeId);
+
+   /**
+    Finds a store by its number.
+    @param storeId The store's number.
+    @return A pointer to the store, or nullptr if there is no store with that number.
+    @pre None.
+    @post The MultiStore will not change.
+    */
+   StoreInventory* findStore(unsigned long storeId) const;
+
+   /**
+    Returns the number of stores.
+    @pre None.
+    @post The number of stores added will be returned.
+    */
+   std::size_t getStoreCount() const;
+
+   /**
+    Returns the number of shards.
+    @pre None.
+    @post The number of threads that execute commands will be returned.
+    */
+   int getShardCount() const;
+
+   /**
+    Calls a function with every store, for example to load them, using the shards' threads.
+    @param task The function, called as task(storeId, store).
+    @pre task must be safe to call from several threads at once for different stores.
+    @post task will have been called once for every store and every call will have returned.
+    */
+   void forEachStore(
+      const std::function<void(unsigned long, StoreInventory&)>& task);
+
+   /**
+    Processes store commands from the contents of a command file.
+    @param contents The text of the file. Every line starts with a store number and a colon.
+    @pre The stores must not be used by any other thread.
+    @post Every line will have been executed by its store, in order for each store, and the output of
+    every store written. Lines without the number of a store are ignored, as lines with an unknown
+    command are.
+    */
+   void processCommandsFromText(std::string_view contents);
+
+   //largest store number accepted
+   static const unsigned long MAX_STORE_ID = (1 << 20) - 1;
+
+private:
+
+   //a command line and the store that executes it
+   struct Route
+   {
+      StoreInventory* store;
+      std::string_view line; //command without its store prefix
+   };
+
+   //lines passed to a shard at once
+   struct Batch
+   {
+      std::vector<Route> routes;
+      bool last = false; //true if no batch follows
+   };
+
+   /**
+    Executes the batches of one shard. Runs on the shard's thread.
+    @param shard The number of the shard.
+    @param queue The shard's queue.
+    @pre Every route must name a store of the shard.
+    @post Every batch up to the last will have been executed and the output of the shard's stores
+    written.
+    */
+   void executeBatches(int shard, SpscQueue<Batch>& queue);
+
+   /**
+    Splits the store prefix from a command line.
+    @param line The command line.
+    @param command Set to the rest of the line after the colon.
+    @return The index of the store in the order the stores were added, or -1 if the line does not
+    start with the number of a store.
+    @pre None.
+    @post The MultiStore will not change.
+    */
+   int routeLine(std::string_view line, std::string_view& command) const;
+
+   int shardCount; //number of shards and of their threads
+   std::vector<StoreInventory*> stores; //stores in the order they were added
+   std::vector<unsigned long> storeIds; //number of each store
+   std::vector<int> storeShards; //shard of each store
+   std::vector<int> storeIndexes; //index of the store with each number, or -1
+
+   //lines routed to a shard before its batch is queued
+   static const std::size_t BATCH_LINES = 256;
+   //batches each shard's queue holds
+   static const std::size_t SHARD_QUEUE_CAPACITY = 64;
+};
+
+#endif
@@ -0,0 +1,197 @@
+/*
+ file name: ObjectPool.h
+ author: Hall, Ashley
+ description:
+ The ObjectPool class recycles the memory for objects of a single type.
+ Memory is reserved from the global allocator in chunks holding many blocks,
+ each large enough for one object. Blocks that are returned to the pool are
+ kept on a free list and handed out again by the next allocation, so once the
+ pool has grown to the number of live objects no further chunks are needed.
+ Every thread allocates from a pool of its own, so allocating and freeing on
+ the same thread take no lock. Each block remembers the pool it came from,
+ and a block freed on another thread is pushed onto that pool's list of
+ returned blocks with a lock-free compare-and-swap; the owning thread takes
+ the whole list back when its free list runs out. When a thread exits its
+ pool is kept, still receiving returned blocks, and the next thread that needs
+ a pool adopts it, so the number of pools never exceeds the number of threads
+ alive at once. Only adopting and giving up a pool, once per thread, takes a
+ lock. The pools and their chunks are kept until the process ends, since
+ their objects may outlive the threads that created them. The pool only
+ manages raw memory; objects are constructed and destroyed by the
+ class-specific operator new and operator delete of the pooled type.
+ */
+
+#ifndef ObjectPool_h
+#define ObjectPool_h
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+
+template<typename T>
+class ObjectPool
+{
+private:
+
+   struct Block
+   {
+      ObjectPool* owner; //the pool the block is returned to
+      union
+      {
+         Block* next; //next free block when the block is on a free list
+         alignas(T) unsigned char storage[sizeof(T)]; //memory for one object
+      };
+   };
+
+   /*
+    Gives up the calling thread's pool when the thread exits.
+    */
+   struct Owner
+   {
+      ObjectPool* pool = nullptr; //the pool adopted by the thread
+
+      ~Owner()
+      {
+         if ( pool != nullptr )
+            release( pool );
+         current = nullptr;
+      }
+   };
+
+   Block* freeList; //free blocks, used only by the owning thread
+   std::atomic<Block*> returnedList; //blocks freed by other threads
+   std::vector<Block*> chunks; //chunks of blocks reserved from the allocator
+   int blocksPerChunk; //number of blocks reserved per chunk
+
+   static inline thread_local ObjectPool* current = nullptr; //the calling thread's pool
+   static inline thread_local Owner owner; //releases the thread's pool at exit
+   static inline std::mutex orphansMutex; //guards orphans
+   static inline std::vector<ObjectPool*> orphans; //pools of exited threads
+
+   /**
+    Constructs an empty ObjectPool.
+    @param chunkSize The number of blocks to reserve each time the pool grows.
+    @pre chunkSize must be greater than 0.
+    @post An ObjectPool with no reserved memory will be created.
+    */
+   explicit ObjectPool( int chunkSize = 256 ) :
+      freeList(nullptr), returnedList(nullptr), blocksPerChunk(chunkSize) {}
+
+   /**
+    Reserves a new chunk of blocks and threads them onto the free list.
+    @pre Only the owning thread may call addChunk.
+    @post blocksPerChunk blocks owned by the pool will be added to the front of the free list.
+    */
+   void addChunk()
+   {
+      Block* chunk = static_cast<Block*>(
+         ::operator new( sizeof(Block) * blocksPerChunk ) );
+      chunks.push_back( chunk );
+
+      //link the blocks of the chunk in order
+      for ( int i = 0; i < blocksPerChunk; i++ )
+      {
+         chunk[i].owner = this;
+         chunk[i].next = i + 1 < blocksPerChunk ? &chunk[i + 1] : freeList;
+      }
+      freeList = chunk;
+   }
+
+   /**
+    Gives a pool to the calling thread, adopting the pool of an exited thread if there is one.
+    @pre The calling thread must not have a pool.
+    @post current will point to a pool owned by the calling thread.
+    */
+   static void adopt()
+   {
+      {
+         std::lock_guard<std::mutex> lock( orphansMutex );
+         if ( !orphans.empty() )
+         {
+            current = orphans.back();
+            orphans.pop_back();
+         }
+      }
+      if ( current == nullptr )
+         current = new ObjectPool;
+      owner.pool = current;
+   }
+
+   /**
+    Gives up a pool for another thread to adopt.
+    @param pool The pool of the exiting thread.
+    @pre No thread may own pool afterwards but the one that adopts it.
+    @post The pool will be kept, with its blocks, for the next thread that needs one.
+    */
+   static void release( ObjectPool* pool )
+   {
+      std::lock_guard<std::mutex> lock( orphansMutex );
+      orphans.push_back( pool );
+   }
+
+public:
+
+   ObjectPool( const ObjectPool& ) = delete;
+   ObjectPool& operator=( const ObjectPool& ) = delete;
+
+   /**
+    Hands out memory for one object of type T from the calling thread's pool.
+    @return A pointer to uninitialized memory large enough for a T.
+    @pre None.
+    @post A block will be removed from the thread's free list and returned. If the free list is
+    empty the blocks returned by other threads are taken back first, and a new chunk is reserved if
+    there are none.
+    */
+   static void* allocate()
+   {
+      if ( current == nullptr )
+         adopt();
+      ObjectPool& pool = *current;
+      if ( pool.freeList == nullptr )
+      {
+         pool.freeList = pool.returnedList.exchange( nullptr,
+                                                     std::memory_order_acquire );
+         if ( pool.freeList == nullptr )
+            pool.addChunk();
+      }
+      Block* block = pool.freeList;
+      pool.freeList = block->next;
+      return block->storage;
+   }
+
+   /**
+    Returns the memory for one object to the pool it was allocated from.
+    @param memory The pointer previously returned by allocate().
+    @pre memory must have been handed out by allocate and the object in it must be destroyed.
+    @post The block will be placed at the front of the free list when the calling thread owns its
+    pool, and on the pool's list of returned blocks otherwise.
+    */
+   static void deallocate( void* memory )
+   {
+      if ( memory == nullptr )
+         return;
+      Block* block = reinterpret_cast<Block*>(
+         static_cast<unsigned char*>(memory) - offsetof(Block, storage) );
+      ObjectPool* pool = block->owner;
+      if ( pool == current )
+      {
+         block->next = pool->freeList;
+         pool->freeList = block;
+         return;
+      }
+
+      //the owning thread only ever takes the whole list, so a push needs no lock
+      Block* head = pool->returnedList.load( std::memory_order_relaxed );
+      do
+         block->next = head;
+      while ( !pool->returnedList.compare_exchange_weak( head, block,
+                                                          std::memory_order_release,
+                                                          std::memory_order_relaxed ) );
+   }
+};
+
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ file name: OutputBuffer.cpp
+ author: Hall, Ashley
+ The OutputBuffer class collects formatted output in a single growable
+ character buffer. Strings and characters are copied straight into the
+ buffer and integers are converted in place with std::to_chars, so formatting
+ an object does not create temporary strings. Clearing the buffer keeps its
+ capacity, allowing one OutputBuffer to be reused for many reports. The
+ contents are written to an output stream with a single write.
+ */
+
+#include "OutputBuffer.h"
+
+#include <charconv>
+
+/**
+ OutputBuffer constructor.
+ @param initialCapacity The number of characters to reserve.
+ @pre None.
+ @post An empty OutputBuffer with room for initialCapacity characters will be created.
+ */
+OutputBuffer::OutputBuffer(std::size_t initialCapacity)
+{
+   contents.reserve(initialCapacity);
+}
+
+/**
+ Appends a string to the buffer.
+ @param text The characters to append.
+ @return The OutputBuffer, allowing appends to be chained.
+ @pre None.
+ @post The characters of text will be added to the end of the buffer.
+ */
+OutputBuffer& OutputBuffer::append(std::string_view text)
+{
+   contents.append(text.data(), text.size());
+   return *this;
+}
+
+/**
+ Appends a character to the buffer.
+ @param character The character to append.
+ @return The OutputBuffer, allowing appends to be chained.
+ @pre None.
+ @post The character will be added to the end of the buffer.
+ */
+OutputBuffer& OutputBuffer::append(char character)
+{
+   contents.push_back(character);
+   return *this;
+}
+
+/**
+ Appends the decimal representation of an integer to the buffer.
+ @param value The integer to append.
+ @return The OutputBuffer, allowing appends to be chained.
+ @pre None.
+ @post The digits of value, preceded by '-' if it is negative, will be added to the end of the buffer.
+ */
+OutputBuffer& OutputBuffer::appendInt(long long value)
+{
+   char digits[MAX_DIGITS];
+   std::to_chars_result result = std::to_chars(digits, digits + MAX_DIGITS,
+                                               value);
+   contents.append(digits, result.ptr - digits);
+   return *this;
+}
+
+/**
+ Appends the decimal representation of an unsigned integer to the buffer.
+ @param value The integer to append.
+ @return The OutputBuffer, allowing appends to be chained.
+ @pre None.
+ @post The digits of value will be added to the end of the buffer.
+ */
+OutputBuffer& OutputBuffer::appendUnsigned(unsigned long long value)
+{
+   char digits[MAX_DIGITS];
+   std::to_chars_result result = std::to_chars(digits, digits + MAX_DIGITS,
+                                               value);
+   contents.append(digits, result.ptr - digits);
+   return *this;
+}
+
+/**
+ Removes all characters from the buffer.
+ @pre None.
+ @post The buffer will be empty. Its capacity will not change.
+ */
+void OutputBuffer::clear()
+{
+   contents.clear();
+}
+
+/**
+ Returns the number of characters in the buffer.
+ @pre None.
+ @post The number of characters in the buffer will be returned.
+ */
+std::size_t OutputBuffer::size() const
+{
+   return contents.size();
+}
+
+/**
+ Determines whether the buffer is empty.
+ @pre None.
+ @post True will be returned if the buffer contains no characters. False otherwise.
+ */
+bool OutputBuffer::isEmpty() const
+{
+   return contents.empty();
+}
+
+/**
+ Returns a view of the characters in the buffer.
+ @pre None.
+ @post A view of the buffer's contents will be returned. It is invalidated by the next append or clear.
+ */
+std::string_view OutputBuffer::view() const
+{
+   return std::string_view(contents);
+}
+
+/**
+ Returns a copy of the characters in the buffer.
+ @pre None.
+ @post A string containing the buffer's contents will be returned.
+ */
+std::string OutputBuffer::str() const
+{
+   return contents;
+}
+
+/**
+ Writes the contents of the buffer to an output stream.
+ @param outputStream The stream to write to.
+ @pre outputStream must be an ostream object.
+ @post The buffer's contents will be inserted into the output stream with a single write. The buffer
+ will not be cleared.
+ */
+void OutputBuffer::writeTo(std::ostream& outputStream) const
+{
+   outputStream.write(contents.data(), contents.size());
+}
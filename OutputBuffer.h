@@ -0,0 +1,119 @@
+/*
+ file name: OutputBuffer.h
+ author: Hall, Ashley
+ The OutputBuffer class collects formatted output in a single growable
+ character buffer. Strings and characters are copied straight into the
+ buffer and integers are converted in place with std::to_chars, so formatting
+ an object does not create temporary strings. Clearing the buffer keeps its
+ capacity, allowing one OutputBuffer to be reused for many reports. The
+ contents are written to an output stream with a single write.
+ */
+
+#ifndef OUTPUTBUFFER_H
+#define OUTPUTBUFFER_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+
+class OutputBuffer
+{
+public:
+
+   /**
+    OutputBuffer constructor.
+    @param initialCapacity The number of characters to reserve.
+    @pre None.
+    @post An empty OutputBuffer with room for initialCapacity characters will be created.
+    */
+   explicit OutputBuffer(std::size_t initialCapacity = 256);
+
+   /**
+    Appends a string to the buffer.
+    @param text The characters to append.
+    @return The OutputBuffer, allowing appends to be chained.
+    @pre None.
+    @post The characters of text will be added to the end of the buffer.
+    */
+   OutputBuffer& append(std::string_view text);
+
+   /**
+    Appends a character to the buffer.
+    @param character The character to append.
+    @return The OutputBuffer, allowing appends to be chained.
+    @pre None.
+    @post The character will be added to the end of the buffer.
+    */
+   OutputBuffer& append(char character);
+
+   /**
+    Appends the decimal representation of an integer to the buffer.
+    @param value The integer to append.
+    @return The OutputBuffer, allowing appends to be chained.
+    @pre None.
+    @post The digits of value, preceded by '-' if it is negative, will be added to the end of the buffer.
+    */
+   OutputBuffer& appendInt(long long value);
+
+   /**
+    Appends the decimal representation of an unsigned integer to the buffer.
+    @param value The integer to append.
+    @return The OutputBuffer, allowing appends to be chained.
+    @pre None.
+    @post The digits of value will be added to the end of the buffer.
+    */
+   OutputBuffer& appendUnsigned(unsigned long long value);
+
+   /**
+    Removes all characters from the buffer.
+    @pre None.
+    @post The buffer will be empty. Its capacity will not change.
+    */
+   void clear();
+
+   /**
+    Returns the number of characters in the buffer.
+    @pre None.
+    @post The number of characters in the buffer will be returned.
+    */
+   std::size_t size() const;
+
+   /**
+    Determines whether the buffer is empty.
+    @pre None.
+    @post True will be returned if the buffer contains no characters. False otherwise.
+    */
+   bool isEmpty() const;
+
+   /**
+    Returns a view of the characters in the buffer.
+    @pre None.
+    @post A view of the buffer's contents will be returned. It is invalidated by the next append or clear.
+    */
+   std::string_view view() const;
+
+   /**
+    Returns a copy of the characters in the buffer.
+    @pre None.
+    @post A string containing the buffer's contents will be returned.
+    */
+   std::string str() const;
+
+   /**
+    Writes the contents of the buffer to an output stream.
+    @param outputStream The stream to write to.
+    @pre outputStream must be an ostream object.
+    @post The buffer's contents will be inserted into the output stream with a single write. The buffer
+    will not be cleared.
+    */
+   void writeTo(std::ostream& outputStream) const;
+
+private:
+
+   std::string contents; //formatted characters
+
+   //enough room for the digits and sign of any 64-bit integer
+   static const int MAX_DIGITS = 24;
+};
+
+#endif
@@ -0,0 +1,171 @@
+/*
+ file name: OutputSink.cpp
+ author: Hall, Ashley
+ The OutputSink class is the destination of the store's reports or error
+ messages. Text written to a sink is collected in a large buffer and passed
+ to the operating system with one write call when the buffer fills, when the
+ sink is flushed, and when it is destroyed, so output redirected to a file or
+ pipe does not cost a system call per line. A sink writes to standard output,
+ standard error, or a file it opens. A sink with a capacity of 0 writes every
+ call straight through, in the same way std::cerr does, and a sink can be set
+ to flush at the end of every command for interactive use.
+ */
+
+#include "OutputSink.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ OutputSink constructor.
+ @param fileDescriptor The open file descriptor to write to, such as STDOUT_FILENO.
+ @param capacity The number of characters collected before they are written. 0 writes every call
+ straight through.
+ @pre fileDescriptor must be open for writing.
+ @post A sink writing to fileDescriptor will be created. The descriptor is not closed by the sink.
+ */
+OutputSink::OutputSink(int fileDescriptor, std::size_t capacity)
+: fileDescriptor(fileDescriptor), ownsDescriptor(false), capacity(capacity),
+  flushEachCommand(false)
+{
+   buffer.reserve(capacity);
+}
+
+/**
+ OutputSink destructor. Flushes the buffer and closes a file opened by the sink.
+ @pre None.
+ @post Every character written to the sink will have been passed to the operating system.
+ */
+OutputSink::~OutputSink()
+{
+   flush();
+   if ( ownsDescriptor )
+      ::close(fileDescriptor);
+}
+
+/**
+ Redirects the sink to a file.
+ @param fileName The name of the file. It is created or truncated.
+ @return True if the file was opened. False otherwise, and the sink is unchanged.
+ @pre None.
+ @post The buffer will be flushed to the previous destination and later output will go to the file.
+ */
+bool OutputSink::open(const std::string& fileName)
+{
+   int newDescriptor = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+                              0644);
+   if ( newDescriptor < 0 )
+      return false;
+
+   flush();
+   if ( ownsDescriptor )
+      ::close(fileDescriptor);
+   fileDescriptor = newDescriptor;
+   ownsDescriptor = true;
+   return true;
+}
+
+/**
+ Writes a string to the sink.
+ @param text The characters to write.
+ @return The OutputSink, allowing writes to be chained.
+ @pre None.
+ @post The characters will be added to the buffer, which is flushed first if they do not fit.
+ */
+OutputSink& OutputSink::write(std::string_view text)
+{
+   if ( buffer.size() + text.size() > capacity )
+   {
+      flush();
+      //too long to collect, pass it on directly
+      if ( text.size() > capacity )
+      {
+         writeThrough(text);
+         return *this;
+      }
+   }
+   buffer.append(text.data(), text.size());
+   return *this;
+}
+
+/**
+ Writes a character to the sink.
+ @param character The character to write.
+ @return The OutputSink, allowing writes to be chained.
+ @pre None.
+ @post The character will be added to the buffer, which is flushed first if it is full.
+ */
+OutputSink& OutputSink::write(char character)
+{
+   return write(std::string_view(&character, 1));
+}
+
+/**
+ Writes the contents of an output buffer to the sink.
+ @param formatted The buffer to write.
+ @return The OutputSink, allowing writes to be chained.
+ @pre None.
+ @post The buffer's characters will be added to the sink. The buffer will not be cleared.
+ */
+OutputSink& OutputSink::write(const OutputBuffer& formatted)
+{
+   return write(formatted.view());
+}
+
+/**
+ Passes the buffered characters to the operating system.
+ @pre None.
+ @post The buffer will be empty. Characters that could not be written are dropped.
+ */
+void OutputSink::flush()
+{
+   if ( buffer.empty() )
+      return;
+   writeThrough(buffer);
+   buffer.clear();
+}
+
+/**
+ Marks the end of a command's output.
+ @pre None.
+ @post The buffer will be flushed if the sink flushes after every command.
+ */
+void OutputSink::endCommand()
+{
+   if ( flushEachCommand )
+      flush();
+}
+
+/**
+ Sets whether the sink flushes at the end of every command.
+ @param enabled True to flush in endCommand. False to flush only when the buffer is full.
+ @pre None.
+ @post endCommand will flush the buffer if enabled is true.
+ */
+void OutputSink::setFlushEachCommand(bool enabled)
+{
+   flushEachCommand = enabled;
+}
+
+/**
+ Writes characters to the file descriptor.
+ @param text The characters to write.
+ @pre None.
+ @post The characters will have been written, retrying partial and interrupted writes, unless the
+ descriptor reports an error.
+ */
+void OutputSink::writeThrough(std::string_view text)
+{
+   while ( !text.empty() )
+   {
+      ssize_t written = ::write(fileDescriptor, text.data(), text.size());
+      if ( written < 0 )
+      {
+         if ( errno == EINTR )
+            continue;
+         return;
+      }
+      text.remove_prefix(written);
+   }
+}
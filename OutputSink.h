@@ -0,0 +1,122 @@
+/*
+ file name: OutputSink.h
+ author: Hall, Ashley
+ The OutputSink class is the destination of the store's reports or error
+ messages. Text written to a sink is collected in a large buffer and passed
+ to the operating system with one write call when the buffer fills, when the
+ sink is flushed, and when it is destroyed, so output redirected to a file or
+ pipe does not cost a system call per line. A sink writes to standard output,
+ standard error, or a file it opens. A sink with a capacity of 0 writes every
+ call straight through, in the same way std::cerr does, and a sink can be set
+ to flush at the end of every command for interactive use.
+ */
+
+#ifndef OUTPUTSINK_H
+#define OUTPUTSINK_H
+
+#include <string>
+#include <string_view>
+
+#include "OutputBuffer.h"
+
+class OutputSink
+{
+public:
+
+   /**
+    OutputSink constructor.
+    @param fileDescriptor The open file descriptor to write to, such as STDOUT_FILENO.
+    @param capacity The number of characters collected before they are written. 0 writes every call
+    straight through.
+    @pre fileDescriptor must be open for writing.
+    @post A sink writing to fileDescriptor will be created. The descriptor is not closed by the sink.
+    */
+   explicit OutputSink(int fileDescriptor, std::size_t capacity);
+
+   /**
+    OutputSink destructor. Flushes the buffer and closes a file opened by the sink.
+    @pre None.
+    @post Every character written to the sink will have been passed to the operating system.
+    */
+   virtual ~OutputSink();
+
+   OutputSink(const OutputSink&) = delete;
+   OutputSink& operator=(const OutputSink&) = delete;
+
+   /**
+    Redirects the sink to a file.
+    @param fileName The name of the file. It is created or truncated.
+    @return True if the file was opened. False otherwise, and the sink is unchanged.
+    @pre None.
+    @post The buffer will be flushed to the previous destination and later output will go to the file.
+    */
+   bool open(const std::string& fileName);
+
+   /**
+    Writes a string to the sink.
+    @param text The characters to write.
+    @return The OutputSink, allowing writes to be chained.
+    @pre None.
+    @post The characters will be added to the buffer, which is flushed first if they do not fit.
+    */
+   OutputSink& write(std::string_view text);
+
+   /**
+    Writes a character to the sink.
+    @param character The character to write.
+    @return The OutputSink, allowing writes to be chained.
+    @pre None.
+    @post The character will be added to the buffer, which is flushed first if it is full.
+    */
+   OutputSink& write(char character);
+
+   /**
+    Writes the contents of an output buffer to the sink.
+    @param formatted The buffer to write.
+    @return The OutputSink, allowing writes to be chained.
+    @pre None.
+    @post The buffer's characters will be added to the sink. The buffer will not be cleared.
+    */
+   OutputSink& write(const OutputBuffer& formatted);
+
+   /**
+    Passes the buffered characters to the operating system.
+    @pre None.
+    @post The buffer will be empty. Characters that could not be written are dropped.
+    */
+   void flush();
+
+   /**
+    Marks the end of a command's output.
+    @pre None.
+    @post The buffer will be flushed if the sink flushes after every command.
+    */
+   void endCommand();
+
+   /**
+    Sets whether the sink flushes at the end of every command.
+    @param enabled True to flush in endCommand. False to flush only when the buffer is full.
+    @pre None.
+    @post endCommand will flush the buffer if enabled is true.
+    */
+   void setFlushEachCommand(bool enabled);
+
+private:
+
+   /**
+    Writes characters to the file descriptor.
+    @param text The characters to write.
+    @pre None.
+    @post The characters will have been written, retrying partial and interrupted writes, unless the
+    descriptor reports an error.
+    */
+   void writeThrough(std::string_view text);
+
+   int fileDescriptor; //descriptor written to
+   bool ownsDescriptor; //true if the sink opened fileDescriptor
+   std::size_t capacity; //characters collected before writing
+   bool flushEachCommand; //true if endCommand flushes
+   std::string buffer; //characters waiting to be written
+};
+
+#endif
@@ -15,12 +15,28 @@
 #ifndef SearchTree_h
 #define SearchTree_h
 
+#include <algorithm>
 #include <iostream>
 
+#include "OutputBuffer.h"
+#include "Trace.h"
+
 
 template<typename Comparable>
 class SearchTree
 {
+public:
+   
+   /*
+    One item looked up by retrieveCounts and the result of the lookup.
+    */
+   struct CountQuery
+   {
+      const Comparable* item; //the item to look up
+      bool found; //set to true if the item is in the tree
+      int itemCount; //set to the item's number of occurrences if it was found
+   };
+   
 private:
    
    struct TreeNode
@@ -33,6 +49,9 @@ private:
    
    TreeNode* root; //pointer to the root node
    
+   //incremented whenever an item is added or removed or a count changes
+   unsigned long long version;
+   
    /**
     Creates a deep copy of each node in the given SearchTree object.
     @param origTreePtr The TreeNode pointer to the root of the original tree.
@@ -134,50 +153,132 @@ private:
    }
    
    /**
-    Helper method to output the SearchTree to the console.
+    Helper method to write the SearchTree into an output buffer.
     @param treePtr The TreeNode pointer to the root of the tree or subtree.
+    @param buffer The buffer to write to.
     @pre treePtr must be a pointer to a TreeNode.
-    @post Displays each Comparable item in the SearchTree and the number of occurrences
-    of that item. Each item is printed on one line followed by its number of occurrences separated
-    by a space. If the SearchTree is empty nothing is displayed.
+    @post Appends each Comparable item in the SearchTree and the number of occurrences
+    of that item to the buffer. Each item is written on one line followed by its number of occurrences.
+    If the SearchTree is empty nothing is written.
     */
-   void printHelper( TreeNode* treePtr, std::ostream& outputStream ) const
+   void formatHelper( TreeNode* treePtr, OutputBuffer& buffer ) const
    {
       //if tree is not empty
       if ( treePtr != nullptr )
       {
          //recursively traverse the left subtree
-         printHelper( treePtr->leftChildPtr, outputStream );
+         formatHelper( treePtr->leftChildPtr, buffer );
          
-         //print the item and item count, separated by a space
-         outputStream << *treePtr->item << "; Count: " << treePtr->itemCount << std::endl;
+         //write the item and item count
+         treePtr->item->format( buffer );
+         buffer.append( "; Count: " ).appendInt( treePtr->itemCount )
+            .append( '\n' );
          
          //recursively traverse the right subtree
-         printHelper( treePtr->rightChildPtr, outputStream );
+         formatHelper( treePtr->rightChildPtr, buffer );
       }
    }
    
    /**
-    Helper method to output items in the SearchTree to the console.
+    Helper method to write items in the SearchTree into an output buffer.
     @param treePtr The TreeNode pointer to the root of the tree or subtree.
+    @param buffer The buffer to write to.
     @pre treePtr must be a pointer to a TreeNode.
-    @post Displays each Comparable item in the SearchTree and omits the number of occurrences
-    of that item. Each item is printed on one line. If the SearchTree is empty nothing is displayed.
+    @post Appends each Comparable item in the SearchTree to the buffer and omits the number of
+    occurrences of that item. If the SearchTree is empty nothing is written.
     */
-   void printWithoutCountsHelper( TreeNode* treePtr ) const
+   void formatWithoutCountsHelper( TreeNode* treePtr, OutputBuffer& buffer ) const
    {
       //if tree is not empty
       if ( treePtr != nullptr )
       {
          //recursively traverse the left subtree
-         printWithoutCountsHelper( treePtr->leftChildPtr );
+         formatWithoutCountsHelper( treePtr->leftChildPtr, buffer );
          
-         //print the item and item count, separated by a space
-         std::cout << *treePtr->item;
+         //write the item
+         treePtr->item->format( buffer );
          
          //recursively traverse the right subtree
-         printWithoutCountsHelper( treePtr->rightChildPtr );
+         formatWithoutCountsHelper( treePtr->rightChildPtr, buffer );
+      }
+   }
+   
+   /**
+    Helper method to visit, in order, the items in the SearchTree that are not less than a lower bound.
+    @param treePtr The TreeNode pointer to the root of the tree or subtree.
+    @param lowerBound The Comparable that visited items must not be less than.
+    @param visit The function called with each visited item. Returns false to stop the traversal.
+    @return False if visit stopped the traversal. True otherwise.
+    @pre treePtr must be a pointer to a TreeNode.
+    @post visit will be called in order with each item not less than lowerBound until it returns false.
+    Subtrees holding only items less than lowerBound are not entered.
+    */
+   template<typename Visitor>
+   bool visitFromHelper( TreeNode* treePtr, const Comparable& lowerBound,
+                        Visitor& visit ) const
+   {
+      //the tree or subtree is empty
+      if ( treePtr == nullptr )
+         return true;
+      
+      //the left subtree and the node can only hold items in range if the
+      //node's item is not less than the lower bound
+      if ( !(*treePtr->item < lowerBound) )
+      {
+         if ( !visitFromHelper( treePtr->leftChildPtr, lowerBound, visit ) )
+            return false;
+         if ( !visit( *treePtr->item ) )
+            return false;
       }
+      
+      //recursively traverse the right subtree
+      return visitFromHelper( treePtr->rightChildPtr, lowerBound, visit );
+   }
+   
+   /**
+    Helper method to visit every node of the SearchTree, each node before its subtrees.
+    @param treePtr The TreeNode pointer to the root of the tree or subtree.
+    @param visit The function called with each node's item, item count, and which children it has.
+    @pre treePtr must be a pointer to a TreeNode.
+    @post visit will be called with each node in the subtree, the node first, then its left subtree,
+    then its right subtree.
+    */
+   template<typename Visitor>
+   void visitPreorderHelper( TreeNode* treePtr, Visitor& visit ) const
+   {
+      if ( treePtr == nullptr )
+         return;
+      visit( *treePtr->item, treePtr->itemCount,
+             treePtr->leftChildPtr != nullptr, treePtr->rightChildPtr != nullptr );
+      visitPreorderHelper( treePtr->leftChildPtr, visit );
+      visitPreorderHelper( treePtr->rightChildPtr, visit );
+   }
+   
+   /**
+    Helper method to build a subtree from nodes given in pre-order.
+    @param treePtr The pointer that receives the root of the subtree.
+    @param next The function returning the next node's item, item count, and which children it has.
+    @return True if every node of the subtree was supplied. False if next failed.
+    @pre treePtr must be nullptr.
+    @post The nodes will be linked in the shape described by next without comparing any items. Nodes
+    built before a failure stay in the tree so they are deleted with it.
+    */
+   template<typename Source>
+   bool buildPreorderHelper( TreeNode*& treePtr, Source& next )
+   {
+      Comparable* itemPtr;
+      int itemCount;
+      bool hasLeft;
+      bool hasRight;
+      if ( !next( itemPtr, itemCount, hasLeft, hasRight ) )
+         return false;
+      treePtr = new TreeNode;
+      treePtr->item = itemPtr;
+      treePtr->itemCount = itemCount;
+      treePtr->leftChildPtr = nullptr;
+      treePtr->rightChildPtr = nullptr;
+      return ( !hasLeft || buildPreorderHelper( treePtr->leftChildPtr, next ) )
+         && ( !hasRight || buildPreorderHelper( treePtr->rightChildPtr, next ) );
    }
    
    /**
@@ -359,6 +460,74 @@ private:
          return removeHelper( root->rightChildPtr, itemToRemove );
    }
    
+   /**
+    Looks up a sorted range of items in a subtree, following each search path only once.
+    @param treePtr The pointer to the root of the subtree.
+    @param first The first query of the range.
+    @param last The query after the last query of the range.
+    @pre The items of the queries must be sorted in ascending order with no two equal.
+    @post Each query's found and itemCount will be set from the node holding an equal item, if any.
+    */
+   void retrieveCountsHelper( TreeNode* treePtr, CountQuery* first,
+                              CountQuery* last ) const
+   {
+      //no queries left in this subtree
+      if ( first == last )
+         return;
+      //the subtree is empty, none of the items are in it
+      if ( treePtr == nullptr )
+      {
+         for ( CountQuery* query = first; query != last; query++ )
+         {
+            query->found = false;
+            query->itemCount = 0;
+         }
+         return;
+      }
+      
+      //the queries before middle belong to the left subtree
+      CountQuery* middle = std::lower_bound( first, last, treePtr->item,
+         []( const CountQuery& query, const Comparable* nodeItem )
+         {
+            return *query.item < *nodeItem;
+         } );
+      retrieveCountsHelper( treePtr->leftChildPtr, first, middle );
+      
+      //the query at middle may match this node
+      if ( middle != last && *middle->item == *treePtr->item )
+      {
+         middle->found = true;
+         middle->itemCount = treePtr->itemCount;
+         middle++;
+      }
+      
+      //the remaining queries belong to the right subtree
+      retrieveCountsHelper( treePtr->rightChildPtr, middle, last );
+   }
+   
+   /**
+    Removes the node holding an item from a subtree, whatever its number of occurrences.
+    @param treePtr The pointer to the root of the subtree.
+    @param itemToRemove The Comparable to remove.
+    @return True if the node was found and removed. False otherwise.
+    @pre None.
+    @post The node holding an item equal to itemToRemove will be deleted along with its item.
+    */
+   bool removeAllHelper( TreeNode*& treePtr, const Comparable& itemToRemove )
+   {
+      if ( treePtr == nullptr )
+         return false;
+      else if ( itemToRemove == *treePtr->item )
+      {
+         deleteNode( treePtr );
+         return true;
+      }
+      else if ( itemToRemove < *treePtr->item )
+         return removeAllHelper( treePtr->leftChildPtr, itemToRemove );
+      else
+         return removeAllHelper( treePtr->rightChildPtr, itemToRemove );
+   }
+   
    /**
     Deletes a node in the tree.
     @param treeNode The pointer to the node to be removed.
@@ -562,7 +731,7 @@ public:
     @pre None.
     @post An empty SearchTree object will be instantiated, and its root will be initialized to nullptr.
     */
-   SearchTree() : root(nullptr) {};
+   SearchTree() : root(nullptr), version(0) {};
    
    /**
     The copy constructor.
@@ -571,7 +740,7 @@ public:
     @pre The parameter tree must be a SearchTree object.
     @post A deep copy of the SearchTree object passed in as the argument will be created.
     */
-   SearchTree( const SearchTree& tree )
+   SearchTree( const SearchTree& tree ) : version(0)
    {
       root = copyTree( tree.root );
    }
@@ -608,6 +777,7 @@ public:
          
          //copy nodes from right hand tree to left hand tree
          root = copyTree(rightTree.root);
+         version++;
       }
       
       //return a copy of the right hand tree
@@ -669,13 +839,28 @@ public:
       //if tree is not empty
       if ( outputSearchTree.root != nullptr )
       {
-         //print the contents using an inorder traversal
-         outputSearchTree.printHelper(outputSearchTree.root, outputStream);
+         //format the contents using an inorder traversal and write them
+         //with one call
+         OutputBuffer buffer;
+         outputSearchTree.formatHelper(outputSearchTree.root, buffer);
+         buffer.writeTo(outputStream);
       }
       
       return outputStream;
    }
    
+   /**
+    Writes the items in the SearchTree and their counts into an output buffer.
+    @param buffer The buffer to write to.
+    @pre None
+    @post Each item in the SearchTree and the number of occurrences of that item will be appended
+    to the buffer in order, one item per line. If the tree is empty, nothing will be written.
+    */
+   void format( OutputBuffer& buffer ) const
+   {
+      formatHelper(root, buffer);
+   }
+   
    /**
     Prints the items in the SearchTree. Omits their counts.
     @pre None
@@ -683,11 +868,69 @@ public:
     */
    void printWithoutCounts() const
    {
-      printWithoutCountsHelper(root);
+      OutputBuffer buffer;
+      formatWithoutCountsHelper(root, buffer);
+      buffer.writeTo(std::cout);
+   }
+   
+   /**
+    Writes the items in the SearchTree into an output buffer. Omits their counts.
+    @param buffer The buffer to write to.
+    @pre None
+    @post Items in the SearchTree will be appended to the buffer in order. If the tree is empty,
+    nothing will be written.
+    */
+   void formatWithoutCounts( OutputBuffer& buffer ) const
+   {
+      formatWithoutCountsHelper(root, buffer);
    }
    
    
    
+   /**
+    Visits, in order, the items in the SearchTree that are not less than a lower bound.
+    @param lowerBound The Comparable that visited items must not be less than.
+    @param visit The function called with each visited item. Returns false to stop the traversal.
+    @pre visit must accept a const Comparable& and return a bool.
+    @post visit will be called in order with each item not less than lowerBound until it returns false.
+    The traversal costs O(h + k) for a tree of height h when k items are visited.
+    */
+   template<typename Visitor>
+   void visitFrom( const Comparable& lowerBound, Visitor visit ) const
+   {
+      visitFromHelper( root, lowerBound, visit );
+   }
+   
+   /**
+    Visits every item in the SearchTree, each node before its subtrees.
+    @param visit The function called with each item, its number of occurrences, and whether its node
+    has a left and a right child.
+    @pre visit must accept a const Comparable&, an int, and two bools.
+    @post visit will be called once for every node. Passing the nodes in the order they are visited to
+    buildPreorder rebuilds a tree of the same shape.
+    */
+   template<typename Visitor>
+   void visitPreorder( Visitor visit ) const
+   {
+      visitPreorderHelper( root, visit );
+   }
+   
+   /**
+    Builds the SearchTree from nodes given in pre-order, as visitPreorder visits them.
+    @param next The function called for each node. It sets the node's item, item count, and whether
+    the node has a left and a right child, and returns false if no node can be supplied.
+    @return True if the tree was built. False if next failed.
+    @pre The tree must be empty and the nodes must be in the order of a search tree.
+    @post The tree will take ownership of the items and have the shape described by next. The nodes
+    are linked directly, so building n nodes costs O(n) without comparing any items.
+    */
+   template<typename Source>
+   bool buildPreorder( Source next )
+   {
+      version++;
+      return buildPreorderHelper( root, next );
+   }
+   
    /**
     Inserts a Comparable into the SearchTree. If the Comparable is already in the tree, the number of
     occurrences for that Comparable will be incremented.
@@ -705,11 +948,15 @@ public:
     */
    bool insert( Comparable* itemPtr )
    {
+      TRACE_SPAN("tree insert");
+      version++;
       return insertHelper( root, itemPtr );
    }
    
    bool insert( Comparable* itemPtr, int numItems )
    {
+      TRACE_SPAN("tree insert");
+      version++;
       return insertHelper( root, itemPtr, numItems );
    }
    
@@ -728,7 +975,63 @@ public:
     */
    bool remove( const Comparable& itemToRemove )
    {
-      return removeHelper( root, itemToRemove);
+      TRACE_SPAN("tree remove");
+      if ( !removeHelper( root, itemToRemove) )
+         return false;
+      version++;
+      return true;
+   }
+   
+   /**
+    Removes every occurrence of a Comparable from the tree.
+    @param itemToRemove The Comparable item to be removed from the tree.
+    @return True if the Comparable was removed from the tree. False if it was not found.
+    @pre None.
+    @post If the Comparable is found its node will be removed from the tree whatever its item count,
+    and true will be returned. Otherwise false will be returned and the tree will not change.
+    */
+   bool removeAll( const Comparable& itemToRemove )
+   {
+      TRACE_SPAN("tree remove");
+      if ( !removeAllHelper( root, itemToRemove ) )
+         return false;
+      version++;
+      return true;
+   }
+   
+   /**
+    Sets the number of occurrences of a Comparable in the tree.
+    @param item The Comparable whose count will be set.
+    @param numItems The new number of occurrences.
+    @return True if the Comparable was found. False otherwise.
+    @pre None.
+    @post If the Comparable is found its item count will be set to numItems and true will be
+    returned. The tree's structure will not change, even if numItems is less than 1.
+    */
+   bool setCount( const Comparable& item, int numItems )
+   {
+      TRACE_SPAN("tree setCount");
+      TreeNode* treeNode = findNode( root, item );
+      if ( treeNode == nullptr )
+         return false;
+      treeNode->itemCount = numItems;
+      version++;
+      return true;
+   }
+   
+   /**
+    Looks up the number of occurrences of several Comparables in one pass over the tree.
+    @param queries The items to look up.
+    @param queryCount The number of queries.
+    @pre The items of the queries must be sorted in ascending order with no two equal.
+    @post Each query's found will be set to whether its item is in the tree and, if it is, its
+    itemCount will be set to the item's number of occurrences. Every node on the search paths
+    of the items is visited once, rather than once per item.
+    */
+   void retrieveCounts( CountQuery* queries, std::size_t queryCount ) const
+   {
+      TRACE_SPAN("tree retrieveCounts");
+      retrieveCountsHelper( root, queries, queries + queryCount );
    }
    
    /**
@@ -741,6 +1044,7 @@ public:
    void makeEmpty()
    {
       makeEmptyHelper( root );
+      version++;
    }
    
    /**
@@ -753,6 +1057,7 @@ public:
     */
    const Comparable* retrieve( const Comparable& itemToRetrieve ) const
    {
+      TRACE_SPAN("tree retrieve");
       //find the node containing the desired Comparable
       TreeNode* treeNode = findNode( root, itemToRetrieve );
       //if the node was found
@@ -807,6 +1112,17 @@ public:
       return root == nullptr;
    }
    
+   /**
+    Returns the tree's version number.
+    @pre None.
+    @post A number that changes whenever an item is inserted or removed or an item count is changed
+    will be returned. Output formatted from the tree is current while the version is unchanged.
+    */
+   unsigned long long getVersion() const
+   {
+      return version;
+   }
+   
 };
 
 
@@ -21,25 +21,117 @@ SportsCard::SportsCard()
 SportsCard::~SportsCard() {}
 
 /**
- Sets the data members of a SportsCard object to elements in the 'data' vector.
- @pre The elements in the 'data' vector must contain appropriate data and the vector must contain at
- least four elements.
+ Sets the data members of a SportsCard object to the fields in 'data'.
+ @pre The fields in 'data' must contain appropriate data and there must be at least four fields.
  @post The data members 'year', 'grade',  'player' , and 'manufacturer' will be set to the values in
  data[0], data[1],  data[2], and data[3], respectively.
  */
-bool SportsCard::setData(const std::vector<std::string>& data)
+bool SportsCard::setData(const FieldSpan& data)
 {
-   if ( !isValidYear(data[YEAR]) || !validDataVector(data, DATA_LENGTH))
+   int yearValue;
+   if ( !validDataVector(data, DATA_LENGTH) || !parseYear(data[YEAR], yearValue))
    {
       return false;
    }
-   year = stoi(data[YEAR]);
-   grade = data[GRADE];
-   player = data[PLAYER];
-   manufacturer = data[MANUFACTURER];
+   year = yearValue;
+   grade.assign(data[GRADE]);
+   player.assign(data[PLAYER]);
+   manufacturer.assign(data[MANUFACTURER]);
    return true;
 }
 
+/**
+ Returns the number of fields setData reads.
+ @pre None.
+ @post Four, the number of fields of a SportsCard object, will be returned.
+ */
+int SportsCard::getFieldCount() const
+{
+   return DATA_LENGTH;
+}
+
+/**
+ Writes the SportsCard object's data fields into an output buffer in the order setData reads them.
+ @param buffer The buffer to write to.
+ @pre None.
+ @post The year, grade, player, and manufacturer will be appended to the buffer, separated by
+ commas, so that splitting the text and passing the fields to setData recreates the object.
+ */
+void SportsCard::formatData(OutputBuffer& buffer) const
+{
+   buffer.appendInt(year).append(", ").append(grade).append(", ")
+      .append(player).append(", ").append(manufacturer);
+}
+
+/**
+ Writes the SportsCard object's data fields in binary form for a store snapshot.
+ @param writer The writer to append the fields to.
+ @pre None.
+ @post The year, grade, player, and manufacturer will be appended in the order readData reads them.
+ */
+void SportsCard::writeData(BinaryWriter& writer) const
+{
+   writer.putInt(year);
+   writer.putString(grade);
+   writer.putString(player);
+   writer.putString(manufacturer);
+}
+
+/**
+ Sets the data members of a SportsCard object to the fields written by writeData.
+ @param reader The reader positioned at the fields.
+ @return True if every field could be read. False if the bytes ended first.
+ @pre The fields must have been written by SportsCard::writeData.
+ @post The year, grade, player, and manufacturer will be set and the reader advanced past them.
+ */
+bool SportsCard::readData(BinaryReader& reader)
+{
+   std::int32_t yearValue;
+   std::string_view gradeField;
+   std::string_view playerField;
+   std::string_view manufacturerField;
+   if ( !reader.getInt(yearValue) || !reader.getString(gradeField)
+       || !reader.getString(playerField) || !reader.getString(manufacturerField) )
+      return false;
+   year = yearValue;
+   grade.assign(gradeField);
+   player.assign(playerField);
+   manufacturer.assign(manufacturerField);
+   return true;
+}
+
+/**
+ Allocates memory for a SportsCard object from the calling thread's SportsCard object pool.
+ @param size The size of the object being allocated.
+ @return A pointer to memory for the object.
+ @pre None.
+ @post Memory recycled from a previously deleted SportsCard will be returned when available. Objects of
+ classes derived from SportsCard are allocated by the global allocator.
+ */
+void* SportsCard::operator new(std::size_t size)
+{
+   if ( size != sizeof(SportsCard) )
+      return ::operator new(size);
+   return ObjectPool<SportsCard>::allocate();
+}
+
+/**
+ Returns the memory for a SportsCard object to the SportsCard object pool it was allocated from.
+ @param memory The memory of the destroyed object.
+ @param size The size of the destroyed object.
+ @pre memory must have been allocated by SportsCard::operator new.
+ @post The memory will be available to the next SportsCard allocation.
+ */
+void SportsCard::operator delete(void* memory, std::size_t size)
+{
+   if ( size != sizeof(SportsCard) )
+   {
+      ::operator delete(memory);
+      return;
+   }
+   ObjectPool<SportsCard>::deallocate(memory);
+}
+
 /**
  Returns a pointer to a SportsCard object.
  @pre None
@@ -50,6 +142,16 @@ Collectible* SportsCard::create() const
    return new SportsCard;
 }
 
+/**
+ Returns a pointer to a copy of the SportsCard object.
+ @pre None
+ @post A SportsCard object holding the same data will be created and a pointer to it will be returned.
+ */
+Collectible* SportsCard::clone() const
+{
+   return new SportsCard(*this);
+}
+
 /**
  Determines if two SportsCard objects are equal.
  @pre The operands must be of type SportsCard.
@@ -145,13 +247,13 @@ bool SportsCard::operator>( const Comparable& rhsComparable ) const
 
 
 /**
- Returns the SportsCard object's player, year, manufacturer, and grade as a string.
- @return The string containing the SportsCard object's data.
- @pre None.
- @post The string containing the SportsCard object's data will be returned.
+ Writes the SportsCard object's player, year, manufacturer, and grade into an output buffer.
+ @param buffer The buffer to write to.
+ @pre buffer must be an OutputBuffer object.
+ @post The SportsCard object's data will be appended to the buffer, separated by commas.
  */
-std::string SportsCard::toString() const
+void SportsCard::format(OutputBuffer& buffer) const
 {
-   return player + ", " + std::to_string(year) + ", "
-   + manufacturer + ", " + grade;
+   buffer.append(player).append(", ").appendInt(year).append(", ")
+      .append(manufacturer).append(", ").append(grade);
 }
@@ -9,6 +9,7 @@
 #define SPORTSCARD_H
 
 #include "Collectible.h"
+#include "ObjectPool.h"
 
 class SportsCard : public Collectible
 {
@@ -24,14 +25,65 @@ public:
    virtual ~SportsCard();
    
    /**
-    Sets the data members of a SportsCard object to elements in the 'data' vector.
-    @pre The elements in the 'data' vector must contain appropriate data and the vector must contain at
-    least four elements.
+    Sets the data members of a SportsCard object to the fields in 'data'.
+    @pre The fields in 'data' must contain appropriate data and there must be at least four fields.
     @post The data members 'player', 'year',  'manufacturer' , and 'grade' will be set to the values in
     data[0], data[1],  data[2], and data[3], respectively.
     */
-   virtual bool setData(const std::vector<std::string>& data);
+   virtual bool setData(const FieldSpan& data);
    
+   /**
+    Returns the number of fields setData reads.
+    @pre None.
+    @post Four, the number of fields of a SportsCard object, will be returned.
+    */
+   virtual int getFieldCount() const;
+   
+   /**
+    Writes the SportsCard object's data fields into an output buffer in the order setData reads them.
+    @param buffer The buffer to write to.
+    @pre None.
+    @post The year, grade, player, and manufacturer will be appended to the buffer, separated by
+    commas, so that splitting the text and passing the fields to setData recreates the object.
+    */
+   virtual void formatData(OutputBuffer& buffer) const;
+   
+   /**
+    Writes the SportsCard object's data fields in binary form for a store snapshot.
+    @param writer The writer to append the fields to.
+    @pre None.
+    @post The year, grade, player, and manufacturer will be appended in the order readData reads them.
+    */
+   virtual void writeData(BinaryWriter& writer) const;
+   
+   /**
+    Sets the data members of a SportsCard object to the fields written by writeData.
+    @param reader The reader positioned at the fields.
+    @return True if every field could be read. False if the bytes ended first.
+    @pre The fields must have been written by SportsCard::writeData.
+    @post The year, grade, player, and manufacturer will be set and the reader advanced past them.
+    */
+   virtual bool readData(BinaryReader& reader);
+   
+   
+   /**
+    Allocates memory for a SportsCard object from the calling thread's SportsCard object pool.
+    @param size The size of the object being allocated.
+    @return A pointer to memory for the object.
+    @pre None.
+    @post Memory recycled from a previously deleted SportsCard will be returned when available. Objects of
+    classes derived from SportsCard are allocated by the global allocator.
+    */
+   static void* operator new(std::size_t size);
+   
+   /**
+    Returns the memory for a SportsCard object to the SportsCard object pool it was allocated from.
+    @param memory The memory of the destroyed object.
+    @param size The size of the destroyed object.
+    @pre memory must have been allocated by SportsCard::operator new.
+    @post The memory will be available to the next SportsCard allocation.
+    */
+   static void operator delete(void* memory, std::size_t size);
    
    /**
     Returns a pointer to a SportsCard object.
@@ -40,6 +92,13 @@ public:
     */
    virtual Collectible* create() const;
    
+   /**
+    Returns a pointer to a copy of the SportsCard object.
+    @pre None
+    @post A SportsCard object holding the same data will be created and a pointer to it will be returned.
+    */
+   virtual Collectible* clone() const;
+   
    /**
     Determines if two SportsCard objects are equal.
     @pre The operands must be of type SportsCard.
@@ -79,12 +138,12 @@ protected:
    //protected methods
    
    /**
-    Returns the SportsCard object's player, year, manufacturer, and grade as a string.
-    @return The string containing the SportsCard object's data.
-    @pre None.
-    @post The string containing the SportsCard object's data will be returned.
+    Writes the SportsCard object's player, year, manufacturer, and grade into an output buffer.
+    @param buffer The buffer to write to.
+    @pre buffer must be an OutputBuffer object.
+    @post The SportsCard object's data will be appended to the buffer, separated by commas.
     */
-   virtual std::string toString() const;
+   virtual void format(OutputBuffer& buffer) const;
    
    
    //protected data members
@@ -0,0 +1,139 @@
+/*
+ file name: SpscQueue.h
+ author: Hall, Ashley
+ description:
+ The SpscQueue class is a bounded first-in first-out queue shared by exactly
+ one producer thread and one consumer thread. The slots form a ring buffer
+ whose size is a power of two, and the two threads hand slots to each other
+ through a pair of atomic positions, so neither push nor pop takes a lock.
+ Items are built in place in their slot and the slots are reused, so an item
+ that owns memory, such as a std::string, keeps its capacity from one trip
+ around the ring to the next. A thread that finds the queue full or empty
+ spins briefly and then yields the processor until the other thread catches
+ up.
+ */
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+
+template<typename T>
+class SpscQueue
+{
+private:
+
+   //attempts before a waiting thread yields the processor
+   static const int SPIN_LIMIT = 64;
+   //keeps the positions on separate cache lines
+   static const std::size_t CACHE_LINE = 64;
+
+   std::vector<T> slots; //ring buffer of items
+   std::size_t mask; //slots.size() - 1, maps a position to its slot
+
+   //position of the next slot to pop, written only by the consumer
+   alignas(CACHE_LINE) std::atomic<std::size_t> head;
+   //position of the next slot to push, written only by the producer
+   alignas(CACHE_LINE) std::atomic<std::size_t> tail;
+
+   /**
+    Waits a little longer for the other thread.
+    @param attempts The number of times the caller has waited so far.
+    @pre None.
+    @post The thread will have spun or, after SPIN_LIMIT attempts, yielded.
+    */
+   static void pause( int& attempts )
+   {
+      if ( ++attempts > SPIN_LIMIT )
+         std::this_thread::yield();
+   }
+
+public:
+
+   /**
+    Constructs an empty SpscQueue.
+    @param capacity The number of items the queue can hold. It is rounded up to a power of two.
+    @pre capacity must be greater than 0.
+    @post An empty queue with default-constructed slots will be created.
+    */
+   explicit SpscQueue( std::size_t capacity ) : head(0), tail(0)
+   {
+      std::size_t size = 1;
+      while ( size < capacity )
+         size <<= 1;
+      slots.resize( size );
+      mask = size - 1;
+   }
+
+   SpscQueue( const SpscQueue& ) = delete;
+   SpscQueue& operator=( const SpscQueue& ) = delete;
+
+   /**
+    Returns the slot of the next item to push, waiting while the queue is full.
+    @return A reference to the slot. It holds whatever item last used it.
+    @pre Only the producer thread may call this, and endPush must be called before it is called
+    again.
+    @post The slot belongs to the producer until endPush is called.
+    */
+   T& beginPush()
+   {
+      std::size_t position = tail.load( std::memory_order_relaxed );
+      int attempts = 0;
+      while ( position - head.load( std::memory_order_acquire ) > mask )
+         pause( attempts );
+      return slots[position & mask];
+   }
+
+   /**
+    Makes the slot returned by beginPush available to the consumer.
+    @pre beginPush must have been called.
+    @post The item will be the last item in the queue.
+    */
+   void endPush()
+   {
+      tail.store( tail.load( std::memory_order_relaxed ) + 1,
+                  std::memory_order_release );
+   }
+
+   /**
+    Returns the first item of the queue, waiting while the queue is empty.
+    @return A reference to the item.
+    @pre Only the consumer thread may call this.
+    @post The item belongs to the consumer until popFront is called.
+    */
+   T& front()
+   {
+      std::size_t position = head.load( std::memory_order_relaxed );
+      int attempts = 0;
+      while ( tail.load( std::memory_order_acquire ) == position )
+         pause( attempts );
+      return slots[position & mask];
+   }
+
+   /**
+    Returns the slot of the first item to the producer.
+    @pre front must have been called.
+    @post The item's slot may be reused by the next push.
+    */
+   void popFront()
+   {
+      head.store( head.load( std::memory_order_relaxed ) + 1,
+                  std::memory_order_release );
+   }
+
+   /**
+    Returns the number of items the queue can hold.
+    @pre None.
+    @post The capacity will be returned.
+    */
+   std::size_t capacity() const
+   {
+      return slots.size();
+   }
+};
+
+#endif
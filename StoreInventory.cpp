@@ -1,34 +1,64 @@
 /*
  file name: StoreInventory.cpp
  author: Hall, Ashley
- The StoreInventory class keeps track of a store’s inventory of collectible items,
- its customers, and customer transactions. The class initializes its inventory
- and customers from an inventory file and customer file, respectively. Customer
- transactions including commands to display the inventory, display a given
- customer’s transaction history, and display transaction histories for all
- customers are processed from a third file. Customer data are stored in a
- SearchTree object and a dictionary, both containing Customer pointers.The
- store’s item inventory will be implemented with an array of SearchTree objects
- storing Collectible pointers (one tree for each Collectible subclass).
- The StoreInventory class will assume ownership for the memory of the
- allocated SearchTrees. The SearchTree class will assume ownership for the
- memory of the pointed-to Collectible objects and Customer objects.
- The Customer class will assume ownership of the memory for the transaction
- structs and Collectible objects pointed to in the Customer's transactions
- vector. The Store class will also contain the following nested classes which
- are used to execute the commands read from the third file: CommandFactory,
- StoreCommand, and StoreCommand’s subclasses.
+ The StoreInventory class keeps track of a store’s inventory of collectible
+ items, its customers, and customer transactions. The class initializes its
+ inventory and customers from an inventory file and customer file,
+ respectively. Customer transactions including commands to display the
+ inventory, display a given customer’s transaction history, and display
+ transaction histories for all customers are processed from a third file.
+ Customer data are stored in a SearchTree object and a hash index by customer
+ ID, both containing Customer pointers. The store’s item inventory will be
+ implemented with an array of SearchTree objects storing Collectible pointers
+ (one tree for each Collectible subclass). The StoreInventory class will
+ assume ownership for the memory of the allocated SearchTrees. The SearchTree
+ class will assume ownership for the memory of the pointed-to Collectible
+ objects and Customer objects. Every transaction is appended to the store's
+ TransactionLog and refers to its item by ID in the store's ItemCatalog, which
+ assumes ownership of the memory for one copy of every item traded. Lines read
+ from the input files are split into views of their comma separated entries by
+ a LineTokenizer, so the entries are not copied. Command output is written
+ through a buffered OutputSink to standard output or a file, and errors in the
+ input files through a separate sink. The buy and sell commands applied can be
+ recorded in a WriteAheadLog with periodic checkpoints of the whole store,
+ from which the store is restored after a crash. A basket command buys or
+ sells several items for one customer as a single transaction that succeeds or
+ fails as a whole. The time taken by every command and the errors it reports
+ are collected in CommandStats, shown by a stats command. The phases of
+ loading and of each command are marked with Trace spans. The Store class will
+ also contain the following nested classes which are used to execute the
+ commands read from the third file: CommandFactory, StoreCommand, and
+ StoreCommand’s subclasses.
  */
 
 #include "StoreInventory.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <iterator>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BinaryReader.h"
+#include "BinaryWriter.h"
+#include "MappedFile.h"
+#include "Trace.h"
+
 /**
  StoreInventory default constructor.
  @pre None
  @post A Store object with an empty inventory and no customers will be created. 
  */
-StoreInventory::StoreInventory() : customerDict(MAX_CUSTOMERS, nullptr),
-   inventoryTree(INVENTORY_SIZE, nullptr)
+StoreInventory::StoreInventory() : inventoryTree(INVENTORY_SIZE, nullptr),
+   transactionLog(&itemCatalog), loaderThreads(1), tradeWindow(TRADE_WINDOW),
+   tradeThreads(1), tradePool(nullptr), pipelined(false), checkpointInterval(CHECKPOINT_INTERVAL),
+   checkpointNeeded(false), commandNumber(0), lastTradeNumber(0),
+   resumeAfter(0), customersByNameVersion(NOT_FORMATTED),
+   outputSink(STDOUT_FILENO, OUTPUT_CAPACITY), errorSink(STDERR_FILENO, 0)
 {
    //create a tree to store each item type
    for ( int i = 0; i < itemSymbols.size(); i++ )
@@ -36,6 +66,10 @@ StoreInventory::StoreInventory() : customerDict(MAX_CUSTOMERS, nullptr),
       int index = hashItem(itemSymbols[i]);
       inventoryTree[index] = new SearchTree<Collectible>;
    }
+   
+   //no tree has been formatted yet
+   inventorySegments.resize(itemSymbols.size());
+   segmentVersions.assign(itemSymbols.size(), NOT_FORMATTED);
 }
 
 /**
@@ -45,6 +79,7 @@ StoreInventory::StoreInventory() : customerDict(MAX_CUSTOMERS, nullptr),
  */
 StoreInventory::~StoreInventory()
 {
+   delete tradePool;
    
    for ( int i = 0; i < inventoryTree.size(); i++ )
    {
@@ -64,53 +99,165 @@ StoreInventory::~StoreInventory()
  described in the program specification.
  @post The customerTree and customerDict will contain pointers to the same Customer
  objects created from the file input, and nodes will be indexed in the customerTree alphabetically
- by the customer's name.
+ by the customer's name. The customerDict is sized from the number of lines in the file before
+ any customer is added.
  */
 void StoreInventory::addCustomersFromFile(std::ifstream& customerFile)
 {
+   TRACE_PHASE("load customers");
    std::string line;
-   std::string entry;
-   std::vector<std::string> customerInfo;
-   const int ID = 0;
-   const int NAME = 1;
+   
+   //size the customer index for one customer per line
+   std::streampos start = customerFile.tellg();
+   std::size_t lineCount =
+      std::count(std::istreambuf_iterator<char>(customerFile),
+                 std::istreambuf_iterator<char>(), '\n');
+   customerFile.clear();
+   customerFile.seekg(start);
+   reserveCustomers(customerDict.size() + lineCount + 1);
    
    //read each line from customer file
    while( getline(customerFile, line))
+      addCustomerLine(line);
+}
+
+/**
+ Adds customers from the contents of a customer file.
+ @param contents The text of the file.
+ @pre contents contains properly formatted data as described in the program specification.
+ @post The customerTree and customerDict will hold the same customers addCustomersFromFile would add
+ for a file holding contents. The lines are parsed in place without being copied.
+ */
+void StoreInventory::addCustomersFromText(std::string_view contents)
+{
+   TRACE_PHASE("load customers");
+   
+   //size the customer index for one customer per line
+   std::size_t lineCount = std::count(contents.begin(), contents.end(), '\n');
+   reserveCustomers(customerDict.size() + lineCount + 1);
+   
+   if ( loaderThreads > 1 )
    {
-      //clear customer info of previous data
-      customerInfo.clear();
-      std::stringstream lineStream(line);
-      
-      //read each entry per line
-      while(getline(lineStream, entry, ','))
-      {
-         //erase leading space
-         if ( entry.at(0) == ' ' )
-            entry.erase(0,1);
-         //add entry to customer info
-         customerInfo.push_back(entry);
-      }
+      addCustomersInParallel(contents);
+      return;
+   }
+   
+   //read each line from the contents
+   std::size_t position = 0;
+   std::string_view line;
+   while ( LineTokenizer::nextLine(contents, position, line) )
+      addCustomerLine(line);
+}
 
-      //validate customer id and name
-      if ( isValidCustID(customerInfo[ID]) &&
-          isValidCustName(customerInfo[NAME]))
+/**
+ Adds customers from the contents of a customer file using the loader threads.
+ @param contents The text of the file.
+ @pre contents contains properly formatted data as described in the program specification.
+ @post The customers and error messages will be the same as adding the lines serially.
+ */
+void StoreInventory::addCustomersInParallel(std::string_view contents)
+{
+   std::vector<std::string_view> chunks;
+   if ( !splitForLoaders(contents, chunks) )
+   {
+      std::size_t position = 0;
+      std::string_view line;
+      while ( LineTokenizer::nextLine(contents, position, line) )
+         addCustomerLine(line);
+      return;
+   }
+   
+   //parse and validate each chunk into its own batch
+   std::vector<CustomerBatch> batches(chunks.size());
+   WorkerPool pool(loaderThreads);
+   pool.run(chunks.size(), [this, &chunks, &batches](std::size_t chunk)
       {
-         //create customer
-         Customer* customer = new Customer(customerInfo[ID],
-                                           customerInfo[NAME]);
-         
-         //add customer to dictionary
-         customerDict[stoi(customerInfo[ID])] = customer;
-         
-         //add customer to customer tree
+         LineTokenizer tokenizer;
+         std::size_t position = 0;
+         std::string_view line;
+         while ( LineTokenizer::nextLine(chunks[chunk], position, line) )
+         {
+            Customer* customer = parseCustomerLine(line, tokenizer,
+                                                   batches[chunk].errors);
+            if ( customer != nullptr )
+               batches[chunk].customers.push_back(customer);
+         }
+      });
+   
+   //apply the batches in file order
+   for ( std::size_t i = 0; i < batches.size(); i++ )
+   {
+      errorSink.write(batches[i].errors);
+      for ( std::size_t j = 0; j < batches[i].customers.size(); j++ )
+      {
+         Customer* customer = batches[i].customers[j];
+         customerDict.insert(customer->getKey(), customer);
          customerTree.insert(customer);
       }
-      else
-         std::cerr << "Invalid customer information: " << customerInfo[ID] <<
-         ", " << customerInfo[NAME]
-         << ". Could not add customer." << std::endl;
+   }
+}
+
+/**
+ Adds the customer described by one line of a customer file.
+ @param line The line, without its line break.
+ @pre None
+ @post If the line holds a valid ID and name the customer will be added to the customerTree and
+ customerDict. Otherwise an error message will be output.
+ */
+void StoreInventory::addCustomerLine(std::string_view line)
+{
+   errorBuffer.clear();
+   Customer* customer = parseCustomerLine(line, lineTokenizer, errorBuffer);
+   if ( customer != nullptr )
+   {
+      //add customer to dictionary
+      customerDict.insert(customer->getKey(), customer);
       
+      //add customer to customer tree
+      customerTree.insert(customer);
+   }
+   else
+      errorSink.write(errorBuffer);
+}
+
+/**
+ Parses one line of a customer file.
+ @param line The line, without its line break.
+ @param tokenizer The tokenizer used to split the line.
+ @param errors The buffer receiving the error message for an invalid line.
+ @return A new Customer if the line holds a valid ID and name. nullptr otherwise.
+ @pre None
+ @post The store will not be modified, so lines can be parsed on several threads at once with
+ separate tokenizers and buffers. The caller assumes ownership of the returned Customer.
+ */
+Customer* StoreInventory::parseCustomerLine(std::string_view line,
+                                            LineTokenizer& tokenizer,
+                                            OutputBuffer& errors)
+{
+   unsigned long long custKey;
+   const int ID = 0;
+   const int NAME = 1;
+   
+   //split the line into views of its entries
+   FieldSpan customerInfo = tokenizer.split(line);
+   std::string_view custID = customerInfo.size() > ID
+      ? customerInfo[ID] : std::string_view();
+   std::string_view custName = customerInfo.size() > NAME
+      ? customerInfo[NAME] : std::string_view();
+   
+   //validate customer id and name
+   if ( customerInfo.size() > NAME && parseCustID(custID, custKey) &&
+       isValidCustName(custName))
+   {
+      //create customer
+      return new Customer(std::string(custID), custKey, std::string(custName),
+                          &transactionLog);
    }
+   
+   errors.append("Invalid customer information: ").append(custID)
+      .append(", ").append(custName)
+      .append(". Could not add customer.\n");
+   return nullptr;
 }
 
 /**
@@ -120,7 +267,7 @@ void StoreInventory::addCustomersFromFile(std::ifstream& customerFile)
  @pre name must be a string.
  @post True will be returned if name only contains letters or spaces. False otherwise.
  */
-bool StoreInventory::isValidCustName(const std::string& name) const
+bool StoreInventory::isValidCustName(std::string_view name) const
 {
    //ensure that name only contains letters or spaces
    for ( int i = 0; i < name.length(); i++ )
@@ -134,16 +281,52 @@ bool StoreInventory::isValidCustName(const std::string& name) const
 }
 
 /**
- Determines whether the customer's ID number is in the range 0-999.
+ Determines whether the customer's ID is a valid unsigned 64-bit number and converts it.
  @param ID The customer's ID
+ @param key Set to the numeric value of the ID if it is valid.
  @return True if the customer's ID is valid. False otherwise.
  @pre ID must be a string.
- @post True will be returned if the ID string represents a number between 0-999. False will be
- returned otherwise.
+ @post True will be returned and key will be set if the ID string contains only digits and fits
+ in 64 bits. False will be returned otherwise.
+ */
+bool StoreInventory::parseCustID(std::string_view ID,
+                                 unsigned long long& key) const
+{
+   const char* first = ID.data();
+   const char* last = ID.data() + ID.size();
+   //from_chars rejects a leading sign, so only digits are accepted
+   std::from_chars_result result = std::from_chars(first, last, key);
+   return ID.size() > 0 && result.ec == std::errc() && result.ptr == last;
+}
+
+/**
+ Determines whether a string represents a non-negative count and converts it.
+ @param countStr The string representing the count.
+ @param count Set to the value of the count if it is valid.
+ @return True if the string represents a valid count. False otherwise.
+ @pre countStr must be a string.
+ @post True will be returned and count will be set if countStr contains only digits and fits in a
+ size_t. False will be returned otherwise.
+ */
+bool StoreInventory::parseCount(std::string_view countStr,
+                                std::size_t& count) const
+{
+   const char* first = countStr.data();
+   const char* last = countStr.data() + countStr.size();
+   std::from_chars_result result = std::from_chars(first, last, count);
+   return countStr.size() > 0 && result.ec == std::errc()
+      && result.ptr == last;
+}
+
+/**
+ Makes room for a number of customers in the customer index.
+ @param count The number of customers expected.
+ @pre None
+ @post count customers can be added without the customer index growing.
  */
-bool StoreInventory::isValidCustID(const std::string& ID) const
+void StoreInventory::reserveCustomers(std::size_t count)
 {
-   return stoi(ID) >= 0 && stoi(ID) < 1000;
+   customerDict.reserve(count);
 }
 
 
@@ -158,63 +341,209 @@ bool StoreInventory::isValidCustID(const std::string& ID) const
  */
 void StoreInventory::buildInventoryFromFile(std::ifstream& inventoryFile)
 {
+   TRACE_PHASE("load inventory");
    std::string line;
-   std::string entry;
-   std::vector<std::string> data;
-   char itemType;
-   std::string itemCount;
-   std::string garbage;
    
    //read each line from inventory file
    while( getline(inventoryFile, line))
+      addInventoryLine(line);
+}
+
+/**
+ Adds Collectible objects to the inventory from the contents of an inventory file.
+ @param contents The text of the file.
+ @pre contents contains properly formatted data as described in the program specification.
+ @post The inventory will hold the same items buildInventoryFromFile would add for a file holding
+ contents. The lines are parsed in place without being copied.
+ */
+void StoreInventory::buildInventoryFromText(std::string_view contents)
+{
+   TRACE_PHASE("load inventory");
+   
+   if ( loaderThreads > 1 )
    {
-      //clear data vector of previous entries
-      data.clear();
-      
-      std::stringstream lineStream(line);
-      
-      //get item type and item count
-      lineStream >> itemType;
-      lineStream >> garbage;
-      lineStream >> itemCount;
-      itemCount.pop_back();
-      
-      //read each entry per line
-      while(getline(lineStream, entry, ','))
-      {
-         //erase leading space
-         if ( entry.at(0) == ' ' )
-            entry.erase(0,1);
-         //add entry to data vector
-         data.push_back(entry);
-      }
-      //ensure item count is not negative
-      if ( stoi(itemCount) < 1 )
-         std::cerr << "Invalid item count."
-            << " Could not add item to inventory." << std::endl;
-      
-      //create Collectible item
-      Collectible* itemPtr = collectibleFactory.createObject(itemType);
-      
-      //item type is valid
-      if ( itemPtr != nullptr )
+      buildInventoryInParallel(contents);
+      return;
+   }
+   
+   //read each line from the contents
+   std::size_t position = 0;
+   std::string_view line;
+   while ( LineTokenizer::nextLine(contents, position, line) )
+      addInventoryLine(line);
+}
+
+/**
+ Adds Collectible objects from the contents of an inventory file using the loader threads.
+ @param contents The text of the file.
+ @pre contents contains properly formatted data as described in the program specification.
+ @post The inventory and error messages will be the same as adding the lines serially.
+ */
+void StoreInventory::buildInventoryInParallel(std::string_view contents)
+{
+   std::vector<std::string_view> chunks;
+   if ( !splitForLoaders(contents, chunks) )
+   {
+      std::size_t position = 0;
+      std::string_view line;
+      while ( LineTokenizer::nextLine(contents, position, line) )
+         addInventoryLine(line);
+      return;
+   }
+   
+   //parse, validate, and create the items of each chunk into its own batch
+   std::vector<InventoryBatch> batches(chunks.size());
+   WorkerPool pool(loaderThreads);
+   pool.run(chunks.size(), [this, &chunks, &batches](std::size_t chunk)
       {
-         //invalid data, delete item
-         if ( !itemPtr->setData(data) )
-         {
-            delete itemPtr;
-            itemPtr = nullptr;
-         }
-         else //valid data, add item to inventory
+         LineTokenizer tokenizer;
+         ParsedItem parsed;
+         std::size_t position = 0;
+         std::string_view line;
+         while ( LineTokenizer::nextLine(chunks[chunk], position, line) )
          {
-            int index = hashItem(itemType);
-            
-            inventoryTree[index]->insert(itemPtr, stoi(itemCount));
+            if ( parseInventoryLine(line, tokenizer, batches[chunk].errors,
+                                    parsed) )
+               batches[chunk].items.push_back(parsed);
          }
+      });
+   
+   //apply the batches in file order
+   for ( std::size_t i = 0; i < batches.size(); i++ )
+   {
+      errorSink.write(batches[i].errors);
+      for ( std::size_t j = 0; j < batches[i].items.size(); j++ )
+      {
+         const ParsedItem& parsed = batches[i].items[j];
+         inventoryTree[parsed.treeIndex]->insert(parsed.item,
+                                                 parsed.itemCount);
       }
    }
 }
 
+/**
+ Adds the item described by one line of an inventory file.
+ @param line The line, without its line break.
+ @pre None
+ @post If the line holds a valid item type, count, and data the item will be added to its inventory
+ tree. Otherwise an error message will be output.
+ */
+void StoreInventory::addInventoryLine(std::string_view line)
+{
+   ParsedItem parsed;
+   errorBuffer.clear();
+   bool valid = parseInventoryLine(line, lineTokenizer, errorBuffer, parsed);
+   errorSink.write(errorBuffer);
+   
+   //valid data, add item to inventory
+   if ( valid )
+      inventoryTree[parsed.treeIndex]->insert(parsed.item, parsed.itemCount);
+}
+
+/**
+ Parses one line of an inventory file.
+ @param line The line, without its line break.
+ @param tokenizer The tokenizer used to split the line.
+ @param errors The buffer receiving the error messages for the line.
+ @param parsed Set to the item, its tree, and its count if the line holds a valid item.
+ @return True if parsed holds an item to add. False otherwise.
+ @pre None
+ @post The store will not be modified, so lines can be parsed on several threads at once with
+ separate tokenizers and buffers. The caller assumes ownership of parsed.item.
+ */
+bool StoreInventory::parseInventoryLine(std::string_view line,
+                                        LineTokenizer& tokenizer,
+                                        OutputBuffer& errors,
+                                        ParsedItem& parsed) const
+{
+   const int ITEM_TYPE = 0;
+   const int ITEM_COUNT = 1;
+   const int FIRST_DATA_ELEMENT = 2;
+   
+   //split the line into views of its entries
+   FieldSpan fields = tokenizer.split(line);
+   if ( fields.size() <= ITEM_COUNT || fields[ITEM_TYPE].empty() )
+   {
+      errors.append("Invalid inventory line: ").append(line)
+         .append(". Could not add item to inventory.\n");
+      return false;
+   }
+   
+   //get item type and item count
+   char itemType = fields[ITEM_TYPE][0];
+   std::string_view countStr = fields[ITEM_COUNT];
+   int itemCount;
+   std::from_chars_result result = std::from_chars(countStr.data(),
+      countStr.data() + countStr.size(), itemCount);
+   
+   //ensure item count is a number
+   if ( result.ec != std::errc() || result.ptr != countStr.data()
+       + countStr.size() )
+   {
+      errors.append("Invalid item count. Could not add item to inventory.\n");
+      return false;
+   }
+   //ensure item count is not negative
+   if ( itemCount < 1 )
+      errors.append("Invalid item count. Could not add item to inventory.\n");
+   
+   //create Collectible item
+   Collectible* itemPtr = collectibleFactory.createObject(itemType);
+   
+   //item type is not valid
+   if ( itemPtr == nullptr )
+      return false;
+   
+   //invalid data, delete item
+   if ( !itemPtr->setData(fields.subspan(FIRST_DATA_ELEMENT)) )
+   {
+      delete itemPtr;
+      itemPtr = nullptr;
+      return false;
+   }
+   
+   parsed.item = itemPtr;
+   parsed.treeIndex = hashItem(itemType);
+   parsed.itemCount = itemCount;
+   return true;
+}
+
+/**
+ Sets the number of threads that parse customer and inventory text.
+ @param threadCount The number of threads. 1 parses on the calling thread only.
+ @pre None
+ @post addCustomersFromText and buildInventoryFromText will split text longer than one chunk into
+ line-aligned chunks, parse them on threadCount threads, and apply the results in file order. The
+ results and error messages are the same as parsing serially.
+ */
+void StoreInventory::setLoaderThreads(int threadCount)
+{
+   loaderThreads = threadCount < 1 ? 1 : threadCount;
+}
+
+/**
+ Splits text into line-aligned chunks for the loader threads.
+ @param contents The text of a file.
+ @param chunks Set to the chunks in file order.
+ @return True if there is more than one chunk. False if the text should be parsed serially.
+ @pre None
+ @post Each chunk will be at least MIN_CHUNK_LENGTH characters long except the last.
+ */
+bool StoreInventory::splitForLoaders(std::string_view contents,
+                                     std::vector<std::string_view>& chunks) const
+{
+   std::size_t chunkCount = static_cast<std::size_t>(loaderThreads)
+      * CHUNKS_PER_THREAD;
+   std::size_t maxChunks = contents.size() / MIN_CHUNK_LENGTH;
+   if ( chunkCount > maxChunks )
+      chunkCount = maxChunks;
+   if ( chunkCount < 2 )
+      return false;
+   
+   LineTokenizer::splitChunks(contents, chunkCount, chunks);
+   return chunks.size() > 1;
+}
+
 /**
  Processes store commands from a file.
  @param commandFile The file to read.
@@ -230,283 +559,1861 @@ void StoreInventory::buildInventoryFromFile(std::ifstream& inventoryFile)
 void StoreInventory::processCommandsFromFile(std::ifstream& commandFile)
 {
    std::string line;
-   std::string entry;
-   std::vector<std::string> data;
-   char command;
-   std::string garbage;
+   
+   //a new log starts from a checkpoint of the loaded store
+   if ( checkpointNeeded )
+      checkpoint();
+   
+   //read the lines on the parser thread
+   if ( pipelined )
+   {
+      processCommandsPipelined([&commandFile, &line](std::string_view& next)
+         {
+            if ( !getline(commandFile, line) )
+               return false;
+            next = line;
+            return true;
+         });
+      return;
+   }
    
    //read each line in command file
    while( getline(commandFile, line))
+      processCommandLine(line);
+   
+   //apply the trades left in the window
+   flushTrades();
+   outputSink.flush();
+}
+
+/**
+ Processes store commands from the contents of a command file.
+ @param contents The text of the file.
+ @pre contents contains properly formatted data as described in the program specification.
+ @post The commands will be executed in order with the same results as processCommandsFromFile for
+ a file holding contents. The lines are parsed in place without being copied.
+ */
+void StoreInventory::processCommandsFromText(std::string_view contents)
+{
+   //read each line from the contents
+   std::size_t position = 0;
+   std::string_view line;
+   
+   //a new log starts from a checkpoint of the loaded store
+   if ( checkpointNeeded )
+      checkpoint();
+   
+   //find the lines on the parser thread
+   if ( pipelined )
    {
-      //clear data vector of previous entries
-      data.clear();
-      
-      std::stringstream lineStream(line);
+      processCommandsPipelined([contents, &position](std::string_view& next)
+         {
+            return LineTokenizer::nextLine(contents, position, next);
+         });
+      return;
+   }
+   
+   while ( LineTokenizer::nextLine(contents, position, line) )
+      processCommandLine(line);
+   
+   //apply the trades left in the window
+   flushTrades();
+   outputSink.flush();
+}
+
+/**
+ Processes store commands as they arrive on a pipe, FIFO, or terminal.
+ @param fileDescriptor The descriptor to read the commands from.
+ @param flushEachCommand True to apply and output each command as soon as its line is read. False
+ to apply the commands of each read together, as one window of trades, and output them at once.
+ @return True if the end of the input was reached. False if a read was interrupted by a signal or
+ failed.
+ @pre None
+ @post Every complete line read will have been executed in order, with the same results as
+ processCommandsFromFile, and its output written. The time from the read that delivered each line
+ until its output was written is recorded in the stream latencies.
+ */
+bool StoreInventory::processCommandsFromStream(int fileDescriptor,
+                                               bool flushEachCommand)
+{
+   beginNewCommands();
+   
+   std::vector<char> readBuffer(STREAM_READ_SIZE);
+   std::string pending; //lines read but not yet executed
+   bool endOfInput = false;
+   
+   while ( !endOfInput )
+   {
+      ssize_t count = ::read(fileDescriptor, readBuffer.data(),
+                             readBuffer.size());
+      if ( count < 0 )
+         break;
+      std::chrono::steady_clock::time_point receivedAt =
+         std::chrono::steady_clock::now();
       
-      //read command
-      lineStream >> command;
-      lineStream >> garbage;
+      //a line without a line break waits for the next read, except the last
+      endOfInput = count == 0;
+      pending.append(readBuffer.data(), count);
+      if ( endOfInput && !pending.empty() && pending.back() != '\n' )
+         pending.push_back('\n');
       
-      //read each entry in line
-      while(getline(lineStream, entry, ','))
+      std::size_t position = 0;
+      std::size_t lineEnd;
+      std::uint64_t batchCommands = 0;
+      while ( (lineEnd = pending.find('\n', position)) != std::string::npos )
       {
-         //erase leading space
-         if ( entry.at(0) == ' ' )
-            entry.erase(0,1);
-         
-         //add entry to data
-         data.push_back(entry);
+         std::string_view line(pending.data() + position, lineEnd - position);
+         position = lineEnd + 1;
+         processCommandLine(line);
+         if ( flushEachCommand )
+         {
+            flushTrades();
+            outputSink.flush();
+            std::chrono::nanoseconds latency =
+               std::chrono::steady_clock::now() - receivedAt;
+            streamLatencies.record(latency.count());
+         }
+         else
+            batchCommands++;
       }
+      pending.erase(0, position);
       
-      //create StoreCommand object
-      StoreCommand* commandPtr = commandFactory.createCommand(command);
-      
-      //command char is valid
-      if ( commandPtr != nullptr)
+      //the commands of one read are applied and output together
+      if ( batchCommands > 0 )
       {
-         //execute command
-         commandPtr->execute(data, *this);
-
-         //delete command object
-         delete commandPtr;
-         commandPtr = nullptr;
+         flushTrades();
+         outputSink.flush();
+         std::chrono::nanoseconds latency =
+            std::chrono::steady_clock::now() - receivedAt;
+         streamLatencies.record(latency.count(), batchCommands);
       }
    }
+   
+   flushTrades();
+   outputSink.flush();
+   return endOfInput;
 }
 
 /**
- Hashes the symbol for a Collectible item to an index in the inventoryTree array.
- @param itemType The char symbol for a Collectible item.
- @return The index in the inventoryTree array.
- @pre itemType must be a char between 'A' and 'Z'.
- @post The index in the inventoryTree array will be returned as an array.
+ Returns the latencies of the commands processed by processCommandsFromStream.
+ @pre None
+ @post The histogram of the per-command latencies in nanoseconds will be returned.
  */
-int StoreInventory::hashItem(char itemType) const
+const LatencyHistogram& StoreInventory::getStreamLatencies() const
 {
-   //accepts item with symbols A-Z
-   if ( itemType < 'A' || itemType > 'Z' )
-   {
-      std::cerr << "StoreInventory::hashItem: invalid argument" << std::endl;
-      return -1;
-   }
-   //return the index of the inventoryTree containing the appropriate item
-   //types
-   return (itemType - 'A') % inventoryTree.size();
+   return streamLatencies;
 }
 
-//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/**
+ Returns the statistics of the commands processed.
+ @pre None
+ @post The latencies of each command type and the error and operation counters will be returned.
+ */
+const CommandStats& StoreInventory::getCommandStats() const
+{
+   return commandStats;
+}
 
-// COMMANDFACTORY IMPLEMENTATION
 /**
- Constructs a CommandFactory object and initializes the commandFactory array with addresses of
- subclass objects.
+ Executes one store command, for a caller that reads the command lines itself.
+ @param line The command line, without its line break.
  @pre None
- @post The commandFactory array will be initialized with addresses of subclass objects.
+ @post The command will be executed as processCommandsFromText executes its lines, except that
+ trades may wait in the window and output in the sink until finishCommands is called.
  */
-StoreInventory::CommandFactory::CommandFactory() :
-   factoryVector(FACTORY_SIZE, nullptr)
+void StoreInventory::processCommand(std::string_view line)
 {
-   factoryVector[hash('H')] = new ShowTransactHistory;
-   factoryVector[hash('B')] = new BuyItem;
-   factoryVector[hash('C')] = new ShowCustomerTransact;
-   factoryVector[hash('D')] = new DisplayInventory;
-   factoryVector[hash('S')] = new SellItem;
+   beginNewCommands();
+   processCommandLine(line);
 }
 
 /**
- Deallocates memory for objects in the commandFactory array.
+ Prepares the store for commands that are read as they arrive rather than from a command file.
  @pre None
- @post Memory for objects in commandFactory will be deallocated.
+ @post A new log will have been started from a checkpoint if one is needed. After a recovery the
+ commands will be numbered, and logged, after the last trade recovered instead of skipping the
+ command lines the earlier run applied, since new input does not repeat them.
  */
-StoreInventory::CommandFactory::~CommandFactory()
+void StoreInventory::beginNewCommands()
 {
-   for ( int i = 0; i < factoryVector.size(); i++)
+   //a new log starts from a checkpoint of the loaded store
+   if ( checkpointNeeded )
+      checkpoint();
+   
+   if ( resumeAfter > 0 )
    {
-      if ( factoryVector[i] != nullptr )
-      {
-         delete factoryVector[i];
-         factoryVector[i] = nullptr;
-      }
+      commandNumber = lastTradeNumber;
+      resumeAfter = 0;
    }
 }
 
 /**
- Returns a StoreCommand subclass object.
- @param command The char representing the command.
- @return Returns a pointer to a StoreCommand subclass object.
- @pre The itemType must hash to an index in the commandFactory array.
- @post A StoreCommand subclass object will be returned. If command does not hash to an int within the
- bounds of the command Factory array an error will be output.
+ Applies the waiting trades and writes the output of the commands passed to processCommand.
+ @pre None
+ @post Every command processed will have been applied and its output written.
  */
-StoreInventory::StoreCommand*
-StoreInventory::CommandFactory::createCommand(char command) const
+void StoreInventory::finishCommands()
 {
-   int index = hash(command);
-   //ensure the index is valid
-   if ( index < 0 )
+   flushTrades();
+   outputSink.flush();
+}
+
+/**
+ Executes the command on one line of a command file.
+ @param line The line, without its line break.
+ @pre None
+ @post The command will be executed. Blank lines and lines with an unknown command are ignored.
+ */
+void StoreInventory::processCommandLine(std::string_view line)
+{
+   const int COMMAND = 0;
+   const int FIRST_ARG = 1;
+   
+   //skip the lines an earlier run applied before it stopped
+   if ( ++commandNumber <= resumeAfter )
+      return;
+   TRACE_SPAN("command");
+   
+   //split the line into views of its entries
+   FieldSpan fields;
    {
-      std::cerr << "CollectibleFactory::createCommand: command hashed to"
-      <<" negative index" << std:: endl;
-      return nullptr;
+      TRACE_SPAN("tokenize");
+      fields = lineTokenizer.split(line);
+   }
+   
+   //skip blank lines
+   if ( fields.isEmpty() || fields[COMMAND].empty() )
+      return;
+   
+   //read command
+   char command = fields[COMMAND][0];
+   
+   //find the StoreCommand object, shared by every line of the command
+   StoreCommand* commandPtr = commandFactory.findCommand(command);
+   
+   //command char is valid
+   if ( commandPtr != nullptr)
+   {
+      TradeCommand* tradePtr = commandPtr->asTradeCommand();
+      
+      //add buy and sell commands to the window
+      if ( tradePtr != nullptr && tradeWindow > 1 )
+      {
+         queueTrade(*tradePtr, fields.subspan(FIRST_ARG));
+         if ( pendingTrades.size() >= tradeWindow )
+            flushTrades();
+      }
+      else //any other command sees the results of the waiting trades
+      {
+         flushTrades();
+         
+         //execute command on the remaining entries
+         executeCommand(*commandPtr, command, fields.subspan(FIRST_ARG));
+      }
+      outputSink.endCommand();
    }
-   //create the subclass object
-   if ( factoryVector[index] != nullptr )
-      return factoryVector[index]->create();
-   else
-      return nullptr;
 }
 
 /**
- Hashes the given itemType to an int.
- @param commandType The char symbol for the command.
- @return The int representing an index  in the CommandFactory vector.
+ Executes a command, timing it if it is not a buy or sell command.
+ @param command The command.
+ @param symbol The command's letter.
+ @param args The arguments of the command.
  @pre None
- @post The index of the CommandFactory vector where the subclass object is stored.
+ @post The command will be executed. The time and result of any command but a trade will be
+ recorded in commandStats; trades are recorded when their window is applied.
  */
-int StoreInventory::CommandFactory::hash(char commandType) const
+void StoreInventory::executeCommand(StoreCommand& command, char symbol,
+                                    const FieldSpan& args)
 {
-   if ( commandType < 'A' || commandType > 'Z' )
+   if ( command.asTradeCommand() != nullptr )
    {
-      std::cerr << "CollectibleFactory::hash: invalid argument" << std::endl;
-      return -1;
+      command.execute(args, *this);
+      return;
    }
    
-   return (commandType - 'A') % factoryVector.size();
+   TRACE_SPAN("execute");
+   std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+   bool succeeded = command.execute(args, *this);
+   std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+   commandStats.recordCommand(symbol, succeeded, elapsed.count());
 }
 
+/**
+ Sets the number of buy and sell commands applied together.
+ @param windowSize The number of consecutive buy and sell commands read before they are applied. 1
+ applies each command as it is read.
+ @pre None
+ @post Up to windowSize consecutive buy and sell commands will be applied to the inventory in a
+ merged pass per tree. Any other command applies the waiting commands first. The output and
+ transactions will be the same as applying each command as it is read.
+ */
+void StoreInventory::setTradeWindow(std::size_t windowSize)
+{
+   flushTrades();
+   tradeWindow = windowSize < 1 ? 1 : windowSize;
+}
 
-//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/**
+ Sets the number of threads that apply a window of trades.
+ @param threadCount The number of threads. 1 applies every tree on the calling thread.
+ @pre None
+ @post The buy and sell commands of a window will be applied to the different inventory trees on
+ up to threadCount threads at once. Each tree is updated by one thread only, and the output and
+ transactions are still produced in command file order, so the results will be the same as
+ applying the window on one thread.
+ */
+void StoreInventory::setTradeThreads(int threadCount)
+{
+   flushTrades();
+   tradeThreads = threadCount < 1 ? 1 : threadCount;
+   delete tradePool;
+   tradePool = nullptr;
+   if ( tradeThreads > 1 )
+      tradePool = new WorkerPool(tradeThreads);
+}
 
-//SELLITEM IMPLEMENTATION
+/**
+ Sets whether command lines are parsed on a thread of their own.
+ @param enabled True to parse the command lines on a parser thread while the calling thread executes
+ them. False to parse and execute each line on the calling thread.
+ @pre None
+ @post When enabled, processCommandsFromFile and processCommandsFromText will read, split, and
+ validate the command lines on a parser thread, which passes the typed command records to the
+ calling thread through an SpscQueue. The output and results will be the same as processing the
+ commands on one thread.
+ */
+void StoreInventory::setPipelined(bool enabled)
+{
+   pipelined = enabled;
+}
 
 /**
- Executes SellItem.
- If the item to be sold is in the inventory and the customer is in the store's database, the item's count
- is decremented or, if the item's count is one, the item is removed from the inventory. A transaction
- containing a record of the item sold is added to the customer's transaction history.
- @param args The arguments to execute the SellItem command.
- @param store The StoreInventory object on which the SellItem command will act.
- @return True if the command was executed successfully. False otherwise.
- @pre The elements in the 'args' vector must contain appropriate data.
- @post The item is removed from the inventory or its item count is decremented. The transaction is
- appended to the customer's list of transactions. If the customer or item are not found, error
- messages will be output.
+ Sends the store's reports and command errors to a file instead of standard output.
+ @param fileName The name of the file. It is created or truncated.
+ @return True if the file was opened. False otherwise.
+ @pre None
+ @post Output already written will be flushed to its previous destination.
  */
-bool StoreInventory::SellItem::execute(const std::vector<std::string>& args,
-                                       StoreInventory& store)
+bool StoreInventory::setOutputFile(const std::string& fileName)
 {
-   const char SELL = 'S';
-   //indices of elements in 'args'
-   const int ID = 0;
-   const int ITEM_TYPE = 1;
-   const int FIRST_DATA_ELEMENT = 2;
+   return outputSink.open(fileName);
+}
+
+/**
+ Sends the error messages for the customer and inventory files to a file instead of standard error.
+ @param fileName The name of the file. It is created or truncated.
+ @return True if the file was opened. False otherwise.
+ @pre None
+ @post Later error messages will be written to the file.
+ */
+bool StoreInventory::setErrorFile(const std::string& fileName)
+{
+   return errorSink.open(fileName);
+}
+
+/**
+ Sets whether the store's output is flushed after every command.
+ @param enabled True to write the output of each command as soon as it has executed. False to
+ collect the output in a large buffer.
+ @pre None
+ @post The output sink will flush at the end of every command if enabled is true.
+ */
+void StoreInventory::setFlushEachCommand(bool enabled)
+{
+   outputSink.setFlushEachCommand(enabled);
+}
+
+/**
+ Writes any output the store is holding.
+ @pre None
+ @post The report and error output written so far will have been passed to the operating system.
+ */
+void StoreInventory::flushOutput()
+{
+   outputSink.flush();
+   errorSink.flush();
+}
+
+/**
+ Records the store's buy and sell commands in a write-ahead log with checkpoints, restoring the
+ store from them if an earlier run left them in the directory.
+ @param directory The directory holding the checkpoint and log files. It is created if it does
+ not exist.
+ @param recovered Set to true if the store was restored from an earlier run.
+ @return True if the files were opened and any checkpoint and log read. False otherwise.
+ @pre No customers, items, or commands may have been added to the store.
+ @post If the directory holds a checkpoint the store will hold its customers, inventory, and
+ transactions with the logged commands applied after them, and processCommandsFromFile and
+ processCommandsFromText will skip the command lines up to the last trade recovered, while
+ processCommandsFromStream and processCommand will number new commands after it. Otherwise a
+ checkpoint will be written before the first command. Every window of trades will be logged and
+ synced to disk before its results are output.
+ */
+bool StoreInventory::openLog(const std::string& directory, bool& recovered)
+{
+   const std::string CHECKPOINT_FILE = "/store.ckp";
+   const std::string LOG_FILE = "/store.wal";
    
-   //check valid id
-   if ( !store.isValidCustID(args[ID]) )
+   recovered = false;
+   std::string checkpointName = directory + CHECKPOINT_FILE;
+   
+   //a first run creates the directory
+   if ( ::mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST )
+      return false;
+   
+   //restore the checkpoint left by an earlier run, if there is one
+   bool hasCheckpoint = ::access(checkpointName.c_str(), F_OK) == 0;
+   if ( hasCheckpoint )
    {
-      std::cout << "Sell Item Error: Customer ID " << args[ID]
-      << " invalid.\n" << std::endl;
+      MappedFile checkpointFile;
+      if ( !checkpointFile.open(checkpointName)
+          || !decodeSnapshot(checkpointFile.getContents()) )
+         return false;
+   }
+   
+   if ( !tradeLog.open(directory + LOG_FILE) )
       return false;
+   checkpointFileName = checkpointName;
+   
+   if ( hasCheckpoint )
+   {
+      //apply the commands logged after the checkpoint was written
+      bool replayed = true;
+      tradeLog.replay([this, &replayed](const WriteAheadLog::Record& record)
+         {
+            if ( !applyLoggedTrade(record) )
+               replayed = false;
+         });
+      if ( !replayed )
+         return false;
+      
+      //the lines up to the last trade recovered are not executed again
+      resumeAfter = lastTradeNumber;
+      recovered = true;
    }
-   //check if customer exists
-   Customer* customer = store.customerDict[stoi(args[ID])];
-   if ( customer == nullptr )
+   else
    {
-      std::cout << "Sell Item Error: Customer ID " << args[ID]
-      << " not found.\n" << std::endl;
+      //records without the checkpoint they follow cannot be applied
+      tradeLog.reset();
+      checkpointNeeded = true;
+   }
+   return true;
+}
+
+/**
+ Sets how many logged commands are kept before a checkpoint replaces them.
+ @param recordCount The number of log records that starts a checkpoint.
+ @pre None
+ @post A checkpoint will be written after the window of trades that brings the log to recordCount
+ records.
+ */
+void StoreInventory::setCheckpointInterval(std::size_t recordCount)
+{
+   checkpointInterval = recordCount < 1 ? 1 : recordCount;
+}
+
+/**
+ Writes a checkpoint of the store and empties the log.
+ @return True if the checkpoint was written. False if no log is open or a file could not be written.
+ @pre No trades may be waiting in the window.
+ @post The checkpoint file will be replaced atomically by one holding the customers, inventory,
+ item catalog, and transactions, and the log will hold no records.
+ */
+bool StoreInventory::checkpoint()
+{
+   if ( !tradeLog.isOpen() )
       return false;
+   
+   //the records are only dropped once the checkpoint holding them is durable
+   encodeSnapshot(lastTradeNumber);
+   if ( !tradeLog.commit()
+       || !replaceFileDurably(checkpointFileName, snapshotBytes) )
+      return false;
+   checkpointNeeded = false;
+   return tradeLog.reset();
+}
+
+/**
+ Saves the whole store in a binary snapshot file.
+ @param fileName The name of the file. It is created or replaced.
+ @return True if the snapshot was written. False otherwise.
+ @pre None
+ @post Any trades waiting in the window will be applied first. The file will hold the customers,
+ inventory trees with their counts, item catalog, and transactions in the versioned snapshot format,
+ and will be replaced atomically.
+ */
+bool StoreInventory::saveSnapshot(const std::string& fileName)
+{
+   flushTrades();
+   encodeSnapshot(0);
+   return replaceFileDurably(fileName, snapshotBytes);
+}
+
+/**
+ Restores the whole store from a binary snapshot file, instead of customer and inventory files.
+ @param fileName The name of the file.
+ @return True if the snapshot was read and restored. False if it could not be opened, is damaged, or
+ was written by another version of the format.
+ @pre No customers or items may have been added to the store.
+ @post The store will hold the customers, inventory, and transactions saved in the snapshot. The file
+ is mapped into memory and its fields copied out directly, without text being split or validated.
+ */
+bool StoreInventory::loadSnapshot(const std::string& fileName)
+{
+   MappedFile snapshotFile;
+   if ( !snapshotFile.open(fileName)
+       || !decodeSnapshot(snapshotFile.getContents()) )
+      return false;
+   
+   //the lines of a new command file are not related to the saved trades
+   lastTradeNumber = 0;
+   return true;
+}
+
+/**
+ Encodes the whole store into snapshotBytes.
+ @param tradeNumber The line number of the last trade applied, saved for recovery from the log.
+ @pre No trades may be waiting in the window.
+ @post snapshotBytes will hold the customers and inventory trees in pre-order with the shape of each
+ node, the item catalog in ID order, and the transactions in chronological order, followed by a
+ checksum of every byte.
+ */
+void StoreInventory::encodeSnapshot(std::uint64_t tradeNumber)
+{
+   snapshotBytes.clear();
+   BinaryWriter writer(snapshotBytes);
+   writer.putU32(SNAPSHOT_MAGIC);
+   writer.putU32(SNAPSHOT_VERSION);
+   writer.putU64(tradeNumber);
+   
+   //customers in the customerTree in pre-order with the shape of each node,
+   //so the tree is rebuilt without comparing names, and whether
+   //customerDict holds each of them
+   std::uint64_t nodeCount = 0;
+   customerTree.visitPreorder([&nodeCount](const Comparable&, int, bool, bool)
+      {
+         nodeCount++;
+      });
+   writer.putU64(nodeCount);
+   customerTree.visitPreorder([this, &writer](const Comparable& node,
+                                              int count, bool hasLeft,
+                                              bool hasRight)
+      {
+         const Customer& customer = static_cast<const Customer&>(node);
+         bool indexed = customerDict.find(customer.getKey()) == &customer;
+         writer.putU8((hasLeft ? HAS_LEFT_CHILD : 0)
+                      | (hasRight ? HAS_RIGHT_CHILD : 0)
+                      | (indexed ? IN_CUSTOMER_INDEX : 0));
+         writer.putInt(count);
+         writer.putU64(customer.getKey());
+         writer.putString(customer.getIdNumber());
+         writer.putString(customer.getName());
+      });
+   
+   //customers only in customerDict, whose names were already taken
+   std::vector<const Customer*> unlisted;
+   customerDict.visit([this, &unlisted](unsigned long long, Customer* customer)
+      {
+         if ( customerTree.retrieve(*customer) != customer )
+            unlisted.push_back(customer);
+      });
+   writer.putU64(unlisted.size());
+   for ( std::size_t i = 0; i < unlisted.size(); i++ )
+   {
+      writer.putU64(unlisted[i]->getKey());
+      writer.putString(unlisted[i]->getIdNumber());
+      writer.putString(unlisted[i]->getName());
    }
    
-   //create Collectible object from itemType
-   char itemType = (args[ITEM_TYPE])[0];
-   Collectible* itemPtr = store.collectibleFactory.createObject(itemType);
+   //each inventory tree in pre-order
+   for ( std::size_t i = 0; i < itemSymbols.size(); i++ )
+   {
+      const SearchTree<Collectible>* tree = inventoryTree[hashItem(itemSymbols[i])];
+      nodeCount = 0;
+      tree->visitPreorder([&nodeCount](const Comparable&, int, bool, bool)
+         {
+            nodeCount++;
+         });
+      writer.putU64(nodeCount);
+      tree->visitPreorder([&writer](const Comparable& node, int count,
+                                    bool hasLeft, bool hasRight)
+         {
+            writer.putU8((hasLeft ? HAS_LEFT_CHILD : 0)
+                         | (hasRight ? HAS_RIGHT_CHILD : 0));
+            writer.putInt(count);
+            static_cast<const Collectible&>(node).writeData(writer);
+         });
+   }
+   
+   //the catalog in ID order, so interning the items again gives the same IDs
+   writer.putU64(itemCatalog.size());
+   for ( int itemId = 0; itemId < itemCatalog.size(); itemId++ )
+   {
+      const Collectible* item = itemCatalog.getItem(itemId);
+      writer.putU8(item->getSymbol());
+      item->writeData(writer);
+   }
+   
+   //every transaction in chronological order
+   writer.putU64(transactionLog.size());
+   for ( std::uint32_t position = 0; position < transactionLog.size();
+        position++ )
+   {
+      writer.putU8(transactionLog.getAction(position));
+      writer.putU64(transactionLog.getCustomerId(position));
+      writer.putInt(transactionLog.getItemId(position));
+   }
+   
+   writer.putU32(WriteAheadLog::checksum(snapshotBytes));
+}
+
+/**
+ Prepares a buy or sell command and adds it to the window of waiting trades.
+ @param command The command.
+ @param args The arguments of the command.
+ @pre None
+ @post The prepared trade will be the last trade in pendingTrades. Its error output, if any, will be
+ in tradeMessages.
+ */
+void StoreInventory::queueTrade(const TradeCommand& command,
+                                const FieldSpan& args)
+{
+   pendingTrades.push_back(Trade());
+   Trade& trade = pendingTrades.back();
+   trade.commandNumber = commandNumber;
+   trade.messageStart = tradeMessages.size();
+   TRACE_SPAN("prepare");
+   std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+   trade.prepared = command.prepare(args, *this, trade, tradeMessages);
+   std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+   trade.prepareNanoseconds = elapsed.count();
+   trade.messageEnd = tradeMessages.size();
+}
+
+/**
+ Processes store commands on a parser thread and the calling thread.
+ @param nextLine The function returning the next command line. It returns false after the last line.
+ @pre nextLine must only be called by one thread and the view it sets must stay valid until it is
+ called again.
+ @post The commands will be executed on the calling thread in order with the same results as
+ processCommandLine.
+ */
+void StoreInventory::processCommandsPipelined(
+   const std::function<bool(std::string_view&)>& nextLine)
+{
+   SpscQueue<CommandRecord> records(PIPELINE_CAPACITY);
+   std::thread parser(&StoreInventory::parseCommands, this, std::cref(nextLine),
+                      std::ref(records));
+   
+   //execute the records until the parser marks the end of the lines
+   while ( true )
+   {
+      CommandRecord& record = records.front();
+      if ( record.command == nullptr )
+         break;
+      executeRecord(record);
+      records.popFront();
+   }
+   records.popFront();
+   parser.join();
+   
+   //apply the trades left in the window
+   flushTrades();
+   outputSink.flush();
+}
+
+/**
+ Parses command lines into records for the executing thread. Runs on the parser thread.
+ @param nextLine The function returning the next command line.
+ @param records The queue receiving the records.
+ @pre The store's customers and inventory trees must not be added or removed while parsing.
+ @post A record will be pushed for every line holding a known command, followed by a record whose
+ command is nullptr.
+ */
+void StoreInventory::parseCommands(
+   const std::function<bool(std::string_view&)>& nextLine,
+   SpscQueue<CommandRecord>& records)
+{
+   const int COMMAND = 0;
+   const int FIRST_ARG = 1;
    
-   //create subvector of data elements from args[2]-args[args.size()-1]
-   std::vector<std::string>::const_iterator first = args.begin()
-      + FIRST_DATA_ELEMENT;
-   std::vector<std::string>::const_iterator last = args.end();
-   std::vector<std::string> data(first, last);
+   //the executing thread keeps lineTokenizer
+   LineTokenizer tokenizer;
+   std::string_view line;
+   unsigned long long lineNumber = 0;
    
-   //Collectible item was created
-   if ( itemPtr != nullptr )
+   while ( nextLine(line) )
    {
-      //find the appropriate inventory tree
-      int inventoryTreeIndex = store.hashItem(itemType);
+      //skip the lines an earlier run applied, blank lines, and unknown
+      //commands, as processCommandLine does
+      if ( ++lineNumber <= resumeAfter )
+         continue;
+      TRACE_SPAN("parse");
+      FieldSpan fields;
+      {
+         TRACE_SPAN("tokenize");
+         fields = tokenizer.split(line);
+      }
+      if ( fields.isEmpty() || fields[COMMAND].empty() )
+         continue;
+      StoreCommand* commandPtr = commandFactory.findCommand(fields[COMMAND][0]);
+      if ( commandPtr == nullptr )
+         continue;
       
-      //invalid index
-      if ( inventoryTreeIndex < 0 )
+      CommandRecord& record = records.beginPush();
+      record.command = commandPtr;
+      record.commandNumber = lineNumber;
+      TradeCommand* tradePtr = commandPtr->asTradeCommand();
+      record.isTrade = tradePtr != nullptr;
+      
+      //buy and sell commands only read the customers and the factories, so
+      //they can be prepared ahead of the commands before them
+      if ( record.isTrade )
       {
-         std::cerr << "SellItem::execute: itemType hashed to negative"
-         << " index" << std:: endl;
-         
-         //delete item
-         delete itemPtr;
-         itemPtr = nullptr;
-         return false;
+         record.trade = Trade();
+         record.trade.commandNumber = lineNumber;
+         record.messages.clear();
+         TRACE_SPAN("prepare");
+         std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+         record.trade.prepared = tradePtr->prepare(fields.subspan(FIRST_ARG),
+                                                   *this, record.trade,
+                                                   record.messages);
+         std::chrono::nanoseconds elapsed =
+            std::chrono::steady_clock::now() - start;
+         record.trade.prepareNanoseconds = elapsed.count();
       }
+      else
+         record.line.assign(line.data(), line.size());
+      records.endPush();
+   }
+   
+   //mark the end of the lines
+   records.beginPush().command = nullptr;
+   records.endPush();
+}
+
+/**
+ Executes a command record parsed by parseCommands.
+ @param record The record.
+ @pre None
+ @post A trade will be added to the window of waiting trades, and any other command will be
+ executed after the window is applied.
+ */
+void StoreInventory::executeRecord(CommandRecord& record)
+{
+   const int COMMAND = 0;
+   const int FIRST_ARG = 1;
+   
+   TRACE_SPAN("command");
+   commandNumber = record.commandNumber;
+   if ( record.isTrade )
+   {
+      //copy the trade and its error output into the window
+      pendingTrades.push_back(record.trade);
+      Trade& trade = pendingTrades.back();
+      trade.messageStart = tradeMessages.size();
+      tradeMessages.append(record.messages.view());
+      trade.messageEnd = tradeMessages.size();
       
-      //itemType hashed to index holding SearchTree
-      if ( store.inventoryTree[inventoryTreeIndex] != nullptr )
+      if ( pendingTrades.size() >= tradeWindow )
+         flushTrades();
+   }
+   else //any other command sees the results of the waiting trades
+   {
+      flushTrades();
+      FieldSpan fields;
+      {
+         TRACE_SPAN("tokenize");
+         fields = lineTokenizer.split(record.line);
+      }
+      executeCommand(*record.command, fields[COMMAND][0],
+                     fields.subspan(FIRST_ARG));
+   }
+   outputSink.endCommand();
+}
+
+/**
+ Applies and reports the window of waiting trades.
+ @return True if every trade in the window succeeded. False otherwise.
+ @pre None
+ @post The inventory, customer transactions, and output will be the same as executing the trades one
+ at a time in order. Each trade's time and result will be recorded in commandStats. The window will
+ be empty.
+ */
+bool StoreInventory::flushTrades()
+{
+   if ( pendingTrades.empty() )
+      return true;
+   TRACE_SPAN("flush trades");
+   std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+   applyTrades();
+   bool allSucceeded = reportTrades();
+   std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+   
+   //each trade is charged its own preparation and an equal share of
+   //applying and reporting the window
+   std::uint64_t share = elapsed.count() / pendingTrades.size();
+   for ( std::size_t i = 0; i < pendingTrades.size(); i++ )
+   {
+      const Trade& trade = pendingTrades[i];
+      commandStats.recordCommand(trade.action,
+                                 trade.prepared && trade.succeeded,
+                                 trade.prepareNanoseconds + share);
+   }
+   lastTradeNumber = pendingTrades.back().commandNumber;
+   pendingTrades.clear();
+   tradeMessages.clear();
+   
+   //a checkpoint keeps the log short enough to replay quickly
+   if ( tradeLog.isOpen() && tradeLog.getRecordCount() >= checkpointInterval )
+      checkpoint();
+   return allSucceeded;
+}
+
+/**
+ Applies the prepared trades of the window to the inventory.
+ @pre None
+ @post The trades of each inventory tree will be sorted by item, the counts of their items looked up
+ in one pass over the tree, and the trades of each item simulated in command file order to decide
+ which succeed. The count of an item whose node stays is then written to the tree once, and the
+ nodes the trades insert or remove are inserted and removed in command file order, so the tree has
+ the shape executing the trades one at a time would give it. The trees are applied on the trade
+ threads in parallel when there are several.
+ */
+void StoreInventory::applyTrades()
+{
+   //sort the prepared trades by tree, then by item, keeping the file order
+   //of the trades of each item
+   tradeOrder.clear();
+   for ( std::size_t i = 0; i < pendingTrades.size(); i++ )
+   {
+      if ( pendingTrades[i].prepared )
+         tradeOrder.push_back(i);
+   }
+   std::stable_sort(tradeOrder.begin(), tradeOrder.end(),
+      [this](std::size_t left, std::size_t right)
       {
-         //set item's data
-         //if data is valid
-         if ( itemPtr->setData(data) )
+         const Trade& leftTrade = pendingTrades[left];
+         const Trade& rightTrade = pendingTrades[right];
+         if ( leftTrade.treeIndex != rightTrade.treeIndex )
+            return leftTrade.treeIndex < rightTrade.treeIndex;
+         return *leftTrade.item < *rightTrade.item;
+      });
+   
+   //divide the sorted trades into a batch per tree, reusing the batches'
+   //scratch space from earlier windows
+   std::size_t batchCount = 0;
+   std::size_t treeStart = 0;
+   while ( treeStart < tradeOrder.size() )
+   {
+      int treeIndex = pendingTrades[tradeOrder[treeStart]].treeIndex;
+      std::size_t treeEnd = treeStart;
+      while ( treeEnd < tradeOrder.size()
+             && pendingTrades[tradeOrder[treeEnd]].treeIndex == treeIndex )
+         treeEnd++;
+      
+      if ( batchCount == treeBatches.size() )
+         treeBatches.emplace_back();
+      treeBatches[batchCount].start = treeStart;
+      treeBatches[batchCount].end = treeEnd;
+      batchCount++;
+      treeStart = treeEnd;
+   }
+   
+   //the trees share no items, so each is applied by one thread without locks;
+   //the customers are only changed by reportTrades, in file order
+   if ( tradePool != nullptr && batchCount > 1 )
+   {
+      tradePool->run(batchCount, [this](std::size_t batch)
          {
-            //atempt to remove 1 instance of item
-            bool removed =
-               store.inventoryTree[inventoryTreeIndex]->remove(*itemPtr);
-            
-            //item not found in inventory
-            if ( !removed )
-            {
-               std::cout << "Sell Item Error. Item not found: " << *itemPtr
-               << "\n" << std::endl;
-               
-               //delete item
-               delete itemPtr;
-               itemPtr = nullptr;
+            applyTreeTrades(treeBatches[batch]);
+         });
+   }
+   else
+   {
+      for ( std::size_t i = 0; i < batchCount; i++ )
+         applyTreeTrades(treeBatches[i]);
+   }
+   
+   for ( std::size_t i = 0; i < batchCount; i++ )
+      commandStats.countTreeOperations(treeBatches[i].treeOperations);
+}
 
-               return false;
+/**
+ Applies the window's trades on one inventory tree.
+ @param batch The trades of the tree, as positions in tradeOrder, and the scratch space to use.
+ @pre applyTrades must have sorted tradeOrder. No other thread may use the tree, the batch, or
+ the pending trades of the tree.
+ @post The trades of the tree will be marked as succeeded or failed and the tree updated as
+ described for applyTrades.
+ */
+void StoreInventory::applyTreeTrades(TreeBatch& batch)
+{
+   const char SELL = 'S';
+   TRACE_SPAN("apply tree");
+   
+   std::vector<SearchTree<Collectible>::CountQuery>& countQueries =
+      batch.countQueries;
+   std::vector<ShapeChange>& shapeChanges = batch.shapeChanges;
+   std::size_t treeStart = batch.start;
+   std::size_t treeEnd = batch.end;
+   SearchTree<Collectible>* tree =
+      inventoryTree[pendingTrades[tradeOrder[treeStart]].treeIndex];
+   
+   //look up each distinct item of the tree in one pass
+   countQueries.clear();
+   for ( std::size_t i = treeStart; i < treeEnd; i++ )
+   {
+      const Collectible* item = pendingTrades[tradeOrder[i]].item;
+      if ( countQueries.empty() || !(*countQueries.back().item == *item) )
+         countQueries.push_back({item, false, 0});
+   }
+   tree->retrieveCounts(countQueries.data(), countQueries.size());
+   batch.treeOperations = countQueries.size();
+   
+   //simulate the trades of each item in file order, noting every node the
+   //trades insert or remove
+   shapeChanges.clear();
+   std::size_t position = treeStart;
+   for ( std::size_t i = 0; i < countQueries.size(); i++ )
+   {
+      const SearchTree<Collectible>::CountQuery& query = countQueries[i];
+      bool inTree = query.found;
+      int itemCount = query.itemCount;
+      std::size_t firstChange = shapeChanges.size();
+      
+      while ( position < treeEnd
+             && *pendingTrades[tradeOrder[position]].item == *query.item )
+      {
+         Trade& trade = pendingTrades[tradeOrder[position]];
+         if ( trade.action == SELL )
+         {
+            //the same rule as SearchTree::remove
+            trade.succeeded = inTree;
+            if ( inTree && itemCount > 1 )
+               itemCount--;
+            else if ( inTree )
+            {
+               inTree = false;
+               shapeChanges.push_back({tradeOrder[position], false, 0, false});
             }
-            
-            //1 instance of item removed from tree
-            //add item to customers transactions
-            customer->addTransaction(SELL, itemPtr);
-            
-            return true;
          }
-         else //invalid data, delete item
+         else
          {
-            delete itemPtr;
-            itemPtr = nullptr;
-            std::cout << "Sell Item Error. Invalid data.\n" << std::endl;
-            return false;
+            //the same rule as SearchTree::insert
+            trade.succeeded = true;
+            if ( inTree )
+               itemCount++;
+            else
+            {
+               inTree = true;
+               itemCount = 1;
+               shapeChanges.push_back({tradeOrder[position], true, 1, false});
+            }
          }
+         position++;
       }
-      else //itemType hashed to index holding nullptr
+      
+      //an item whose node stays is written to the tree once
+      if ( shapeChanges.size() == firstChange )
       {
-         delete itemPtr;
-         itemPtr = nullptr;
-         std::cerr<< "Item type hashed to index in inventoryTree holding"
-         << " nullptr.\n" << std::endl;
+         if ( query.found && itemCount != query.itemCount )
+         {
+            tree->setCount(*query.item, itemCount);
+            batch.treeOperations++;
+         }
+      }
+      //the node inserted last holds the buyer's item and the final count;
+      //nodes removed again in the window hold copies
+      else if ( inTree )
+      {
+         ShapeChange& last = shapeChanges.back();
+         last.itemCount = itemCount;
+         last.keepsItem = true;
+         pendingTrades[last.trade].itemInTree = true;
+      }
+   }
+   
+   //insert and remove the nodes in file order, so the tree has the shape
+   //executing the trades one at a time would give it
+   std::sort(shapeChanges.begin(), shapeChanges.end(),
+             [](const ShapeChange& left, const ShapeChange& right)
+      {
+         return left.trade < right.trade;
+      });
+   for ( std::size_t i = 0; i < shapeChanges.size(); i++ )
+   {
+      const ShapeChange& change = shapeChanges[i];
+      Collectible* item = pendingTrades[change.trade].item;
+      if ( !change.insert )
+         tree->removeAll(*item);
+      else if ( change.keepsItem )
+         tree->insert(item, change.itemCount);
+      else
+         tree->insert(item->clone(), change.itemCount);
+   }
+   batch.treeOperations += shapeChanges.size();
+}
+
+/**
+ Applies the basket of items created by TradeBasket.
+ @return True if the basket was traded. False if an item to sell is not in the inventory.
+ @pre basketTrades must hold the basket's prepared trades in argument order, all with the same
+ action and customer.
+ @post The items will be grouped by tree and item and the count of each distinct item looked up in
+ one pass over its tree. A sale succeeds only if every item is found often enough. The inventory
+ is then changed once per distinct item, the transactions appended to the customer together in
+ argument order, and the basket logged as one record, so it is recovered whole or not at all.
+ Items not owned by an inventory tree will be deleted and basketTrades emptied.
+ */
+bool StoreInventory::applyBasket()
+{
+   const char SELL = 'S';
+   char action = basketTrades[0].action;
+   Customer* customer = basketTrades[0].customer;
+   
+   //sort the items by tree, then by item, keeping the argument order of
+   //equal items
+   basketOrder.clear();
+   for ( std::size_t i = 0; i < basketTrades.size(); i++ )
+      basketOrder.push_back(i);
+   std::stable_sort(basketOrder.begin(), basketOrder.end(),
+      [this](std::size_t left, std::size_t right)
+      {
+         const Trade& leftTrade = basketTrades[left];
+         const Trade& rightTrade = basketTrades[right];
+         if ( leftTrade.treeIndex != rightTrade.treeIndex )
+            return leftTrade.treeIndex < rightTrade.treeIndex;
+         return *leftTrade.item < *rightTrade.item;
+      });
+   
+   //one query per distinct item, basketGroups[i] is where its items start
+   //in basketOrder
+   basketQueries.clear();
+   basketGroups.clear();
+   for ( std::size_t i = 0; i < basketOrder.size(); i++ )
+   {
+      const Trade& trade = basketTrades[basketOrder[i]];
+      if ( i == 0 || trade.treeIndex != basketTrades[basketOrder[i - 1]].treeIndex
+          || !(*trade.item == *basketQueries.back().item) )
+      {
+         basketQueries.push_back({trade.item, false, 0});
+         basketGroups.push_back(i);
+      }
+   }
+   basketGroups.push_back(basketOrder.size());
+   
+   //look up the distinct items of each tree in one pass over the tree
+   std::size_t treeStart = 0;
+   while ( treeStart < basketQueries.size() )
+   {
+      int treeIndex = basketTrades[basketOrder[basketGroups[treeStart]]].treeIndex;
+      std::size_t treeEnd = treeStart;
+      while ( treeEnd < basketQueries.size()
+             && basketTrades[basketOrder[basketGroups[treeEnd]]].treeIndex
+                == treeIndex )
+         treeEnd++;
+      inventoryTree[treeIndex]->retrieveCounts(basketQueries.data() + treeStart,
+                                               treeEnd - treeStart);
+      treeStart = treeEnd;
+   }
+   commandStats.countTreeOperations(basketQueries.size());
+   
+   //a sale needs every item as many times as the basket holds it; report the
+   //first item in argument order that is missing
+   std::size_t missing = basketTrades.size();
+   basketNewItems.clear();
+   if ( action == SELL )
+   {
+      for ( std::size_t i = 0; i < basketQueries.size(); i++ )
+      {
+         std::size_t needed = basketGroups[i + 1] - basketGroups[i];
+         if ( !basketQueries[i].found
+             || static_cast<std::size_t>(basketQueries[i].itemCount) < needed )
+            missing = std::min(missing, basketOrder[basketGroups[i]]);
+      }
+   }
+   if ( missing < basketTrades.size() )
+   {
+      reportBuffer.clear();
+      reportBuffer.append("Sell Basket Error. Item not found: ");
+      basketTrades[missing].item->format(reportBuffer);
+      reportBuffer.append("\n\n");
+      outputSink.write(reportBuffer);
+      commandStats.countError(CommandStats::ITEM_NOT_FOUND);
+   }
+   else
+   {
+      //change each distinct item's count once
+      for ( std::size_t i = 0; i < basketQueries.size(); i++ )
+      {
+         const SearchTree<Collectible>::CountQuery& query = basketQueries[i];
+         Trade& first = basketTrades[basketOrder[basketGroups[i]]];
+         SearchTree<Collectible>* tree = inventoryTree[first.treeIndex];
+         int units = static_cast<int>(basketGroups[i + 1] - basketGroups[i]);
+         if ( action == SELL && query.itemCount == units )
+            tree->removeAll(*query.item);
+         else if ( action == SELL )
+            tree->setCount(*query.item, query.itemCount - units);
+         else if ( query.found )
+            tree->setCount(*query.item, query.itemCount + units);
+         else
+         {
+            first.itemInTree = true;
+            basketNewItems.push_back(
+               std::make_pair(basketOrder[basketGroups[i]], units));
+         }
+      }
+      
+      //insert new items in argument order, as the items traded one at a
+      //time would be
+      std::sort(basketNewItems.begin(), basketNewItems.end());
+      for ( std::size_t i = 0; i < basketNewItems.size(); i++ )
+      {
+         Trade& trade = basketTrades[basketNewItems[i].first];
+         inventoryTree[trade.treeIndex]->insert(trade.item,
+                                                basketNewItems[i].second);
+      }
+      
+      //append the whole basket to the customer's history at once
+      basketItemIds.clear();
+      for ( std::size_t i = 0; i < basketTrades.size(); i++ )
+         basketItemIds.push_back(itemCatalog.intern(*basketTrades[i].item));
+      customer->addTransactions(action, basketItemIds.data(),
+                                basketItemIds.size());
+      
+      //each distinct item was changed once
+      commandStats.countTreeOperations(basketQueries.size());
+      commandStats.countTransactions(basketItemIds.size());
+      
+      //one record holds the basket, so a torn log cannot split it
+      if ( tradeLog.isOpen() )
+      {
+         basketRecord.clear();
+         BinaryWriter writer(basketRecord);
+         for ( std::size_t i = 0; i < basketTrades.size(); i++ )
+         {
+            itemData.clear();
+            basketTrades[i].item->formatData(itemData);
+            writer.putU8(basketTrades[i].item->getSymbol());
+            writer.putString(itemData.view());
+         }
+         tradeLog.append({basketTrades[0].commandNumber, customer->getKey(),
+                          action, BASKET_RECORD, basketRecord});
+         tradeLog.commit();
+      }
+      lastTradeNumber = basketTrades[0].commandNumber;
+   }
+   
+   //the trees and catalog hold their own copies
+   bool traded = missing == basketTrades.size();
+   for ( std::size_t i = 0; i < basketTrades.size(); i++ )
+   {
+      if ( !basketTrades[i].itemInTree )
+         delete basketTrades[i].item;
+   }
+   basketTrades.clear();
+   
+   //a checkpoint keeps the log short enough to replay quickly
+   if ( tradeLog.isOpen() && tradeLog.getRecordCount() >= checkpointInterval )
+      checkpoint();
+   return traded;
+}
+
+/**
+ Outputs the results of the window of trades in command file order.
+ @return True if every trade succeeded. False otherwise.
+ @pre applyTrades must have been called for the window.
+ @post Error output will be written and a transaction added for each trade that succeeded, and the
+ errors, items, and transactions counted in commandStats. Items not owned by an inventory tree will
+ be deleted. The trades stay in the window for flushTrades to time.
+ */
+bool StoreInventory::reportTrades()
+{
+   TRACE_SPAN("report trades");
+   bool allSucceeded = true;
+   reportBuffer.clear();
+   
+   for ( std::size_t i = 0; i < pendingTrades.size(); i++ )
+   {
+      Trade& trade = pendingTrades[i];
+      
+      //invalid arguments, output the error found by prepare
+      if ( !trade.prepared )
+      {
+         reportBuffer.append(tradeMessages.view().substr(trade.messageStart,
+            trade.messageEnd - trade.messageStart));
+         allSucceeded = false;
+         commandStats.countError(trade.error);
+         
+         //invalid data is only found after the item is created
+         if ( trade.error == CommandStats::INVALID_DATA )
+            commandStats.countItemsCreated(1);
+         continue;
+      }
+      commandStats.countItemsCreated(1);
+      
+      //add the item's catalog entry to the customer's transactions
+      if ( trade.succeeded )
+      {
+         {
+            TRACE_SPAN("addTransaction");
+            trade.customer->addTransaction(trade.action,
+                                           itemCatalog.intern(*trade.item));
+         }
+         commandStats.countTransactions(1);
+         if ( tradeLog.isOpen() )
+            logTrade(trade);
+      }
+      else //only a sale can fail once prepared
+      {
+         reportBuffer.append("Sell Item Error. Item not found: ");
+         trade.item->format(reportBuffer);
+         reportBuffer.append("\n\n");
+         allSucceeded = false;
+         commandStats.countError(CommandStats::ITEM_NOT_FOUND);
+      }
+      
+      //the tree and catalog hold their own copies, delete item
+      if ( !trade.itemInTree )
+         delete trade.item;
+      trade.item = nullptr;
+   }
+   
+   //one disk sync covers the whole window, before any of its results are
+   //output
+   if ( tradeLog.isOpen() )
+   {
+      TRACE_SPAN("log commit");
+      tradeLog.commit();
+   }
+   
+   TRACE_SPAN("output");
+   outputSink.write(reportBuffer);
+   return allSucceeded;
+}
+
+/**
+ Adds a trade that succeeded to the write-ahead log.
+ @param trade The trade.
+ @pre The log must be open and the trade must have succeeded.
+ @post A record of the trade will be written to the log by its next commit.
+ */
+void StoreInventory::logTrade(const Trade& trade)
+{
+   itemData.clear();
+   trade.item->formatData(itemData);
+   tradeLog.append({trade.commandNumber, trade.customer->getKey(),
+                    trade.action, trade.item->getSymbol(), itemData.view()});
+}
+
+/**
+ Restores the store from the bytes of a snapshot or checkpoint file.
+ @param contents The bytes of the file.
+ @return True if the snapshot is complete and every part of it could be restored. False otherwise.
+ @pre The store must be empty.
+ @post The customers, inventory trees, item catalog, and transactions will be those of the store
+ when the snapshot was written, and the inventory and customer trees will have the same shapes.
+ lastTradeNumber will be set to the number saved with the snapshot.
+ */
+bool StoreInventory::decodeSnapshot(std::string_view contents)
+{
+   //the checksum at the end covers every byte before it
+   std::uint32_t sum;
+   if ( contents.size() < sizeof(sum) )
+      return false;
+   std::string_view body = contents.substr(0, contents.size() - sizeof(sum));
+   BinaryReader trailer(contents.substr(body.size()));
+   if ( !trailer.getU32(sum) || sum != WriteAheadLog::checksum(body) )
+      return false;
+   
+   BinaryReader reader(body);
+   std::uint32_t magic;
+   std::uint32_t version;
+   std::uint64_t tradeNumber;
+   if ( !reader.getU32(magic) || magic != SNAPSHOT_MAGIC
+       || !reader.getU32(version) || version != SNAPSHOT_VERSION
+       || !reader.getU64(tradeNumber) )
+      return false;
+   lastTradeNumber = tradeNumber;
+   
+   //customers in the customerTree, linked in the saved shape
+   std::uint64_t count;
+   if ( !reader.getU64(count) )
+      return false;
+   reserveCustomers(count);
+   if ( count > 0 && !customerTree.buildPreorder([this, &reader](
+         Customer*& customer, int& nodeCount, bool& hasLeft, bool& hasRight)
+      {
+         std::uint8_t flags;
+         std::int32_t countValue;
+         std::uint64_t key;
+         std::string_view idNumber;
+         std::string_view name;
+         if ( !reader.getU8(flags) || !reader.getInt(countValue)
+             || !reader.getU64(key) || !reader.getString(idNumber)
+             || !reader.getString(name) )
+            return false;
+         customer = new Customer(std::string(idNumber), key, std::string(name),
+                                 &transactionLog);
+         nodeCount = countValue;
+         hasLeft = (flags & HAS_LEFT_CHILD) != 0;
+         hasRight = (flags & HAS_RIGHT_CHILD) != 0;
+         if ( (flags & IN_CUSTOMER_INDEX) != 0 )
+            customerDict.insert(key, customer);
+         return true;
+      }) )
+      return false;
+   
+   //customers only in customerDict
+   if ( !reader.getU64(count) )
+      return false;
+   for ( std::uint64_t i = 0; i < count; i++ )
+   {
+      std::uint64_t key;
+      std::string_view idNumber;
+      std::string_view name;
+      if ( !reader.getU64(key) || !reader.getString(idNumber)
+          || !reader.getString(name) )
+         return false;
+      customerDict.insert(key, new Customer(std::string(idNumber), key,
+                                            std::string(name),
+                                            &transactionLog));
+   }
+   
+   //each inventory tree, linked in the saved shape
+   for ( std::size_t i = 0; i < itemSymbols.size(); i++ )
+   {
+      char symbol = itemSymbols[i];
+      SearchTree<Collectible>* tree = inventoryTree[hashItem(symbol)];
+      if ( !reader.getU64(count) )
+         return false;
+      if ( count > 0 && !tree->buildPreorder([this, &reader, symbol](
+            Collectible*& item, int& itemCount, bool& hasLeft, bool& hasRight)
+         {
+            std::uint8_t flags;
+            std::int32_t countValue;
+            if ( !reader.getU8(flags) || !reader.getInt(countValue)
+                || (item = readItem(symbol, reader)) == nullptr )
+               return false;
+            itemCount = countValue;
+            hasLeft = (flags & HAS_LEFT_CHILD) != 0;
+            hasRight = (flags & HAS_RIGHT_CHILD) != 0;
+            return true;
+         }) )
+         return false;
+   }
+   
+   //the catalog, which must give every item the ID it had
+   if ( !reader.getU64(count) )
+      return false;
+   for ( std::uint64_t itemId = 0; itemId < count; itemId++ )
+   {
+      std::uint8_t itemType;
+      Collectible* item = nullptr;
+      if ( !reader.getU8(itemType)
+          || (item = readItem(itemType, reader)) == nullptr )
+         return false;
+      int internedId = itemCatalog.intern(*item);
+      delete item;
+      if ( static_cast<std::uint64_t>(internedId) != itemId )
+         return false;
+   }
+   
+   //the transactions, added to their customers in chronological order
+   if ( !reader.getU64(count) )
+      return false;
+   transactionLog.reserve(count);
+   for ( std::uint64_t i = 0; i < count; i++ )
+   {
+      std::uint8_t action;
+      std::uint64_t customerId;
+      std::int32_t itemId;
+      if ( !reader.getU8(action) || !reader.getU64(customerId)
+          || !reader.getInt(itemId) )
+         return false;
+      Customer* customer = customerDict.find(customerId);
+      if ( customer == nullptr || !customer->addTransaction(action, itemId) )
+         return false;
+   }
+   return reader.atEnd();
+}
+
+/**
+ Applies a buy or sell command read from the write-ahead log.
+ @param record The record of the command.
+ @return True if the customer and item could be found. False otherwise.
+ @pre The checkpoint the log follows must have been loaded.
+ @post Records already covered by the checkpoint are skipped. Otherwise the item, or each item of a
+ basket, will be added to or removed from the inventory and its transaction added to the customer,
+ as the command did when it was logged.
+ */
+bool StoreInventory::applyLoggedTrade(const WriteAheadLog::Record& record)
+{
+   //a crash between writing a checkpoint and emptying the log leaves
+   //records the checkpoint already holds
+   if ( record.commandNumber <= lastTradeNumber )
+      return true;
+   
+   Customer* customer = customerDict.find(record.customerId);
+   if ( customer == nullptr )
+      return false;
+   
+   //a basket's record holds the type and fields of each of its items
+   if ( record.itemType == BASKET_RECORD )
+   {
+      BinaryReader reader(record.itemData);
+      while ( !reader.atEnd() )
+      {
+         std::uint8_t itemType;
+         std::string_view fields;
+         if ( !reader.getU8(itemType) || !reader.getString(fields)
+             || !applyLoggedItem(*customer, record.action, itemType, fields) )
+            return false;
+      }
+   }
+   else if ( !applyLoggedItem(*customer, record.action, record.itemType,
+                              record.itemData) )
+      return false;
+   lastTradeNumber = record.commandNumber;
+   return true;
+}
+
+/**
+ Applies one item of a logged buy or sell command.
+ @param customer The customer who traded.
+ @param action 'B' or 'S'.
+ @param itemType The symbol of the item's Collectible subclass.
+ @param itemData The fields written by Collectible::formatData.
+ @return True if the item could be created. False otherwise.
+ @pre The checkpoint the log follows must have been loaded.
+ @post The item will be added to or removed from the inventory and the transaction added to the
+ customer.
+ */
+bool StoreInventory::applyLoggedItem(Customer& customer, char action,
+                                     char itemType, std::string_view itemData)
+{
+   const char BUY = 'B';
+   
+   Collectible* item = createLoggedItem(itemType, itemData);
+   if ( item == nullptr )
+      return false;
+   
+   //the same changes the trade made when it was applied
+   SearchTree<Collectible>* tree = inventoryTree[hashItem(itemType)];
+   customer.addTransaction(action, itemCatalog.intern(*item));
+   if ( action == BUY )
+   {
+      //the tree keeps item only if it is new to the tree
+      if ( !tree->insert(item) )
+         delete item;
+   }
+   else
+   {
+      tree->remove(*item);
+      delete item;
+   }
+   return true;
+}
+
+/**
+ Creates an item from the data fields saved in a checkpoint or log record.
+ @param itemType The symbol of the item's Collectible subclass.
+ @param itemData The fields written by Collectible::formatData.
+ @return The item, or nullptr if the type or data are invalid.
+ @pre None
+ @post The caller assumes ownership of the returned item.
+ */
+Collectible* StoreInventory::createLoggedItem(char itemType,
+                                              std::string_view itemData)
+{
+   if ( hashItem(itemType) < 0 || inventoryTree[hashItem(itemType)] == nullptr )
+      return nullptr;
+   Collectible* item = collectibleFactory.createObject(itemType);
+   if ( item != nullptr && !item->setData(lineTokenizer.split(itemData)) )
+   {
+      delete item;
+      item = nullptr;
+   }
+   return item;
+}
+
+/**
+ Creates an item from the binary fields saved in a snapshot.
+ @param itemType The symbol of the item's Collectible subclass.
+ @param reader The reader positioned at the fields written by Collectible::writeData.
+ @return The item, or nullptr if the type is unknown or the fields are incomplete.
+ @pre None
+ @post The reader will be advanced past the fields. The caller assumes ownership of the returned item.
+ */
+Collectible* StoreInventory::readItem(char itemType, BinaryReader& reader)
+{
+   if ( hashItem(itemType) < 0 || inventoryTree[hashItem(itemType)] == nullptr )
+      return nullptr;
+   Collectible* item = collectibleFactory.createObject(itemType);
+   if ( item != nullptr && !item->readData(reader) )
+   {
+      delete item;
+      item = nullptr;
+   }
+   return item;
+}
+
+/**
+ Writes a file and waits for it to reach the disk, replacing any file of the same name atomically.
+ @param fileName The name of the file.
+ @param contents The bytes to write.
+ @return True if the file was written and renamed into place. False otherwise.
+ @pre None
+ @post The contents will be written to a temporary file which is synced and then renamed to
+ fileName, so a crash leaves either the old file or the new one.
+ */
+bool StoreInventory::replaceFileDurably(const std::string& fileName,
+                                        std::string_view contents)
+{
+   std::string tempName = fileName + ".tmp";
+   int fileDescriptor = ::open(tempName.c_str(),
+                               O_WRONLY | O_CREAT | O_TRUNC, 0644);
+   if ( fileDescriptor < 0 )
+      return false;
+   
+   bool written = true;
+   while ( written && !contents.empty() )
+   {
+      ssize_t count = ::write(fileDescriptor, contents.data(), contents.size());
+      if ( count < 0 && errno != EINTR )
+         written = false;
+      else if ( count > 0 )
+         contents.remove_prefix(count);
+   }
+   written = written && fsync(fileDescriptor) == 0;
+   ::close(fileDescriptor);
+   if ( !written || std::rename(tempName.c_str(), fileName.c_str()) != 0 )
+      return false;
+   
+   //sync the directory so the rename itself survives a crash
+   std::string::size_type slash = fileName.rfind('/');
+   std::string directory = slash == std::string::npos ? "."
+      : fileName.substr(0, slash + 1);
+   int directoryDescriptor = ::open(directory.c_str(), O_RDONLY);
+   if ( directoryDescriptor >= 0 )
+   {
+      fsync(directoryDescriptor);
+      ::close(directoryDescriptor);
+   }
+   return true;
+}
+
+/**
+ Formats the inventory display, reusing the text of trees that have not changed.
+ @return The buffer holding the display.
+ @pre None
+ @post Each tree whose version differs from the one last formatted will be formatted again into its
+ segment, and the display rebuilt from the segments. If no tree has changed the display is returned
+ as it is.
+ */
+const OutputBuffer& StoreInventory::formatInventory()
+{
+   bool changed = inventoryDisplay.isEmpty();
+   for ( std::size_t i = 0; i < itemSymbols.size(); i++ )
+   {
+      const SearchTree<Collectible>* tree =
+         inventoryTree[hashItem(itemSymbols[i])];
+      if ( tree->getVersion() != segmentVersions[i] )
+      {
+         inventorySegments[i].clear();
+         tree->format(inventorySegments[i]);
+         segmentVersions[i] = tree->getVersion();
+         changed = true;
+      }
+   }
+   
+   //join the segments in item type order
+   if ( changed )
+   {
+      inventoryDisplay.clear();
+      inventoryDisplay.append("Inventory: \n");
+      for ( std::size_t i = 0; i < inventorySegments.size(); i++ )
+         inventoryDisplay.append(inventorySegments[i].view());
+      inventoryDisplay.append('\n');
+   }
+   return inventoryDisplay;
+}
+
+/**
+ Returns the customers sorted by name, rebuilding the index if the customerTree has changed.
+ @return The customers in the order of the customerTree.
+ @pre None
+ @post If the customerTree's version differs from the one last indexed the customers will be
+ listed again in order, which costs O(n). Otherwise the index is returned as it is.
+ */
+const std::vector<const Customer*>& StoreInventory::getCustomersByName()
+{
+   if ( customerTree.getVersion() != customersByNameVersion )
+   {
+      customersByName.clear();
+      Customer first("", 0, "", nullptr);
+      customerTree.visitFrom(first, [this](const Customer& customer)
+         {
+            customersByName.push_back(&customer);
+            return true;
+         });
+      customersByNameVersion = customerTree.getVersion();
+   }
+   return customersByName;
+}
+
+/**
+ Hashes the symbol for a Collectible item to an index in the inventoryTree array.
+ @param itemType The char symbol for a Collectible item.
+ @return The index in the inventoryTree array.
+ @pre itemType must be a char between 'A' and 'Z'.
+ @post The index in the inventoryTree array will be returned as an array.
+ */
+int StoreInventory::hashItem(char itemType) const
+{
+   //accepts item with symbols A-Z
+   if ( itemType < 'A' || itemType > 'Z' )
+   {
+      std::cerr << "StoreInventory::hashItem: invalid argument" << std::endl;
+      return -1;
+   }
+   //return the index of the inventoryTree containing the appropriate item
+   //types
+   return (itemType - 'A') % inventoryTree.size();
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// COMMANDFACTORY IMPLEMENTATION
+/**
+ Constructs a CommandFactory object and initializes the commandFactory array with addresses of
+ subclass objects.
+ @pre None
+ @post The commandFactory array will be initialized with addresses of subclass objects.
+ */
+StoreInventory::CommandFactory::CommandFactory() :
+   factoryVector(FACTORY_SIZE, nullptr)
+{
+   factoryVector[hash('H')] = new ShowTransactHistory;
+   factoryVector[hash('B')] = new BuyItem;
+   factoryVector[hash('C')] = new ShowCustomerTransact;
+   factoryVector[hash('D')] = new DisplayInventory;
+   factoryVector[hash('S')] = new SellItem;
+   factoryVector[hash('P')] = new ShowCustomerPage;
+   factoryVector[hash('L')] = new ShowCustomerRecent;
+   factoryVector[hash('N')] = new FindCustomers;
+   factoryVector[hash('A')] = new ShowCustomerSummary;
+   factoryVector[hash('K')] = new TradeBasket;
+   factoryVector[hash('T')] = new ShowStats;
+}
+
+/**
+ Deallocates memory for objects in the commandFactory array.
+ @pre None
+ @post Memory for objects in commandFactory will be deallocated.
+ */
+StoreInventory::CommandFactory::~CommandFactory()
+{
+   for ( int i = 0; i < factoryVector.size(); i++)
+   {
+      if ( factoryVector[i] != nullptr )
+      {
+         delete factoryVector[i];
+         factoryVector[i] = nullptr;
+      }
+   }
+}
+
+/**
+ Returns the StoreCommand subclass object that executes a command.
+ @param command The char representing the command.
+ @return Returns a pointer to the StoreCommand subclass object, or nullptr if the command is unknown.
+ @pre The itemType must hash to an index in the commandFactory array.
+ @post The object is owned by the CommandFactory and must not be deleted. If command does not hash
+ to an int within the bounds of the command Factory array an error will be output.
+ */
+StoreInventory::StoreCommand*
+StoreInventory::CommandFactory::findCommand(char command) const
+{
+   int index = hash(command);
+   //ensure the index is valid
+   if ( index < 0 )
+   {
+      std::cerr << "CollectibleFactory::findCommand: command hashed to"
+      <<" negative index" << std:: endl;
+      return nullptr;
+   }
+   //nullptr if no command is registered at the index
+   return factoryVector[index];
+}
+
+/**
+ Hashes the given itemType to an int.
+ @param commandType The char symbol for the command.
+ @return The int representing an index  in the CommandFactory vector.
+ @pre None
+ @post The index of the CommandFactory vector where the subclass object is stored.
+ */
+int StoreInventory::CommandFactory::hash(char commandType) const
+{
+   if ( commandType < 'A' || commandType > 'Z' )
+   {
+      std::cerr << "CollectibleFactory::hash: invalid argument" << std::endl;
+      return -1;
+   }
+   
+   return (commandType - 'A') % factoryVector.size();
+}
+
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//TRADECOMMAND IMPLEMENTATION
+
+/**
+ Executes the trade on its own.
+ @param args The arguments of the command.
+ @param store The StoreInventory object on which the command will act.
+ @return True if the trade succeeded. False otherwise.
+ @pre The fields in 'args' must contain appropriate data.
+ @post Any trades waiting in the store's window will be applied first. The trade will then be
+ prepared, applied, and reported as a window of one.
+ */
+bool StoreInventory::TradeCommand::execute(const FieldSpan& args,
+                                           StoreInventory& store)
+{
+   //apply any waiting trades first so the trades stay in order
+   store.flushTrades();
+   store.queueTrade(*this, args);
+   return store.flushTrades();
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//SELLITEM IMPLEMENTATION
+
+/**
+ Prepares SellItem.
+ If the item to be sold is in the inventory and the customer is in the store's database, the item's count
+ is decremented or, if the item's count is one, the item is removed from the inventory. A transaction
+ containing a record of the item sold is added to the customer's transaction history.
+ @param args The arguments to execute the SellItem command.
+ @param store The StoreInventory object on which the SellItem command will act.
+ @param trade The trade to fill in.
+ @param messages The buffer receiving the error output of an invalid trade.
+ @return True if the customer and item are valid. False otherwise.
+ @pre None
+ @post The customer will be looked up and the item to sell will be created. If the customer ID,
+ item type, or item data are invalid, error messages will be appended to messages. Whether the
+ item is in the inventory is decided when the trade is applied.
+ */
+bool StoreInventory::SellItem::prepare(const FieldSpan& args,
+                                       StoreInventory& store, Trade& trade,
+                                       OutputBuffer& messages) const
+{
+   const char SELL = 'S';
+   //indices of elements in 'args'
+   const int ID = 0;
+   const int ITEM_TYPE = 1;
+   const int FIRST_DATA_ELEMENT = 2;
+   
+   //the action is counted even if the arguments are invalid
+   trade.action = SELL;
+   
+   //check the customer
+   Customer* customer = nullptr;
+   {
+      TRACE_SPAN("validate");
+      //check valid id
+      unsigned long long custKey;
+      if ( args.size() < 1 || !store.parseCustID(args[ID], custKey) )
+      {
+         messages.append("Sell Item Error: Customer ID ")
+            .append(args.size() < 1 ? std::string_view() : args[ID])
+            .append(" invalid.\n\n");
+         trade.error = CommandStats::INVALID_CUSTOMER_ID;
+         return false;
+      }
+      //check if customer exists
+      customer = store.customerDict.find(custKey);
+      if ( customer == nullptr )
+      {
+         messages.append("Sell Item Error: Customer ID ").append(args[ID])
+            .append(" not found.\n\n");
+         trade.error = CommandStats::CUSTOMER_NOT_FOUND;
          return false;
       }
    }
- 
+   
+   //create Collectible object from itemType
+   char itemType = '\0';
+   if ( args.size() > ITEM_TYPE && !args[ITEM_TYPE].empty() )
+      itemType = args[ITEM_TYPE][0];
+   Collectible* itemPtr = store.collectibleFactory.createObject(itemType);
+   
    //item was not created, invalid itemType
-   std::cout << "Sell Item Error. Invalid item type: "
-   << itemType << "\n" << std::endl;
-   return false;
-}
-
-/**
- Creates and allocates memory for a SellItem object.
- @pre None
- @post A SellItem object will be created and memory for the object will be allocated on the heap.
- */
-StoreInventory::StoreCommand* StoreInventory::SellItem::create() const
-{
-   return new SellItem;
+   if ( itemPtr == nullptr )
+   {
+      messages.append("Sell Item Error. Invalid item type: ").append(itemType)
+         .append("\n\n");
+      trade.error = CommandStats::INVALID_ITEM_TYPE;
+      return false;
+   }
+   
+   //find the appropriate inventory tree
+   int inventoryTreeIndex = store.hashItem(itemType);
+   
+   //invalid index
+   if ( inventoryTreeIndex < 0 )
+   {
+      std::cerr << "SellItem::prepare: itemType hashed to negative"
+      << " index" << std:: endl;
+      
+      //delete item
+      delete itemPtr;
+      itemPtr = nullptr;
+      trade.error = CommandStats::INVALID_ITEM_TYPE;
+      return false;
+   }
+   
+   //itemType hashed to index holding nullptr
+   if ( store.inventoryTree[inventoryTreeIndex] == nullptr )
+   {
+      delete itemPtr;
+      itemPtr = nullptr;
+      std::cerr<< "Item type hashed to index in inventoryTree holding"
+      << " nullptr.\n" << std::endl;
+      trade.error = CommandStats::INVALID_ITEM_TYPE;
+      return false;
+   }
+   
+   //set item's data from args[2]-args[args.size()-1]
+   bool validData;
+   {
+      TRACE_SPAN("setData");
+      validData = itemPtr->setData(args.subspan(FIRST_DATA_ELEMENT));
+   }
+   
+   //invalid data, delete item
+   if ( !validData )
+   {
+      delete itemPtr;
+      itemPtr = nullptr;
+      messages.append("Sell Item Error. Invalid data.\n\n");
+      trade.error = CommandStats::INVALID_DATA;
+      return false;
+   }
+   
+   trade.customer = customer;
+   trade.item = itemPtr;
+   trade.treeIndex = inventoryTreeIndex;
+   return true;
 }
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -514,20 +2421,22 @@ StoreInventory::StoreCommand* StoreInventory::SellItem::create() const
 //BUYITEM IMPLEMENTATION
 
 /**
- Executes BuyItem.
+ Prepares BuyItem.
  The item is added to the inventory or its item count is incremented if it is already in the inventory. A
  transaction containing a record of the item bought from the customer is added to the customer's
  transaction history.
  @param args The arguments to execute the BuyItem command.
  @param store The StoreInventory object on which the BuyItem command will act.
- @return True if the command was executed successfully. False otherwise.
- @pre The elements in the 'args' vector must contain appropriate data.
- @post The item is added to the inventory or its item count is incremented. The transaction is
- appended to the customer's list of transactions. If the customer is not found, an error message
- will be output.
+ @param trade The trade to fill in.
+ @param messages The buffer receiving the error output of an invalid trade.
+ @return True if the customer and item are valid. False otherwise.
+ @pre None
+ @post The customer will be looked up and the item to buy will be created. If the customer ID,
+ item type, or item data are invalid, error messages will be appended to messages.
  */
-bool StoreInventory::BuyItem::execute(
-      const std::vector<std::string>& args, StoreInventory& store)
+bool StoreInventory::BuyItem::prepare(const FieldSpan& args,
+                                      StoreInventory& store, Trade& trade,
+                                      OutputBuffer& messages) const
 {
    const char BUY = 'B';
    //indices of elements in 'args'
@@ -535,121 +2444,97 @@ bool StoreInventory::BuyItem::execute(
    const int ITEM_TYPE = 1;
    const int FIRST_DATA_ELEMENT = 2;
 
-   //check valid id
-   if ( !store.isValidCustID(args[ID]) )
+   //the action is counted even if the arguments are invalid
+   trade.action = BUY;
+   
+   //check the customer
+   Customer* customer = nullptr;
+   {
+      TRACE_SPAN("validate");
+      //check valid id
+      unsigned long long custKey;
+      if ( args.size() < 1 || !store.parseCustID(args[ID], custKey) )
+      {
+         messages.append("Buy Item Error: Customer ID ")
+            .append(args.size() < 1 ? std::string_view() : args[ID])
+            .append(" invalid.\n\n");
+         trade.error = CommandStats::INVALID_CUSTOMER_ID;
+         return false;
+      }
+      
+      //check if customer exists
+      customer = store.customerDict.find(custKey);
+      if ( customer == nullptr )
+      {
+         messages.append("Buy Item Error: Customer ID ").append(args[ID])
+            .append(" not found.\n\n");
+         trade.error = CommandStats::CUSTOMER_NOT_FOUND;
+         return false;
+      }
+   }
+   
+   //create item to add to inventory
+   char itemType = '\0';
+   if ( args.size() > ITEM_TYPE && !args[ITEM_TYPE].empty() )
+      itemType = args[ITEM_TYPE][0];
+   Collectible* itemPtr = store.collectibleFactory.createObject(itemType);
+   
+   //item was not created
+   if ( itemPtr == nullptr )
    {
-      std::cout << "Buy Item Error: Customer ID " << args[ID]
-      << " invalid.\n" << std::endl;
+      messages.append("Buy Item Error. Invalid item type:").append(itemType)
+         .append("\n\n");
+      trade.error = CommandStats::INVALID_ITEM_TYPE;
       return false;
    }
    
-   //check if customer exists
-   Customer* customer = store.customerDict[stoi(args[ID])];
-   if ( customer == nullptr )
+   //find the appropriate inventory tree
+   int inventoryTreeIndex = store.hashItem(itemType);
+   
+   //itemType hashed to invalid index
+   if ( inventoryTreeIndex < 0 )
    {
-      std::cout << "Buy Item Error: Customer ID " << args[ID]
-      << " not found.\n" << std::endl;
+      std::cerr << "BuyItem::prepare: itemType hashed to negative index"
+      << std:: endl;
+      //delete item
+      delete itemPtr;
+      itemPtr = nullptr;
+      trade.error = CommandStats::INVALID_ITEM_TYPE;
       return false;
    }
    
-   //create item to add to inventory
-   char itemType = (args[ITEM_TYPE])[0];
-   Collectible* itemPtr = store.collectibleFactory.createObject(itemType);
+   //itemType hashed to index holding nullptr
+   if ( store.inventoryTree[inventoryTreeIndex] == nullptr )
+   {
+      delete itemPtr;
+      itemPtr = nullptr;
+      std::cerr<< "Item type hashed to index in inventoryTree holding"
+      << " nullptr.\n" << std::endl;
+      trade.error = CommandStats::INVALID_ITEM_TYPE;
+      return false;
+   }
    
-   //create subvector of data elements from args[2]-args[args.size()-1]
-   std::vector<std::string>::const_iterator first = args.begin()
-      + FIRST_DATA_ELEMENT;
-   std::vector<std::string>::const_iterator last = args.end();
-   std::vector<std::string> data(first, last);
+   //set item's data from args[2]-args[args.size()-1]
+   bool validData;
+   {
+      TRACE_SPAN("setData");
+      validData = itemPtr->setData(args.subspan(FIRST_DATA_ELEMENT));
+   }
    
-   //Collectible item was created
-   if ( itemPtr != nullptr )
+   //invalid data, delete item
+   if ( !validData )
    {
-      //find the appropriate inventory tree
-      int inventoryTreeIndex = store.hashItem(itemType);
-      
-      //itemType hashed to invalid index
-      if ( inventoryTreeIndex < 0 )
-      {
-         std::cerr << "BuyItem::execute: itemType hashed to negative index"
-         << std:: endl;
-         //delete item
-         delete itemPtr;
-         itemPtr = nullptr;
-         return false;
-      }
-      //item hashed to index holding SearchTree
-      if ( store.inventoryTree[inventoryTreeIndex] != nullptr )
-      {
-         //set item's data
-         //if data is valid
-         if ( itemPtr->setData(data) )
-         {
-            //add item to inventory
-            bool inserted =
-               store.inventoryTree[inventoryTreeIndex]->insert(itemPtr);
-            
-            //item was incremented in inventory
-            //add item to customer's transactions
-            if ( store.inventoryTree[inventoryTreeIndex]->contains(*itemPtr)
-                && !inserted )
-            {
-               customer->addTransaction(BUY, itemPtr);
-               return true;
-            }
-            //item was added to inventory
-            //add copy of item to customer's transactions
-            if ( inserted )
-            {
-               Collectible* itemCopy =
-                  store.collectibleFactory.createObject(itemType);
-               itemCopy->setData(data);
-               
-               customer->addTransaction(BUY, itemCopy);
-               return true;
-            }
-            //item could not be added to inventory
-            if ( !inserted )
-            {
-               //delete item
-               delete itemPtr;
-               itemPtr = nullptr;
-               std::cerr << "Error adding item to inventory.\n" << std::endl;
-               return false;
-            }
-         }
-         else //invalid data, delete item
-         {
-            delete itemPtr;
-            itemPtr = nullptr;
-            std::cout << "Buy Item Error. Invalid data.\n" << std::endl;
-            return false;
-         }
-      }
-      else //itemType hashed to index holding nullptr
-      {
-         delete itemPtr;
-         itemPtr = nullptr;
-         std::cerr<< "Item type hashed to index in inventoryTree holding"
-         << " nullptr.\n" << std::endl;
-         return false;
-      }
+      delete itemPtr;
+      itemPtr = nullptr;
+      messages.append("Buy Item Error. Invalid data.\n\n");
+      trade.error = CommandStats::INVALID_DATA;
+      return false;
    }
-
-   //item was not created
-   std::cout << "Buy Item Error. Invalid item type:" << itemType
-   << "\n" << std::endl;
-   return false;
-}
-
-/**
- Creates and allocates memory for a BuyItem object.
- @pre None
- @post A BuyItem object will be created and memory for the object will be allocated on the heap.
- */
-StoreInventory::StoreCommand* StoreInventory::BuyItem::create() const
-{
-   return new BuyItem;
+   
+   trade.customer = customer;
+   trade.item = itemPtr;
+   trade.treeIndex = inventoryTreeIndex;
+   return true;
 }
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -661,48 +2546,188 @@ StoreInventory::StoreCommand* StoreInventory::BuyItem::create() const
  Displays all transactions for the given customer in chronological order.
  @param args The arguments to execute the ShowCustomerTransact command.
  @return True if the command was executed successfully. False otherwise.
- @pre The element in the 'args' vector must contain an appropriate customer ID number stored
+ @pre The field in 'args' must contain an appropriate customer ID number stored
  at arg[0].
  @post All the transactions for the given customer will be output in chronological order with 1
  transaction per line.
  */
 bool StoreInventory::ShowCustomerTransact::execute(
-      const std::vector<std::string>& args, StoreInventory& store)
+      const FieldSpan& args, StoreInventory& store)
 {
    const int ID = 0;
 
    //check valid id
-   if ( !store.isValidCustID(args[ID]) )
+   unsigned long long custKey;
+   if ( args.size() < 1 || !store.parseCustID(args[ID], custKey) )
    {
-      std::cout << "Customer ID " << args[ID]
-      << " invalid.\n" << std::endl;
+      store.outputSink.write("Customer ID ")
+         .write(args.size() < 1 ? std::string_view() : args[ID])
+         .write(" invalid.\n\n");
+      store.commandStats.countError(CommandStats::INVALID_CUSTOMER_ID);
       return false;
    }
    
    //check if customer exists
-   Customer* customer = store.customerDict[stoi(args[ID])];
+   Customer* customer = store.customerDict.find(custKey);
    if ( customer == nullptr )
    {
-      std::cout << "Customer ID " << args[ID]
-      << " not found.\n" << std::endl;
+      store.outputSink.write("Customer ID ").write(args[ID])
+         .write(" not found.\n\n");
+      store.commandStats.countError(CommandStats::CUSTOMER_NOT_FOUND);
       return false;
    }
    //customer found, output id, name, and transactions
-   std::cout << *customer;
+   store.reportBuffer.clear();
+   customer->format(store.reportBuffer);
+   store.outputSink.write(store.reportBuffer);
    
    return true;
 }
 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//SHOWCUSTOMERPAGE IMPLEMENTATION
+
 /**
- Creates and allocates memory for a ShowCustomerTransact object.
- @pre None
- @post A ShowCustomerTransact object will be created and memory for the object will be allocated
- on the heap.
+ Executes ShowCustomerPage.
+ Displays at most 'limit' transactions of the given customer, starting 'offset' transactions after
+ the first, in chronological order. The output is written in one block.
+ @param args The arguments to execute the ShowCustomerPage command.
+ @param store The StoreInventory object on which the command will act.
+ @return True if the command was executed successfully. False otherwise.
+ @pre args[0] must contain an appropriate customer ID number, args[1] the offset and args[2] the
+ limit.
+ @post The transactions in the window will be output in chronological order with 1 transaction per
+ line. If the customer is not found or the offset or limit are invalid an error message will be
+ output.
  */
-StoreInventory::StoreCommand*
-StoreInventory::ShowCustomerTransact::create() const
+bool StoreInventory::ShowCustomerPage::execute(
+      const FieldSpan& args, StoreInventory& store)
+{
+   const int ID = 0;
+   const int OFFSET = 1;
+   const int LIMIT = 2;
+   const int NUM_ARGS = 3;
+   
+   if ( args.size() != NUM_ARGS )
+   {
+      store.outputSink.write("Customer Page Error: expected customer ID,"
+                             " offset, and limit.\n\n");
+      store.commandStats.countError(CommandStats::INVALID_ARGUMENTS);
+      return false;
+   }
+   
+   //check valid id
+   unsigned long long custKey;
+   if ( !store.parseCustID(args[ID], custKey) )
+   {
+      store.outputSink.write("Customer ID ").write(args[ID])
+         .write(" invalid.\n\n");
+      store.commandStats.countError(CommandStats::INVALID_CUSTOMER_ID);
+      return false;
+   }
+   
+   //check valid window
+   std::size_t offset;
+   std::size_t limit;
+   if ( !store.parseCount(args[OFFSET], offset)
+       || !store.parseCount(args[LIMIT], limit) )
+   {
+      store.outputSink.write("Customer Page Error: invalid offset or limit: ")
+         .write(args[OFFSET]).write(", ").write(args[LIMIT]).write("\n\n");
+      store.commandStats.countError(CommandStats::INVALID_ARGUMENTS);
+      return false;
+   }
+   
+   //check if customer exists
+   Customer* customer = store.customerDict.find(custKey);
+   if ( customer == nullptr )
+   {
+      store.outputSink.write("Customer ID ").write(args[ID])
+         .write(" not found.\n\n");
+      store.commandStats.countError(CommandStats::CUSTOMER_NOT_FOUND);
+      return false;
+   }
+   
+   //customer found, output id, name, and the window of transactions
+   store.reportBuffer.clear();
+   customer->formatPage(store.reportBuffer, offset, limit);
+   store.outputSink.write(store.reportBuffer);
+   
+   return true;
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//SHOWCUSTOMERRECENT IMPLEMENTATION
+
+/**
+ Executes ShowCustomerRecent.
+ Displays the last N transactions of the given customer in chronological order. The output is
+ written in one block.
+ @param args The arguments to execute the ShowCustomerRecent command.
+ @param store The StoreInventory object on which the command will act.
+ @return True if the command was executed successfully. False otherwise.
+ @pre args[0] must contain an appropriate customer ID number and args[1] the number of
+ transactions to show.
+ @post The customer's last N transactions will be output in chronological order with 1 transaction
+ per line. If the customer is not found or N is invalid an error message will be output.
+ */
+bool StoreInventory::ShowCustomerRecent::execute(
+      const FieldSpan& args, StoreInventory& store)
 {
-   return new ShowCustomerTransact;
+   const int ID = 0;
+   const int COUNT = 1;
+   const int NUM_ARGS = 2;
+   
+   if ( args.size() != NUM_ARGS )
+   {
+      store.outputSink.write("Customer Recent Error: expected customer ID and"
+                             " number of transactions.\n\n");
+      store.commandStats.countError(CommandStats::INVALID_ARGUMENTS);
+      return false;
+   }
+   
+   //check valid id
+   unsigned long long custKey;
+   if ( !store.parseCustID(args[ID], custKey) )
+   {
+      store.outputSink.write("Customer ID ").write(args[ID])
+         .write(" invalid.\n\n");
+      store.commandStats.countError(CommandStats::INVALID_CUSTOMER_ID);
+      return false;
+   }
+   
+   //check valid number of transactions
+   std::size_t count;
+   if ( !store.parseCount(args[COUNT], count) )
+   {
+      store.outputSink
+         .write("Customer Recent Error: invalid number of transactions: ")
+         .write(args[COUNT]).write("\n\n");
+      store.commandStats.countError(CommandStats::INVALID_ARGUMENTS);
+      return false;
+   }
+   
+   //check if customer exists
+   Customer* customer = store.customerDict.find(custKey);
+   if ( customer == nullptr )
+   {
+      store.outputSink.write("Customer ID ").write(args[ID])
+         .write(" not found.\n\n");
+      store.commandStats.countError(CommandStats::CUSTOMER_NOT_FOUND);
+      return false;
+   }
+   
+   //the window ends at the customer's latest transaction
+   std::size_t total = customer->getTransactionCount();
+   std::size_t offset = count < total ? total - count : 0;
+   
+   store.reportBuffer.clear();
+   customer->formatPage(store.reportBuffer, offset, count);
+   store.outputSink.write(store.reportBuffer);
+   
+   return true;
 }
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -720,24 +2745,123 @@ StoreInventory::ShowCustomerTransact::create() const
  customer's name. One transaction will be output per line.
  */
 bool StoreInventory::ShowTransactHistory::execute(
-   const std::vector<std::string>& args, StoreInventory& store )
+   const FieldSpan& args, StoreInventory& store )
 {
-   std::cout << "Transaction History: " << std::endl;
+   store.reportBuffer.clear();
+   store.reportBuffer.append("Transaction History: \n");
    //print customer's in alphabetical order, including their transactions
-   store.customerTree.printWithoutCounts();
+   store.customerTree.formatWithoutCounts(store.reportBuffer);
+   store.outputSink.write(store.reportBuffer);
+   return true;
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//SHOWCUSTOMERSUMMARY IMPLEMENTATION
+
+/**
+ Executes ShowCustomerSummary.
+ Displays the number of transactions made by the given customer, the sequence numbers of their
+ first and last transactions, and the number of items bought and sold of each item type. The totals
+ are maintained as transactions are added, so the command runs in constant time.
+ @param args The arguments to execute the ShowCustomerSummary command.
+ @param store The StoreInventory object on which the command will act.
+ @return True if the command was executed successfully. False otherwise.
+ @pre args[0] must contain an appropriate customer ID number.
+ @post The customer's summary will be output. If the customer is not found an error message will
+ be output.
+ */
+bool StoreInventory::ShowCustomerSummary::execute(
+      const FieldSpan& args, StoreInventory& store)
+{
+   const int ID = 0;
+   
+   //check valid id
+   unsigned long long custKey;
+   if ( args.size() < 1 || !store.parseCustID(args[ID], custKey) )
+   {
+      store.outputSink.write("Customer ID ")
+         .write(args.size() < 1 ? std::string_view() : args[ID])
+         .write(" invalid.\n\n");
+      store.commandStats.countError(CommandStats::INVALID_CUSTOMER_ID);
+      return false;
+   }
+   
+   //check if customer exists
+   Customer* customer = store.customerDict.find(custKey);
+   if ( customer == nullptr )
+   {
+      store.outputSink.write("Customer ID ").write(args[ID])
+         .write(" not found.\n\n");
+      store.commandStats.countError(CommandStats::CUSTOMER_NOT_FOUND);
+      return false;
+   }
+   
+   //customer found, output id, name, and totals
+   store.reportBuffer.clear();
+   customer->formatSummary(store.reportBuffer);
+   store.outputSink.write(store.reportBuffer);
+   
    return true;
 }
 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//FINDCUSTOMERS IMPLEMENTATION
+
 /**
- Creates and allocates memory for a ShowTransactHistory object.
- @pre None
- @post A ShowTransactHistory object will be created and memory for the object will be allocated on the
- heap.
+ Executes FindCustomers.
+ Displays the ID and name of every customer whose name starts with the given prefix, in
+ alphabetical order by name. The first match is found by a binary search of the customers sorted
+ by name, so a query costs O(log n + k) for k matches however the customerTree is shaped.
+ @param args The arguments to execute the FindCustomers command.
+ @param store The StoreInventory object on which the command will act.
+ @return True if the command was executed successfully. False otherwise.
+ @pre args[0] must contain the name prefix.
+ @post The matching customers will be output one per line. If none match "none" will be output. If
+ the prefix contains characters other than letters or spaces an error message will be output.
  */
-StoreInventory::StoreCommand*
-StoreInventory::ShowTransactHistory::create() const
+bool StoreInventory::FindCustomers::execute(
+      const FieldSpan& args, StoreInventory& store)
 {
-   return new ShowTransactHistory;
+   const int PREFIX = 0;
+   
+   //check valid prefix
+   if ( args.size() != 1 || !store.isValidCustName(args[PREFIX]) )
+   {
+      store.outputSink.write("Find Customers Error: invalid name prefix.\n\n");
+      store.commandStats.countError(CommandStats::INVALID_ARGUMENTS);
+      return false;
+   }
+   std::string_view prefix = args[PREFIX];
+   
+   store.reportBuffer.clear();
+   store.reportBuffer.append("Customers matching \"").append(prefix)
+      .append("\":\n");
+   
+   //customers are ordered by name, so the matches start at the first name
+   //not less than the prefix and end at the first name without it
+   const std::vector<const Customer*>& customers = store.getCustomersByName();
+   std::vector<const Customer*>::const_iterator match =
+      std::lower_bound(customers.begin(), customers.end(), prefix,
+                       [](const Customer* customer, std::string_view name)
+      {
+         return customer->getName() < name;
+      });
+   int numFound = 0;
+   for ( ; match != customers.end()
+        && (*match)->getName().compare(0, prefix.size(), prefix) == 0; match++ )
+   {
+      (*match)->formatHeader(store.reportBuffer);
+      store.reportBuffer.append('\n');
+      numFound++;
+   }
+   
+   if ( numFound == 0 )
+      store.reportBuffer.append("none\n");
+   store.reportBuffer.append('\n');
+   store.outputSink.write(store.reportBuffer);
+   return true;
 }
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -756,29 +2880,166 @@ StoreInventory::ShowTransactHistory::create() const
  @post Each item in the inventory and its count will be output to the console.
  */
 bool StoreInventory::DisplayInventory::execute(
-   const std::vector<std::string>& args, StoreInventory& store)
+   const FieldSpan& args, StoreInventory& store)
 {
-   std::cout << "Inventory: " << std::endl;
-   //print the inventory tree for each Collectible type
-   for ( int i = 0; i < store.itemSymbols.size(); i++ )
-   {
-      int index = store.hashItem( store.itemSymbols[i] );
-      std::cout << *store.inventoryTree[index];
-   }
-   std::cout << std::endl;
+   store.outputSink.write(store.formatInventory());
    return true;
 }
 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//TRADEBASKET IMPLEMENTATION
+
 /**
- Creates and allocates memory for a DisplayInventory object.
+ Executes TradeBasket.
+ The arguments are the action, 'S' or 'B', the customer ID, and then each item as its type
+ followed by its data fields. The customer is looked up once and every item is created and
+ validated before the inventory is changed. The basket is then applied by applyBasket.
+ @param args The arguments to execute the TradeBasket command.
+ @param store The StoreInventory object on which the command will act.
+ @return True if the basket was traded. False otherwise.
  @pre None
- @post A DisplayInventory object will be created and memory for the object will be allocated on the heap.
+ @post If the action, customer, and every item are valid and, for a sale, every item is in the
+ inventory as many times as the basket holds it, every item will be traded and a transaction for
+ each added to the customer's history. Otherwise an error message will be output and neither the
+ inventory nor the customer will change.
  */
-StoreInventory::StoreCommand*
-StoreInventory::DisplayInventory::create() const
+bool StoreInventory::TradeBasket::execute(const FieldSpan& args,
+                                          StoreInventory& store)
 {
-   return new DisplayInventory;
+   const char SELL = 'S';
+   const char BUY = 'B';
+   //indices of elements in 'args'
+   const int ACTION = 0;
+   const int ID = 1;
+   const int FIRST_ITEM = 2;
+   
+   //check valid action
+   char action = '\0';
+   if ( args.size() > ACTION && args[ACTION].size() == 1 )
+      action = args[ACTION][0];
+   if ( action != SELL && action != BUY )
+   {
+      store.outputSink.write("Basket Error. Invalid action: ")
+         .write(args.size() > ACTION ? args[ACTION] : std::string_view())
+         .write("\n\n");
+      store.commandStats.countError(CommandStats::INVALID_ARGUMENTS);
+      return false;
+   }
+   
+   //a basket without a customer ID has nothing to report as invalid
+   if ( args.size() <= ID || args[ID].empty() )
+   {
+      store.outputSink.write("Basket Error: expected action and customer"
+                             " ID.\n\n");
+      store.commandStats.countError(CommandStats::INVALID_ARGUMENTS);
+      return false;
+   }
+   
+   //check valid id
+   unsigned long long custKey;
+   if ( !store.parseCustID(args[ID], custKey) )
+   {
+      store.outputSink.write("Basket Error: Customer ID ").write(args[ID])
+         .write(" invalid.\n\n");
+      store.commandStats.countError(CommandStats::INVALID_CUSTOMER_ID);
+      return false;
+   }
+   //check if customer exists, once for the whole basket
+   Customer* customer = store.customerDict.find(custKey);
+   if ( customer == nullptr )
+   {
+      store.outputSink.write("Basket Error: Customer ID ").write(args[ID])
+         .write(" not found.\n\n");
+      store.commandStats.countError(CommandStats::CUSTOMER_NOT_FOUND);
+      return false;
+   }
+   
+   //create every item of the basket before any is traded
+   std::vector<Trade>& items = store.basketTrades;
+   bool valid = true;
+   std::size_t position = FIRST_ITEM;
+   while ( valid && position < args.size() )
+   {
+      char itemType = args[position].empty() ? '\0' : args[position][0];
+      Collectible* itemPtr = store.collectibleFactory.createObject(itemType);
+      int treeIndex = itemPtr == nullptr ? -1 : store.hashItem(itemType);
+      if ( treeIndex < 0 || store.inventoryTree[treeIndex] == nullptr )
+      {
+         delete itemPtr;
+         store.outputSink.write("Basket Error. Invalid item type: ")
+            .write(itemType).write("\n\n");
+         store.commandStats.countError(CommandStats::INVALID_ITEM_TYPE);
+         valid = false;
+         continue;
+      }
+      
+      //each type of item has its own number of data fields
+      store.commandStats.countItemsCreated(1);
+      FieldSpan data = args.subspan(position + 1, itemPtr->getFieldCount());
+      if ( !itemPtr->setData(data) )
+      {
+         delete itemPtr;
+         store.outputSink.write("Basket Error. Invalid data.\n\n");
+         store.commandStats.countError(CommandStats::INVALID_DATA);
+         valid = false;
+         continue;
+      }
+      position += 1 + data.size();
+      
+      items.push_back(Trade());
+      Trade& trade = items.back();
+      trade.action = action;
+      trade.customer = customer;
+      trade.item = itemPtr;
+      trade.treeIndex = treeIndex;
+      trade.prepared = true;
+      trade.succeeded = false;
+      trade.itemInTree = false;
+      trade.commandNumber = store.commandNumber;
+   }
+   
+   if ( valid && items.empty() )
+   {
+      store.outputSink.write("Basket Error. No items.\n\n");
+      store.commandStats.countError(CommandStats::INVALID_ARGUMENTS);
+      valid = false;
+   }
+   
+   //an invalid item rejects the whole basket
+   if ( !valid )
+   {
+      for ( std::size_t i = 0; i < items.size(); i++ )
+         delete items[i].item;
+      items.clear();
+      return false;
+   }
+   
+   return store.applyBasket();
 }
 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+//SHOWSTATS IMPLEMENTATION
 
+/**
+ Executes ShowStats.
+ Outputs a line for each command type executed, with the number that succeeded and failed and
+ their latency percentiles in microseconds, followed by the count of each kind of error and of
+ the items created, transactions added, and inventory tree operations.
+ @param args The arguments needed to execute the command.
+ @param store The StoreInventory object on which the command will be executed.
+ @return True.
+ @pre None
+ @post The statistics will be output. The store will not change.
+ */
+bool StoreInventory::ShowStats::execute(const FieldSpan& /*args*/,
+                                        StoreInventory& store)
+{
+   store.reportBuffer.clear();
+   store.reportBuffer.append("Command Statistics:\n");
+   store.commandStats.format(store.reportBuffer);
+   store.reportBuffer.append('\n');
+   store.outputSink.write(store.reportBuffer);
+   return true;
+}
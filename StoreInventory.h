@@ -1,37 +1,63 @@
 /*
  file name: StoreInventory.h
  author: Hall, Ashley
- The StoreInventory class keeps track of a store’s inventory of collectible items,
- its customers, and customer transactions. The class initializes its inventory
- and customers from an inventory file and customer file, respectively. Customer
- transactions including commands to display the inventory, display a given
- customer’s transaction history, and display transaction histories for all
- customers are processed from a third file. Customer data are stored in a
- SearchTree object and a dictionary, both containing Customer pointers.The
- store’s item inventory will be implemented with an array of SearchTree objects
- storing Collectible pointers (one tree for each Collectible subclass).
- The StoreInventory class will assume ownership for the memory of the
- allocated SearchTrees. The SearchTree class will assume ownership for the
- memory of the pointed-to Collectible objects and Customer objects.
- The Customer class will assume ownership of the memory for the transaction
- structs and Collectible objects pointed to in the Customer's transactions
- vector. The Store class will also contain the following nested classes which
- are used to execute the commands read from the third file: CommandFactory,
- StoreCommand, and StoreCommand’s subclasses.
+ The StoreInventory class keeps track of a store’s inventory of collectible
+ items, its customers, and customer transactions. The class initializes its
+ inventory and customers from an inventory file and customer file,
+ respectively. Customer transactions including commands to display the
+ inventory, display a given customer’s transaction history, and display
+ transaction histories for all customers are processed from a third file.
+ Customer data are stored in a SearchTree object and a hash index by customer
+ ID, both containing Customer pointers. The store’s item inventory will be
+ implemented with an array of SearchTree objects storing Collectible pointers
+ (one tree for each Collectible subclass). The StoreInventory class will
+ assume ownership for the memory of the allocated SearchTrees. The SearchTree
+ class will assume ownership for the memory of the pointed-to Collectible
+ objects and Customer objects. Every transaction is appended to the store's
+ TransactionLog and refers to its item by ID in the store's ItemCatalog, which
+ assumes ownership of the memory for one copy of every item traded. Lines read
+ from the input files are split into views of their comma separated entries by
+ a LineTokenizer, so the entries are not copied. Command output is written
+ through a buffered OutputSink to standard output or a file, and errors in the
+ input files through a separate sink. The buy and sell commands applied can be
+ recorded in a WriteAheadLog with periodic checkpoints of the whole store,
+ from which the store is restored after a crash. A basket command buys or
+ sells several items for one customer as a single transaction that succeeds or
+ fails as a whole. The time taken by every command and the errors it reports
+ are collected in CommandStats, shown by a stats command. The phases of
+ loading and of each command are marked with Trace spans. The Store class will
+ also contain the following nested classes which are used to execute the
+ commands read from the third file: CommandFactory, StoreCommand, and
+ StoreCommand’s subclasses.
  */
 
 #ifndef STOREINVENTORY_H
 #define STOREINVENTORY_H
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
-#include <sstream>
+#include <string>
+#include <string_view>
 #include <fstream>
+#include <functional>
 
 #include "Comparable.h"
 #include "Customer.h"
+#include "CustomerIndex.h"
+#include "ItemCatalog.h"
+#include "TransactionLog.h"
 #include "SearchTree.h"
 #include "CollectibleFactory.h"
+#include "OutputBuffer.h"
+#include "FieldSpan.h"
+#include "LineTokenizer.h"
+#include "WorkerPool.h"
+#include "SpscQueue.h"
+#include "OutputSink.h"
+#include "WriteAheadLog.h"
+#include "LatencyHistogram.h"
+#include "CommandStats.h"
 
 class StoreInventory
 {
@@ -58,10 +84,163 @@ public:
     described in the program specification.
     @post The customerTree and customerDict will contain pointers to the same Customer
     objects created from the file input, and nodes will be indexed in the customerTree alphabetically
-    by the customer's name.
+    by the customer's name. The customerDict is sized from the number of lines in the file before
+    any customer is added.
     */
    void addCustomersFromFile(std::ifstream& customerFile);
    
+   /**
+    Adds customers from the contents of a customer file.
+    @param contents The text of the file.
+    @pre contents contains properly formatted data as described in the program specification.
+    @post The customerTree and customerDict will hold the same customers addCustomersFromFile would add
+    for a file holding contents. The lines are parsed in place without being copied.
+    */
+   void addCustomersFromText(std::string_view contents);
+   
+   /**
+    Makes room for a number of customers in the customer index.
+    @param count The number of customers expected.
+    @pre None
+    @post count customers can be added without the customer index growing.
+    */
+   void reserveCustomers(std::size_t count);
+   
+   /**
+    Sets the number of threads that parse customer and inventory text.
+    @param threadCount The number of threads. 1 parses on the calling thread only.
+    @pre None
+    @post addCustomersFromText and buildInventoryFromText will split text longer than one chunk into
+    line-aligned chunks, parse them on threadCount threads, and apply the results in file order. The
+    results and error messages are the same as parsing serially.
+    */
+   void setLoaderThreads(int threadCount);
+   
+   /**
+    Sets the number of buy and sell commands applied together.
+    @param windowSize The number of consecutive buy and sell commands read before they are applied. 1
+    applies each command as it is read.
+    @pre None
+    @post Up to windowSize consecutive buy and sell commands will be applied to the inventory in a
+    merged pass per tree. Any other command applies the waiting commands first. The output and
+    transactions will be the same as applying each command as it is read.
+    */
+   void setTradeWindow(std::size_t windowSize);
+   
+   /**
+    Sets the number of threads that apply a window of trades.
+    @param threadCount The number of threads. 1 applies every tree on the calling thread.
+    @pre None
+    @post The buy and sell commands of a window will be applied to the different inventory trees on
+    up to threadCount threads at once. Each tree is updated by one thread only, and the output and
+    transactions are still produced in command file order, so the results will be the same as
+    applying the window on one thread.
+    */
+   void setTradeThreads(int threadCount);
+   
+   /**
+    Sets whether command lines are parsed on a thread of their own.
+    @param enabled True to parse the command lines on a parser thread while the calling thread executes
+    them. False to parse and execute each line on the calling thread.
+    @pre None
+    @post When enabled, processCommandsFromFile and processCommandsFromText will read, split, and
+    validate the command lines on a parser thread, which passes the typed command records to the
+    calling thread through an SpscQueue. The output and results will be the same as processing the
+    commands on one thread.
+    */
+   void setPipelined(bool enabled);
+   
+   /**
+    Sends the store's reports and command errors to a file instead of standard output.
+    @param fileName The name of the file. It is created or truncated.
+    @return True if the file was opened. False otherwise.
+    @pre None
+    @post Output already written will be flushed to its previous destination.
+    */
+   bool setOutputFile(const std::string& fileName);
+   
+   /**
+    Sends the error messages for the customer and inventory files to a file instead of standard error.
+    @param fileName The name of the file. It is created or truncated.
+    @return True if the file was opened. False otherwise.
+    @pre None
+    @post Later error messages will be written to the file.
+    */
+   bool setErrorFile(const std::string& fileName);
+   
+   /**
+    Sets whether the store's output is flushed after every command.
+    @param enabled True to write the output of each command as soon as it has executed. False to
+    collect the output in a large buffer.
+    @pre None
+    @post The output sink will flush at the end of every command if enabled is true.
+    */
+   void setFlushEachCommand(bool enabled);
+   
+   /**
+    Writes any output the store is holding.
+    @pre None
+    @post The report and error output written so far will have been passed to the operating system.
+    */
+   void flushOutput();
+   
+   /**
+    Records the store's buy and sell commands in a write-ahead log with checkpoints, restoring the
+    store from them if an earlier run left them in the directory.
+    @param directory The directory holding the checkpoint and log files. It is created if it does
+    not exist.
+    @param recovered Set to true if the store was restored from an earlier run.
+    @return True if the files were opened and any checkpoint and log read. False otherwise.
+    @pre No customers, items, or commands may have been added to the store.
+    @post If the directory holds a checkpoint the store will hold its customers, inventory, and
+    transactions with the logged commands applied after them, and processCommandsFromFile and
+    processCommandsFromText will skip the command lines up to the last trade recovered, while
+    processCommandsFromStream and processCommand will number new commands after it. Otherwise a
+    checkpoint will be written before the first command. Every window of trades will be logged and
+    synced to disk before its results are output.
+    */
+   bool openLog(const std::string& directory, bool& recovered);
+   
+   /**
+    Sets how many logged commands are kept before a checkpoint replaces them.
+    @param recordCount The number of log records that starts a checkpoint.
+    @pre None
+    @post A checkpoint will be written after the window of trades that brings the log to recordCount
+    records.
+    */
+   void setCheckpointInterval(std::size_t recordCount);
+   
+   /**
+    Writes a checkpoint of the store and empties the log.
+    @return True if the checkpoint was written. False if no log is open or a file could not be written.
+    @pre No trades may be waiting in the window.
+    @post The checkpoint file will be replaced atomically by one holding the customers, inventory,
+    item catalog, and transactions, and the log will hold no records.
+    */
+   bool checkpoint();
+   
+   /**
+    Saves the whole store in a binary snapshot file.
+    @param fileName The name of the file. It is created or replaced.
+    @return True if the snapshot was written. False otherwise.
+    @pre None
+    @post Any trades waiting in the window will be applied first. The file will hold the customers,
+    inventory trees with their counts, item catalog, and transactions in the versioned snapshot format,
+    and will be replaced atomically.
+    */
+   bool saveSnapshot(const std::string& fileName);
+   
+   /**
+    Restores the whole store from a binary snapshot file, instead of customer and inventory files.
+    @param fileName The name of the file.
+    @return True if the snapshot was read and restored. False if it could not be opened, is damaged, or
+    was written by another version of the format.
+    @pre No customers or items may have been added to the store.
+    @post The store will hold the customers, inventory, and transactions saved in the snapshot. The file
+    is mapped into memory and its fields copied out directly, without text being split or validated.
+    */
+   bool loadSnapshot(const std::string& fileName);
+   
    /**
     Adds Collectible objects to the inventory from a file.
     @param inventoryFile The file to read.
@@ -73,6 +252,15 @@ public:
     */
    void buildInventoryFromFile(std::ifstream& inventoryFile);
    
+   /**
+    Adds Collectible objects to the inventory from the contents of an inventory file.
+    @param contents The text of the file.
+    @pre contents contains properly formatted data as described in the program specification.
+    @post The inventory will hold the same items buildInventoryFromFile would add for a file holding
+    contents. The lines are parsed in place without being copied.
+    */
+   void buildInventoryFromText(std::string_view contents);
+   
    
    /**
     Processes store commands from a file.
@@ -88,9 +276,130 @@ public:
     */
    void processCommandsFromFile(std::ifstream& commandFile);
    
+   /**
+    Processes store commands from the contents of a command file.
+    @param contents The text of the file.
+    @pre contents contains properly formatted data as described in the program specification.
+    @post The commands will be executed in order with the same results as processCommandsFromFile for
+    a file holding contents. The lines are parsed in place without being copied.
+    */
+   void processCommandsFromText(std::string_view contents);
+   
+   /**
+    Processes store commands as they arrive on a pipe, FIFO, or terminal.
+    @param fileDescriptor The descriptor to read the commands from.
+    @param flushEachCommand True to apply and output each command as soon as its line is read. False
+    to apply the commands of each read together, as one window of trades, and output them at once.
+    @return True if the end of the input was reached. False if a read was interrupted by a signal or
+    failed.
+    @pre None
+    @post Every complete line read will have been executed in order, with the same results as
+    processCommandsFromFile, and its output written. The time from the read that delivered each line
+    until its output was written is recorded in the stream latencies.
+    */
+   bool processCommandsFromStream(int fileDescriptor, bool flushEachCommand);
+   
+   /**
+    Returns the latencies of the commands processed by processCommandsFromStream.
+    @pre None
+    @post The histogram of the per-command latencies in nanoseconds will be returned.
+    */
+   const LatencyHistogram& getStreamLatencies() const;
+   
+   /**
+    Returns the statistics of the commands processed.
+    @pre None
+    @post The latencies of each command type and the error and operation counters will be returned.
+    */
+   const CommandStats& getCommandStats() const;
+   
+   /**
+    Executes one store command, for a caller that reads the command lines itself.
+    @param line The command line, without its line break.
+    @pre None
+    @post The command will be executed as processCommandsFromText executes its lines, except that
+    trades may wait in the window and output in the sink until finishCommands is called.
+    */
+   void processCommand(std::string_view line);
+   
+   /**
+    Applies the waiting trades and writes the output of the commands passed to processCommand.
+    @pre None
+    @post Every command processed will have been applied and its output written.
+    */
+   void finishCommands();
+   
    
 private:
    
+   class StoreCommand;
+   class TradeCommand;
+   
+   /*
+    A buy or sell command read from the command file. The command is prepared
+    (its arguments validated and its item created) when it is read, applied to
+    the inventory together with the other trades of its window, and reported
+    (error output and customer transaction) in command file order.
+    */
+   struct Trade
+   {
+      char action; //'B' or 'S'
+      Customer* customer; //the customer trading
+      Collectible* item; //the item traded, created by prepare
+      int treeIndex; //index of the item's tree in inventoryTree
+      bool prepared; //false if the arguments were invalid
+      bool succeeded; //set when the trade is applied
+      bool itemInTree; //set if the inventory tree took ownership of item
+      unsigned long long commandNumber; //line number in the command file
+      std::size_t messageStart; //start of the trade's error in tradeMessages
+      std::size_t messageEnd; //end of the trade's error in tradeMessages
+      CommandStats::ErrorKind error; //the error found by prepare
+      std::uint64_t prepareNanoseconds; //time taken by prepare
+   };
+   
+   /*
+    A node of an inventory tree inserted or removed by a trade of the window.
+    The changes are made in command file order, as executing the trades one at
+    a time would make them.
+    */
+   struct ShapeChange
+   {
+      std::size_t trade; //position in pendingTrades of the trade making the change
+      bool insert; //true if the node is inserted, false if it is removed
+      int itemCount; //the number of occurrences of an inserted item
+      bool keepsItem; //true if the node takes the trade's item, false for a copy
+   };
+   
+   /*
+    The trades of one inventory tree in a window, with the scratch space used
+    to apply them. Each batch is applied by a single thread.
+    */
+   struct TreeBatch
+   {
+      std::size_t start; //first position of the tree's trades in tradeOrder
+      std::size_t end; //position after the tree's last trade in tradeOrder
+      //distinct items of the tree looked up while applying the window
+      std::vector<SearchTree<Collectible>::CountQuery> countQueries;
+      //nodes the trades insert and remove
+      std::vector<ShapeChange> shapeChanges;
+      std::size_t treeOperations; //lookups and changes of the tree
+   };
+   
+   /*
+    A command line parsed by the parser thread of the command pipeline. Buy
+    and sell commands are prepared by the parser thread; any other command is
+    passed on as its line and split again by the executing thread.
+    */
+   struct CommandRecord
+   {
+      StoreCommand* command; //command to execute, nullptr after the last line
+      unsigned long long commandNumber; //line number in the command file
+      bool isTrade; //true if the command was prepared into trade
+      Trade trade; //the prepared buy or sell command
+      OutputBuffer messages; //error output of an invalid trade
+      std::string line; //the line of any other command
+   };
+   
    /*
     The StoreCommand class represents the various commands/actions that
     must be processed by the Store class.
@@ -110,27 +419,27 @@ private:
       virtual ~StoreCommand() {};
       
       /**
-       Executes a StoreCommand from a vector of strings.
-       @pre Store must be a store object and the elements in the 'args' vector must contain appropriate
+       Executes a StoreCommand from the fields of a command line.
+       @pre Store must be a store object and the fields in 'args' must contain appropriate
        data.
        @post The StoreCommand will be executed.
        */
-      virtual bool execute(const std::vector<std::string>& args,
+      virtual bool execute(const FieldSpan& args,
                            StoreInventory& storeInventory) = 0;
       
-      
       /**
-       Returns a pointer to a StoreCommand object.
+       Returns the command as a TradeCommand if it buys or sells an item.
        @pre None
-       @post An object from a subclass of StoreCommand will be created and a pointer to it will be
-       returned.
+       @post A pointer to the command will be returned if it is a TradeCommand. nullptr otherwise.
        */
-      virtual StoreCommand* create() const = 0;
+      virtual TradeCommand* asTradeCommand() { return nullptr; }
    };
    
    /*
-    The CommandFactory class employs a factory method to create subclasses of
-    the StoreCommand class.
+    The CommandFactory class holds one instance of each StoreCommand subclass
+    in a table indexed by the command's symbol. The commands hold no state, so
+    every command line is executed by the same instance and no object is
+    created per line.
     */
    class CommandFactory
    {
@@ -152,14 +461,15 @@ private:
       virtual ~CommandFactory();
       
       /**
-       Returns a StoreCommand subclass object.
+       Returns the StoreCommand subclass object that executes a command.
        @param command The char representing the command.
-       @return Returns a pointer to a StoreCommand subclass object.
+       @return Returns a pointer to the StoreCommand subclass object, or nullptr if the command is
+       unknown.
        @pre The itemType must hash to an index in the commandFactory array.
-       @post A StoreCommand subclass object will be returned. If command does not hash to an
-       int within the bounds of the command Factory array an error will be output.
+       @post The object is owned by the CommandFactory and must not be deleted. If command does not
+       hash to an int within the bounds of the command Factory array an error will be output.
        */
-      virtual StoreCommand* createCommand(char command) const;
+      virtual StoreCommand* findCommand(char command) const;
       
       
    private:
@@ -179,62 +489,93 @@ private:
       
    };
    
+   /*
+    The TradeCommand class represents the commands that buy or sell an item.
+    Their arguments are validated by prepare without changing the store, so
+    the inventory changes of a window of trades can be applied together.
+    */
+   class TradeCommand : public StoreCommand
+   {
+   public:
+      
+      /**
+       Executes the trade on its own.
+       @param args The arguments of the command.
+       @param store The StoreInventory object on which the command will act.
+       @return True if the trade succeeded. False otherwise.
+       @pre The fields in 'args' must contain appropriate data.
+       @post Any trades waiting in the store's window will be applied first. The trade will then be
+       prepared, applied, and reported as a window of one.
+       */
+      virtual bool execute(const FieldSpan& args, StoreInventory& store);
+      
+      /**
+       Validates the arguments of the trade and creates its item.
+       @param args The arguments of the command.
+       @param store The StoreInventory object on which the command will act.
+       @param trade The trade to fill in.
+       @param messages The buffer receiving the error output of an invalid trade.
+       @return True if the trade is valid and can be applied. False otherwise.
+       @pre None
+       @post The store will not be modified. If the trade is valid its action, customer, item, and
+       treeIndex will be set. Otherwise the output the command would print is appended to messages.
+       */
+      virtual bool prepare(const FieldSpan& args, StoreInventory& store,
+                           Trade& trade, OutputBuffer& messages) const = 0;
+      
+      /**
+       Returns the command as a TradeCommand.
+       @pre None
+       @post A pointer to the command will be returned.
+       */
+      virtual TradeCommand* asTradeCommand() { return this; }
+   };
+   
    /*
     Command to sell an item to a customer.
     */
-   class SellItem : public StoreCommand
+   class SellItem : public TradeCommand
    {
       /**
-       Executes SellItem.
+       Prepares SellItem.
        If the item to be sold is in the inventory and the customer is in the store's database, the item's count
        is decremented or, if the item's count is one, the item is removed from the inventory. A transaction
        containing a record of the item sold is added to the customer's transaction history.
        @param args The arguments to execute the SellItem command.
        @param store The StoreInventory object on which the SellItem command will act.
-       @return True if the command was executed successfully. False otherwise.
-       @pre The elements in the 'args' vector must contain appropriate data.
-       @post The item is removed from the inventory or its item count is decremented. The transaction is
-       appended to the customer's list of transactions. If the customer or item are not found, error
-       messages will be output.
-       */
-      virtual bool execute(const std::vector<std::string>& args,
-                           StoreInventory& store);
-      
-      /**
-       Creates and allocates memory for a SellItem object.
+       @param trade The trade to fill in.
+       @param messages The buffer receiving the error output of an invalid trade.
+       @return True if the customer and item are valid. False otherwise.
        @pre None
-       @post A SellItem object will be created and memory for the object will be allocated on the heap.
+       @post The customer will be looked up and the item to sell will be created. If the customer ID,
+       item type, or item data are invalid, error messages will be appended to messages. Whether the
+       item is in the inventory is decided when the trade is applied.
        */
-      virtual StoreCommand* create() const;
+      virtual bool prepare(const FieldSpan& args, StoreInventory& store,
+                           Trade& trade, OutputBuffer& messages) const;
    };
    
    /*
     Command to buy an item from a customer.
     */
-   class BuyItem : public StoreCommand
+   class BuyItem : public TradeCommand
    {
       /**
-       Executes BuyItem.
+       Prepares BuyItem.
        The item is added to the inventory or its item count is incremented if it is already in the inventory. A
        transaction containing a record of the item bought from the customer is added to the customer's
        transaction history.
        @param args The arguments to execute the BuyItem command.
        @param store The StoreInventory object on which the BuyItem command will act.
-       @return True if the command was executed successfully. False otherwise.
-       @pre The elements in the 'args' vector must contain appropriate data.
-       @post The item is added to the inventory or its item count is incremented. The transaction is
-       appended to the customer's list of transactions. If the customer is not found, an error message
-       will be output.
-       */
-      virtual bool execute(const std::vector<std::string>& args,
-                           StoreInventory& store);
-      
-      /**
-       Creates and allocates memory for a BuyItem object.
+       @param trade The trade to fill in.
+       @param messages The buffer receiving the error output of an invalid trade.
+       @return True if the customer and item are valid. False otherwise.
        @pre None
-       @post A BuyItem object will be created and memory for the object will be allocated on the heap.
+       @post The customer will be looked up and the item to buy will be created. If the customer ID,
+       item type, or item data are invalid, error messages will be appended to messages.
        */
-      virtual StoreCommand* create() const;
+      virtual bool prepare(const FieldSpan& args, StoreInventory& store,
+                           Trade& trade, OutputBuffer& messages) const;
    };
    
    
@@ -249,21 +590,59 @@ private:
        Displays all transactions for the given customer in chronological order.
        @param args The arguments to execute the ShowCustomerTransact command.
        @return True if the command was executed successfully. False otherwise.
-       @pre The element in the 'args' vector must contain an appropriate customer ID number stored
+       @pre The field in 'args' must contain an appropriate customer ID number stored
        at arg[0].
        @post All the transactions for the given customer will be output in chronological order with 1
        transaction per line.
        */
-      virtual bool execute(const std::vector<std::string>& args,
+      virtual bool execute(const FieldSpan& args,
                            StoreInventory& store);
-      
+   };
+   
+   
+   /*
+    Displays a window of a given customer's transactions in chronological
+    order, selected by an offset and a limit.
+    */
+   class ShowCustomerPage : public StoreCommand
+   {
       /**
-       Creates and allocates memory for a ShowCustomerTransact object.
-       @pre None
-       @post A ShowCustomerTransact object will be created and memory for the object will be allocated
-       on the heap.
+       Executes ShowCustomerPage.
+       Displays at most 'limit' transactions of the given customer, starting 'offset' transactions after
+       the first, in chronological order. The output is written in one block.
+       @param args The arguments to execute the ShowCustomerPage command.
+       @param store The StoreInventory object on which the command will act.
+       @return True if the command was executed successfully. False otherwise.
+       @pre args[0] must contain an appropriate customer ID number, args[1] the offset and args[2] the
+       limit.
+       @post The transactions in the window will be output in chronological order with 1 transaction per
+       line. If the customer is not found or the offset or limit are invalid an error message will be
+       output.
+       */
+      virtual bool execute(const FieldSpan& args,
+                           StoreInventory& store);
+   };
+   
+   /*
+    Displays the most recent transactions of a given customer in
+    chronological order.
+    */
+   class ShowCustomerRecent : public StoreCommand
+   {
+      /**
+       Executes ShowCustomerRecent.
+       Displays the last N transactions of the given customer in chronological order. The output is
+       written in one block.
+       @param args The arguments to execute the ShowCustomerRecent command.
+       @param store The StoreInventory object on which the command will act.
+       @return True if the command was executed successfully. False otherwise.
+       @pre args[0] must contain an appropriate customer ID number and args[1] the number of
+       transactions to show.
+       @post The customer's last N transactions will be output in chronological order with 1 transaction
+       per line. If the customer is not found or N is invalid an error message will be output.
        */
-      virtual StoreCommand* create() const;
+      virtual bool execute(const FieldSpan& args,
+                           StoreInventory& store);
    };
    
    
@@ -283,17 +662,52 @@ private:
        @post The transaction history for every customer will be output in alphabetical order by the
        customer's name. One transaction will be output per line.
        */
-      virtual bool execute(const std::vector<std::string>& args,
+      virtual bool execute(const FieldSpan& args,
                            StoreInventory& store);
       
+   };
+   
+   /*
+    Displays the totals of a given customer's transactions.
+    */
+   class ShowCustomerSummary : public StoreCommand
+   {
       /**
-       Creates and allocates memory for a ShowTransactHistory object.
-       @pre None
-       @post A ShowTransactHistory object will be created and memory for the object will be
-       allocated on the heap.
+       Executes ShowCustomerSummary.
+       Displays the number of transactions made by the given customer, the sequence numbers of their
+       first and last transactions, and the number of items bought and sold of each item type. The totals
+       are maintained as transactions are added, so the command runs in constant time.
+       @param args The arguments to execute the ShowCustomerSummary command.
+       @param store The StoreInventory object on which the command will act.
+       @return True if the command was executed successfully. False otherwise.
+       @pre args[0] must contain an appropriate customer ID number.
+       @post The customer's summary will be output. If the customer is not found an error message will
+       be output.
        */
-      virtual StoreCommand* create() const;
-      
+      virtual bool execute(const FieldSpan& args,
+                           StoreInventory& store);
+   };
+   
+   /*
+    Displays the customers whose names start with a given prefix in
+    alphabetical order.
+    */
+   class FindCustomers : public StoreCommand
+   {
+      /**
+       Executes FindCustomers.
+       Displays the ID and name of every customer whose name starts with the given prefix, in
+       alphabetical order by name. The first match is found by a binary search of the customers sorted
+       by name, so a query costs O(log n + k) for k matches however the customerTree is shaped.
+       @param args The arguments to execute the FindCustomers command.
+       @param store The StoreInventory object on which the command will act.
+       @return True if the command was executed successfully. False otherwise.
+       @pre args[0] must contain the name prefix.
+       @post The matching customers will be output one per line. If none match "none" will be output. If
+       the prefix contains characters other than letters or spaces an error message will be output.
+       */
+      virtual bool execute(const FieldSpan& args,
+                           StoreInventory& store);
    };
    
    /*
@@ -312,19 +726,74 @@ private:
        @pre None
        @post Each item in the inventory and its count will be output to the console.
        */
-      virtual bool execute(const std::vector<std::string>& args,
+      virtual bool execute(const FieldSpan& args,
                            StoreInventory& store);
-      
+   };
+   
+   /*
+    Sells or buys a basket of items for one customer as a single transaction:
+    either every item is traded or none is.
+    */
+   class TradeBasket : public StoreCommand
+   {
+      /**
+       Executes TradeBasket.
+       The arguments are the action, 'S' or 'B', the customer ID, and then each item as its type
+       followed by its data fields. The customer is looked up once and every item is created and
+       validated before the inventory is changed. The basket is then applied by applyBasket.
+       @param args The arguments to execute the TradeBasket command.
+       @param store The StoreInventory object on which the command will act.
+       @return True if the basket was traded. False otherwise.
+       @pre None
+       @post If the action, customer, and every item are valid and, for a sale, every item is in the
+       inventory as many times as the basket holds it, every item will be traded and a transaction for
+       each added to the customer's history. Otherwise an error message will be output and neither the
+       inventory nor the customer will change.
+       */
+      virtual bool execute(const FieldSpan& args,
+                           StoreInventory& store);
+   };
+   
+   /*
+    Displays the latencies and counters of the commands executed so far.
+    */
+   class ShowStats : public StoreCommand
+   {
       /**
-       Creates and allocates memory for a DisplayInventory object.
+       Executes ShowStats.
+       Outputs a line for each command type executed, with the number that succeeded and failed and
+       their latency percentiles in microseconds, followed by the count of each kind of error and of
+       the items created, transactions added, and inventory tree operations.
+       @param args The arguments needed to execute the command.
+       @param store The StoreInventory object on which the command will be executed.
+       @return True.
        @pre None
-       @post A DisplayInventory object will be created and memory for the object will be allocated on
-       the heap.
+       @post The statistics will be output. The store will not change.
        */
-      virtual StoreCommand* create() const;
+      virtual bool execute(const FieldSpan& args,
+                           StoreInventory& store);
    };
    
    //private methods for StoreInventory class
+   /**
+    Formats the inventory display, reusing the text of trees that have not changed.
+    @return The buffer holding the display.
+    @pre None
+    @post Each tree whose version differs from the one last formatted will be formatted again into its
+    segment, and the display rebuilt from the segments. If no tree has changed the display is returned
+    as it is.
+    */
+   const OutputBuffer& formatInventory();
+   
+   /**
+    Returns the customers sorted by name, rebuilding the index if the customerTree has changed.
+    @return The customers in the order of the customerTree.
+    @pre None
+    @post If the customerTree's version differs from the one last indexed the customers will be
+    listed again in order, which costs O(n). Otherwise the index is returned as it is.
+    */
+   const std::vector<const Customer*>& getCustomersByName();
+   
    /**
     Hashes the symbol for a Collectible item to an index in the inventoryTree array.
     @param itemType The char symbol for a Collectible item.
@@ -334,6 +803,316 @@ private:
     */
    virtual int hashItem(char itemType) const;
    
+   /*
+    An item parsed from one line of an inventory file, waiting to be added to
+    its inventory tree.
+    */
+   struct ParsedItem
+   {
+      Collectible* item; //the item, owned by the ParsedItem until it is added
+      int treeIndex; //index of the item's tree in inventoryTree
+      int itemCount; //number of copies of the item
+   };
+   
+   /*
+    The customers and error messages parsed from one chunk of a customer file.
+    */
+   struct CustomerBatch
+   {
+      std::vector<Customer*> customers; //valid customers in file order
+      OutputBuffer errors; //error messages in file order
+   };
+   
+   /*
+    The items and error messages parsed from one chunk of an inventory file.
+    */
+   struct InventoryBatch
+   {
+      std::vector<ParsedItem> items; //valid items in file order
+      OutputBuffer errors; //error messages in file order
+   };
+   
+   /**
+    Parses one line of a customer file.
+    @param line The line, without its line break.
+    @param tokenizer The tokenizer used to split the line.
+    @param errors The buffer receiving the error message for an invalid line.
+    @return A new Customer if the line holds a valid ID and name. nullptr otherwise.
+    @pre None
+    @post The store will not be modified, so lines can be parsed on several threads at once with
+    separate tokenizers and buffers. The caller assumes ownership of the returned Customer.
+    */
+   Customer* parseCustomerLine(std::string_view line, LineTokenizer& tokenizer,
+                               OutputBuffer& errors);
+   
+   /**
+    Parses one line of an inventory file.
+    @param line The line, without its line break.
+    @param tokenizer The tokenizer used to split the line.
+    @param errors The buffer receiving the error messages for the line.
+    @param parsed Set to the item, its tree, and its count if the line holds a valid item.
+    @return True if parsed holds an item to add. False otherwise.
+    @pre None
+    @post The store will not be modified, so lines can be parsed on several threads at once with
+    separate tokenizers and buffers. The caller assumes ownership of parsed.item.
+    */
+   bool parseInventoryLine(std::string_view line, LineTokenizer& tokenizer,
+                           OutputBuffer& errors, ParsedItem& parsed) const;
+   
+   /**
+    Splits text into line-aligned chunks for the loader threads.
+    @param contents The text of a file.
+    @param chunks Set to the chunks in file order.
+    @return True if there is more than one chunk. False if the text should be parsed serially.
+    @pre None
+    @post Each chunk will be at least MIN_CHUNK_LENGTH characters long except the last.
+    */
+   bool splitForLoaders(std::string_view contents,
+                        std::vector<std::string_view>& chunks) const;
+   
+   /**
+    Adds customers from the contents of a customer file using the loader threads.
+    @param contents The text of the file.
+    @pre contents contains properly formatted data as described in the program specification.
+    @post The customers and error messages will be the same as adding the lines serially.
+    */
+   void addCustomersInParallel(std::string_view contents);
+   
+   /**
+    Adds Collectible objects from the contents of an inventory file using the loader threads.
+    @param contents The text of the file.
+    @pre contents contains properly formatted data as described in the program specification.
+    @post The inventory and error messages will be the same as adding the lines serially.
+    */
+   void buildInventoryInParallel(std::string_view contents);
+   
+   /**
+    Prepares a buy or sell command and adds it to the window of waiting trades.
+    @param command The command.
+    @param args The arguments of the command.
+    @pre None
+    @post The prepared trade will be the last trade in pendingTrades. Its error output, if any, will be
+    in tradeMessages.
+    */
+   void queueTrade(const TradeCommand& command, const FieldSpan& args);
+   
+   /**
+    Processes store commands on a parser thread and the calling thread.
+    @param nextLine The function returning the next command line. It returns false after the last line.
+    @pre nextLine must only be called by one thread and the view it sets must stay valid until it is
+    called again.
+    @post The commands will be executed on the calling thread in order with the same results as
+    processCommandLine.
+    */
+   void processCommandsPipelined(
+      const std::function<bool(std::string_view&)>& nextLine);
+   
+   /**
+    Parses command lines into records for the executing thread. Runs on the parser thread.
+    @param nextLine The function returning the next command line.
+    @param records The queue receiving the records.
+    @pre The store's customers and inventory trees must not be added or removed while parsing.
+    @post A record will be pushed for every line holding a known command, followed by a record whose
+    command is nullptr.
+    */
+   void parseCommands(const std::function<bool(std::string_view&)>& nextLine,
+                      SpscQueue<CommandRecord>& records);
+   
+   /**
+    Executes a command record parsed by parseCommands.
+    @param record The record.
+    @pre None
+    @post A trade will be added to the window of waiting trades, and any other command will be
+    executed after the window is applied.
+    */
+   void executeRecord(CommandRecord& record);
+   
+   /**
+    Applies and reports the window of waiting trades.
+    @return True if every trade in the window succeeded. False otherwise.
+    @pre None
+    @post The inventory, customer transactions, and output will be the same as executing the trades one
+    at a time in order. The window will be empty.
+    */
+   bool flushTrades();
+   
+   /**
+    Applies the prepared trades of the window to the inventory.
+    @pre None
+    @post The trades of each inventory tree will be sorted by item, the counts of their items looked up
+    in one pass over the tree, and the trades of each item simulated in command file order to decide
+    which succeed. The count of an item whose node stays is then written to the tree once, and the
+    nodes the trades insert or remove are inserted and removed in command file order, so the tree has
+    the shape executing the trades one at a time would give it. The trees are applied on the trade
+    threads in parallel when there are several.
+    */
+   void applyTrades();
+   
+   /**
+    Applies the window's trades on one inventory tree.
+    @param batch The trades of the tree, as positions in tradeOrder, and the scratch space to use.
+    @pre applyTrades must have sorted tradeOrder. No other thread may use the tree, the batch, or
+    the pending trades of the tree.
+    @post The trades of the tree will be marked as succeeded or failed and the tree updated as
+    described for applyTrades.
+    */
+   void applyTreeTrades(TreeBatch& batch);
+   
+   /**
+    Applies the basket of items created by TradeBasket.
+    @return True if the basket was traded. False if an item to sell is not in the inventory.
+    @pre basketTrades must hold the basket's prepared trades in argument order, all with the same
+    action and customer.
+    @post The items will be grouped by tree and item and the count of each distinct item looked up in
+    one pass over its tree. A sale succeeds only if every item is found often enough. The inventory
+    is then changed once per distinct item, the transactions appended to the customer together in
+    argument order, and the basket logged as one record, so it is recovered whole or not at all.
+    Items not owned by an inventory tree will be deleted and basketTrades emptied.
+    */
+   bool applyBasket();
+   
+   /**
+    Outputs the results of the window of trades in command file order.
+    @return True if every trade succeeded. False otherwise.
+    @pre applyTrades must have been called for the window.
+    @post Error output will be written and a transaction added for each trade that succeeded, and the
+    errors, items, and transactions counted in commandStats. Items not owned by an inventory tree will
+    be deleted. The trades stay in the window for flushTrades to time.
+    */
+   bool reportTrades();
+   
+   /**
+    Adds a trade that succeeded to the write-ahead log.
+    @param trade The trade.
+    @pre The log must be open and the trade must have succeeded.
+    @post A record of the trade will be written to the log by its next commit.
+    */
+   void logTrade(const Trade& trade);
+   
+   /**
+    Encodes the whole store into snapshotBytes.
+    @param tradeNumber The line number of the last trade applied, saved for recovery from the log.
+    @pre No trades may be waiting in the window.
+    @post snapshotBytes will hold the customers and inventory trees in pre-order with the shape of each
+    node, the item catalog in ID order, and the transactions in chronological order, followed by a
+    checksum of every byte.
+    */
+   void encodeSnapshot(std::uint64_t tradeNumber);
+   
+   /**
+    Restores the store from the bytes of a snapshot or checkpoint file.
+    @param contents The bytes of the file.
+    @return True if the snapshot is complete and every part of it could be restored. False otherwise.
+    @pre The store must be empty.
+    @post The customers, inventory trees, item catalog, and transactions will be those of the store
+    when the snapshot was written, and the inventory and customer trees will have the same shapes.
+    lastTradeNumber will be set to the number saved with the snapshot.
+    */
+   bool decodeSnapshot(std::string_view contents);
+   
+   /**
+    Applies a buy or sell command read from the write-ahead log.
+    @param record The record of the command.
+    @return True if the customer and item could be found. False otherwise.
+    @pre The checkpoint the log follows must have been loaded.
+    @post Records already covered by the checkpoint are skipped. Otherwise the item, or each item of a
+    basket, will be added to or removed from the inventory and its transaction added to the customer,
+    as the command did when it was logged.
+    */
+   bool applyLoggedTrade(const WriteAheadLog::Record& record);
+   
+   /**
+    Applies one item of a logged buy or sell command.
+    @param customer The customer who traded.
+    @param action 'B' or 'S'.
+    @param itemType The symbol of the item's Collectible subclass.
+    @param itemData The fields written by Collectible::formatData.
+    @return True if the item could be created. False otherwise.
+    @pre The checkpoint the log follows must have been loaded.
+    @post The item will be added to or removed from the inventory and the transaction added to the
+    customer.
+    */
+   bool applyLoggedItem(Customer& customer, char action, char itemType,
+                        std::string_view itemData);
+   
+   /**
+    Creates an item from the data fields saved in a checkpoint or log record.
+    @param itemType The symbol of the item's Collectible subclass.
+    @param itemData The fields written by Collectible::formatData.
+    @return The item, or nullptr if the type or data are invalid.
+    @pre None
+    @post The caller assumes ownership of the returned item.
+    */
+   Collectible* createLoggedItem(char itemType, std::string_view itemData);
+   
+   /**
+    Creates an item from the binary fields saved in a snapshot.
+    @param itemType The symbol of the item's Collectible subclass.
+    @param reader The reader positioned at the fields written by Collectible::writeData.
+    @return The item, or nullptr if the type is unknown or the fields are incomplete.
+    @pre None
+    @post The reader will be advanced past the fields. The caller assumes ownership of the returned item.
+    */
+   Collectible* readItem(char itemType, BinaryReader& reader);
+   
+   /**
+    Writes a file and waits for it to reach the disk, replacing any file of the same name atomically.
+    @param fileName The name of the file.
+    @param contents The bytes to write.
+    @return True if the file was written and renamed into place. False otherwise.
+    @pre None
+    @post The contents will be written to a temporary file which is synced and then renamed to
+    fileName, so a crash leaves either the old file or the new one.
+    */
+   static bool replaceFileDurably(const std::string& fileName,
+                                  std::string_view contents);
+   
+   /**
+    Adds the customer described by one line of a customer file.
+    @param line The line, without its line break.
+    @pre None
+    @post If the line holds a valid ID and name the customer will be added to the customerTree and
+    customerDict. Otherwise an error message will be output.
+    */
+   void addCustomerLine(std::string_view line);
+   
+   /**
+    Adds the item described by one line of an inventory file.
+    @param line The line, without its line break.
+    @pre None
+    @post If the line holds a valid item type, count, and data the item will be added to its inventory
+    tree. Otherwise an error message will be output.
+    */
+   void addInventoryLine(std::string_view line);
+   
+   /**
+    Executes the command on one line of a command file.
+    @param line The line, without its line break.
+    @pre None
+    @post The command will be executed. Blank lines and lines with an unknown command are ignored.
+    */
+   void processCommandLine(std::string_view line);
+   
+   /**
+    Prepares the store for commands that are read as they arrive rather than from a command file.
+    @pre None
+    @post A new log will have been started from a checkpoint if one is needed. After a recovery the
+    commands will be numbered, and logged, after the last trade recovered instead of skipping the
+    command lines the earlier run applied, since new input does not repeat them.
+    */
+   void beginNewCommands();
+   
+   /**
+    Executes a command, timing it if it is not a buy or sell command.
+    @param command The command.
+    @param symbol The command's letter.
+    @param args The arguments of the command.
+    @pre None
+    @post The command will be executed. The time and result of any command but a trade will be
+    recorded in commandStats; trades are recorded when their window is applied.
+    */
+   void executeCommand(StoreCommand& command, char symbol, const FieldSpan& args);
+   
    /**
     Determines whether the customer's name contains appropriate characters: letters or spaces.
     @param name The customer's name.
@@ -341,20 +1120,30 @@ private:
     @pre name must be a string.
     @post True will be returned if name only contains letters or spaces. False otherwise.
     */
-   bool isValidCustName(const std::string& name) const;
+   bool isValidCustName(std::string_view name) const;
    
    /**
-    Determines whether the customer's ID number is in the range 0-999.
+    Determines whether the customer's ID is a valid unsigned 64-bit number and converts it.
     @param ID The customer's ID
+    @param key Set to the numeric value of the ID if it is valid.
     @return True if the customer's ID is valid. False otherwise.
     @pre ID must be a string.
-    @post True will be returned if the ID string represents a number between 0-999. False will be
-    returned otherwise.
+    @post True will be returned and key will be set if the ID string contains only digits and fits
+    in 64 bits. False will be returned otherwise.
     */
-   bool isValidCustID(const std::string& ID) const;
+   bool parseCustID(std::string_view ID, unsigned long long& key) const;
+   
+   /**
+    Determines whether a string represents a non-negative count and converts it.
+    @param countStr The string representing the count.
+    @param count Set to the value of the count if it is valid.
+    @return True if the string represents a valid count. False otherwise.
+    @pre countStr must be a string.
+    @post True will be returned and count will be set if countStr contains only digits and fits in a
+    size_t. False will be returned otherwise.
+    */
+   bool parseCount(std::string_view countStr, std::size_t& count) const;
    
-   //max number of customers
-   static const int MAX_CUSTOMERS = 1000;
    //allows all capital letter ASCII symbols to map to unique indices
    static const int INVENTORY_SIZE = 29;
    //list of item symbols
@@ -364,15 +1153,114 @@ private:
    //SearchTree<Collectible> inventoryTree[NUM_ITEM_TYPES];
    std::vector<SearchTree<Collectible>*> inventoryTree;
    
+   //one copy of every item referred to by customer transactions
+   ItemCatalog itemCatalog;
+   
+   //every transaction made at the store in chronological order
+   TransactionLog transactionLog;
+   
    //used to display customer data by customer's name in alphabetical order
    SearchTree<Customer> customerTree;
    
-   //array of Customer pointers for O(1) lookup & modification of customer data
-   std::vector<Customer*> customerDict;
+   //hash index of Customer pointers by numeric ID for O(1) lookup &
+   //modification of customer data
+   CustomerIndex customerDict;
+   
+   //smallest chunk of text worth parsing on its own thread
+   static const std::size_t MIN_CHUNK_LENGTH = 1 << 16;
+   //chunks per loader thread, so threads that finish early take more chunks
+   static const int CHUNKS_PER_THREAD = 4;
+   
+   LineTokenizer lineTokenizer; //splits input lines into fields
+   
+   int loaderThreads; //threads that parse customer and inventory text
+   
+   //reused by the serial loaders to format error messages
+   OutputBuffer errorBuffer;
+   
+   //number of buy and sell commands applied together
+   static const std::size_t TRADE_WINDOW = 4096;
+   
+   std::size_t tradeWindow; //buy and sell commands applied together
+   std::vector<Trade> pendingTrades; //prepared trades waiting to be applied
+   OutputBuffer tradeMessages; //error output of the pending trades
+   std::vector<std::size_t> tradeOrder; //pending trades sorted by tree and item
+   std::vector<TreeBatch> treeBatches; //trades of each tree in the window
+   
+   std::vector<Trade> basketTrades; //items of the basket being traded
+   std::vector<std::size_t> basketOrder; //basket items sorted by tree and item
+   //distinct items of the basket looked up in their trees
+   std::vector<SearchTree<Collectible>::CountQuery> basketQueries;
+   //basket items of each distinct item, in basketOrder
+   std::vector<std::size_t> basketGroups;
+   //basket items new to their trees and the number of each bought
+   std::vector<std::pair<std::size_t, int>> basketNewItems;
+   std::vector<int> basketItemIds; //catalog IDs of the basket's items
+   std::string basketRecord; //log record data of a basket
+   
+   int tradeThreads; //threads that apply the trades of different trees
+   WorkerPool* tradePool; //runs the trees' batches, nullptr for one thread
+   
+   //command records that can wait between the parser and executing threads
+   static const std::size_t PIPELINE_CAPACITY = 1024;
+   
+   bool pipelined; //true if command lines are parsed on a thread of their own
+   
+   //characters requested by each read of a command stream
+   static const std::size_t STREAM_READ_SIZE = 1 << 16;
+   
+   LatencyHistogram streamLatencies; //per-command latency of command streams
+   CommandStats commandStats; //latencies and counters of the commands
+   
+   //log records kept before a checkpoint replaces them
+   static const std::size_t CHECKPOINT_INTERVAL = 1 << 20;
+   //first bytes of a snapshot or checkpoint file and the version of its
+   //layout, raised whenever the layout changes
+   static const std::uint32_t SNAPSHOT_MAGIC = 0x504b4353;
+   static const std::uint32_t SNAPSHOT_VERSION = 2;
+   //flags saved with each tree node of a snapshot
+   static const std::uint8_t HAS_LEFT_CHILD = 1;
+   static const std::uint8_t HAS_RIGHT_CHILD = 2;
+   static const std::uint8_t IN_CUSTOMER_INDEX = 4;
+   //item type of a log record holding a whole basket of items
+   static const char BASKET_RECORD = 'K';
+   
+   WriteAheadLog tradeLog; //applied buy and sell commands since the checkpoint
+   std::string checkpointFileName; //empty if no log is open
+   std::size_t checkpointInterval; //log records that start a checkpoint
+   bool checkpointNeeded; //true until a new log has its first checkpoint
+   unsigned long long commandNumber; //line number of the last command read
+   unsigned long long lastTradeNumber; //line number of the last trade applied
+   unsigned long long resumeAfter; //command lines applied by an earlier run
+   std::string snapshotBytes; //reused to encode a snapshot or checkpoint
+   OutputBuffer itemData; //reused to format the data of a logged item
    
    CollectibleFactory collectibleFactory; //factory to create Collectible items
    
    CommandFactory commandFactory; //factory to create StoreCommand items
+   
+   //reused by the report commands to format their output before writing it
+   OutputBuffer reportBuffer;
+   
+   //version of a tree that has never been formatted
+   static constexpr unsigned long long NOT_FORMATTED = ~0ULL;
+   
+   //formatted items of each tree, in the order of itemSymbols
+   std::vector<OutputBuffer> inventorySegments;
+   //version of each tree when its segment was formatted
+   std::vector<unsigned long long> segmentVersions;
+   OutputBuffer inventoryDisplay; //the segments joined for DisplayInventory
+   
+   //the customers in name order, for FindCustomers's binary search
+   std::vector<const Customer*> customersByName;
+   //version of the customerTree when customersByName was listed
+   unsigned long long customersByNameVersion;
+   
+   //characters of output collected before they are written
+   static const std::size_t OUTPUT_CAPACITY = 1 << 20;
+   
+   OutputSink outputSink; //reports and command errors
+   OutputSink errorSink; //customer and inventory file errors, unbuffered
   
 };
 #endif
@@ -0,0 +1,188 @@
+/*
+ file name: Trace.cpp
+ author: Hall, Ashley
+ The Trace class records where the time of the store goes as scoped spans,
+ written as a Chrome trace-event JSON file that a trace viewer such as
+ chrome://tracing or Perfetto opens. A span is declared with
+ TRACE_SPAN("name") and covers the rest of the enclosing block. Spans nest,
+ and the outermost span on a thread, such as a command, decides whether it and
+ everything inside it is recorded: only one in every sampleEvery outermost
+ spans is, so a traced run stays close to the speed of an untraced one.
+ TRACE_PHASE("name") declares a span that is always recorded, for phases that
+ run once, such as loading a file, and the spans inside it are sampled as
+ though each were outermost. Each thread keeps its spans in a buffer of its
+ own, so recording takes no lock. Until tracing is started a span costs one
+ test of a flag, and building with -DSTORE_NO_TRACE removes the spans
+ entirely.
+ */
+
+#include "Trace.h"
+
+#include <cstdio>
+
+#include "OutputBuffer.h"
+
+std::atomic<bool> Trace::enabled(false);
+unsigned Trace::sampleEvery = 1;
+std::string Trace::fileName;
+std::chrono::steady_clock::time_point Trace::epoch;
+std::mutex Trace::threadsMutex;
+std::vector<Trace::ThreadTrace*> Trace::threads;
+thread_local Trace::ThreadTrace* Trace::current = nullptr;
+
+/**
+ Enters the span on the calling thread.
+ @param always True to record the span whenever it is outermost, and to sample the spans
+ inside it as though each were outermost.
+ @pre Tracing must be on.
+ @post The span will be nested in the thread's open spans and timed if it is sampled.
+ */
+void Trace::Span::begin(bool always)
+{
+   ThreadTrace& thread = currentThread();
+   entered = true;
+   if ( thread.depth++ != thread.sampleDepth )
+      recorded = thread.sampled;
+   else if ( always )
+   {
+      //a phase is kept whole, but its spans are sampled
+      recorded = true;
+      phase = true;
+      thread.sampleDepth++;
+   }
+   else
+   {
+      thread.sampled = thread.outermostSpans++ % Trace::sampleEvery == 0;
+      recorded = thread.sampled;
+   }
+   if ( recorded )
+      start = Trace::now();
+}
+
+/**
+ Leaves the span on the calling thread.
+ @pre begin must have been called.
+ @post The span will be recorded if it was timed.
+ */
+void Trace::Span::end()
+{
+   ThreadTrace& thread = *Trace::current;
+   thread.depth--;
+   if ( phase )
+      thread.sampleDepth--;
+   if ( recorded && thread.events.size() < MAX_THREAD_EVENTS )
+      thread.events.push_back({name, start, Trace::now() - start});
+}
+
+/**
+ Starts recording spans.
+ @param fileName The name of the trace file written by stop.
+ @param sampleEvery The number of outermost spans on a thread for each one recorded. 1 records
+ every span.
+ @return True if the file could be created. False otherwise.
+ @pre Tracing must not be on.
+ @post Spans will be recorded until stop is called.
+ */
+bool Trace::start(const std::string& fileName, unsigned sampleEvery)
+{
+   //fail now rather than after the run
+   std::FILE* file = std::fopen(fileName.c_str(), "w");
+   if ( file == nullptr )
+      return false;
+   std::fclose(file);
+
+   Trace::fileName = fileName;
+   Trace::sampleEvery = sampleEvery < 1 ? 1 : sampleEvery;
+   epoch = std::chrono::steady_clock::now();
+   enabled.store(true);
+   return true;
+}
+
+/**
+ Stops recording spans and writes the trace file.
+ @return True if the file was written. False otherwise.
+ @pre No other thread may be inside a span.
+ @post The spans recorded will have been written as complete events, one track per thread, and
+ discarded. Tracing will be off.
+ */
+bool Trace::stop()
+{
+   if ( !enabled.exchange(false) )
+      return false;
+
+   std::FILE* file = std::fopen(fileName.c_str(), "w");
+   if ( file == nullptr )
+      return false;
+
+   //the times of complete events are in microseconds
+   OutputBuffer buffer;
+   buffer.append("{\"displayTimeUnit\": \"ns\", \"traceEvents\": [");
+   bool first = true;
+   char time[64];
+   std::lock_guard<std::mutex> lock(threadsMutex);
+   for ( std::size_t i = 0; i < threads.size(); i++ )
+   {
+      std::vector<Event>& events = threads[i]->events;
+      for ( std::size_t j = 0; j < events.size(); j++ )
+      {
+         std::snprintf(time, sizeof(time), "\"ts\": %.3f, \"dur\": %.3f",
+                       events[j].start / 1000.0, events[j].duration / 1000.0);
+         buffer.append(first ? "\n" : ",\n").append("{\"name\": \"")
+            .append(events[j].name).append("\", \"ph\": \"X\", ").append(time)
+            .append(", \"pid\": 1, \"tid\": ").appendInt(threads[i]->threadId)
+            .append('}');
+         first = false;
+      }
+      events.clear();
+      events.shrink_to_fit();
+   }
+   buffer.append("\n]}\n");
+
+   bool written = std::fwrite(buffer.view().data(), 1, buffer.view().size(),
+                              file) == buffer.view().size();
+   return std::fclose(file) == 0 && written;
+}
+
+/**
+ Returns whether spans are being recorded.
+ @return True if tracing was started and has not been stopped. False otherwise.
+ @pre None.
+ @post Whether tracing is on will be returned.
+ */
+bool Trace::isStarted()
+{
+   return enabled.load();
+}
+
+/**
+ Returns the spans of the calling thread, registering the thread the first time.
+ @pre None.
+ @post The thread's buffer will be returned.
+ */
+Trace::ThreadTrace& Trace::currentThread()
+{
+   if ( current == nullptr )
+   {
+      //the buffers outlive their threads, so stop can write them
+      std::lock_guard<std::mutex> lock(threadsMutex);
+      current = new ThreadTrace;
+      current->threadId = static_cast<int>(threads.size()) + 1;
+      current->depth = 0;
+      current->sampleDepth = 0;
+      current->sampled = false;
+      current->outermostSpans = 0;
+      threads.push_back(current);
+   }
+   return *current;
+}
+
+/**
+ Returns the time since tracing started.
+ @pre None.
+ @post The time in nanoseconds will be returned.
+ */
+std::uint64_t Trace::now()
+{
+   std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - epoch;
+   return elapsed.count();
+}
@@ -0,0 +1,184 @@
+/*
+ file name: Trace.h
+ author: Hall, Ashley
+ The Trace class records where the time of the store goes as scoped spans,
+ written as a Chrome trace-event JSON file that a trace viewer such as
+ chrome://tracing or Perfetto opens. A span is declared with
+ TRACE_SPAN("name") and covers the rest of the enclosing block. Spans nest,
+ and the outermost span on a thread, such as a command, decides whether it and
+ everything inside it is recorded: only one in every sampleEvery outermost
+ spans is, so a traced run stays close to the speed of an untraced one.
+ TRACE_PHASE("name") declares a span that is always recorded, for phases that
+ run once, such as loading a file, and the spans inside it are sampled as
+ though each were outermost. Each thread keeps its spans in a buffer of its
+ own, so recording takes no lock. Until tracing is started a span costs one
+ test of a flag, and building with -DSTORE_NO_TRACE removes the spans
+ entirely.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Trace
+{
+public:
+
+   /*
+    A span of time on one thread, from its construction to its destruction.
+    */
+   class Span
+   {
+   public:
+
+      /**
+       Span constructor. Starts the span.
+       @param name The name shown for the span. It must be a string literal.
+       @param always True to record the span whenever it is outermost, and to sample the spans
+       inside it as though each were outermost.
+       @pre None.
+       @post The span will be timed if tracing is on and its outermost span is sampled.
+       */
+      explicit Span(const char* name, bool always = false)
+      : name(name), start(0), entered(false), recorded(false), phase(false)
+      {
+         if ( Trace::enabled.load(std::memory_order_relaxed) )
+            begin(always);
+      }
+
+      /**
+       Span destructor. Ends the span.
+       @pre None.
+       @post The span will be recorded if it was timed.
+       */
+      ~Span()
+      {
+         if ( entered )
+            end();
+      }
+
+      Span(const Span&) = delete;
+      Span& operator=(const Span&) = delete;
+
+   private:
+
+      /**
+       Enters the span on the calling thread.
+       @param always True to record the span whenever it is outermost, and to sample the spans
+       inside it as though each were outermost.
+       @pre Tracing must be on.
+       @post The span will be nested in the thread's open spans and timed if it is sampled.
+       */
+      void begin(bool always);
+
+      /**
+       Leaves the span on the calling thread.
+       @pre begin must have been called.
+       @post The span will be recorded if it was timed.
+       */
+      void end();
+
+      const char* name; //the span's name
+      std::uint64_t start; //the start in nanoseconds since tracing started
+      bool entered; //true if begin was called
+      bool recorded; //true if the span is timed
+      bool phase; //true if the spans inside it decide their own sampling
+   };
+
+   /**
+    Starts recording spans.
+    @param fileName The name of the trace file written by stop.
+    @param sampleEvery The number of outermost spans on a thread for each one recorded. 1 records
+    every span.
+    @return True if the file could be created. False otherwise.
+    @pre Tracing must not be on.
+    @post Spans will be recorded until stop is called.
+    */
+   static bool start(const std::string& fileName, unsigned sampleEvery);
+
+   /**
+    Stops recording spans and writes the trace file.
+    @return True if the file was written. False otherwise.
+    @pre No other thread may be inside a span.
+    @post The spans recorded will have been written as complete events, one track per thread, and
+    discarded. Tracing will be off.
+    */
+   static bool stop();
+
+   /**
+    Returns whether spans are being recorded.
+    @return True if tracing was started and has not been stopped. False otherwise.
+    @pre None.
+    @post Whether tracing is on will be returned.
+    */
+   static bool isStarted();
+
+private:
+
+   /*
+    A span that has ended.
+    */
+   struct Event
+   {
+      const char* name; //the span's name
+      std::uint64_t start; //nanoseconds since tracing started
+      std::uint64_t duration; //nanoseconds
+   };
+
+   /*
+    The spans of one thread.
+    */
+   struct ThreadTrace
+   {
+      int threadId; //the number of the thread's track in the trace
+      int depth; //the number of spans open on the thread
+      int sampleDepth; //the depth of the spans that decide their sampling
+      bool sampled; //true if the open span that decided is recorded
+      std::uint64_t outermostSpans; //outermost spans started on the thread
+      std::vector<Event> events; //the spans recorded
+   };
+
+   /**
+    Returns the spans of the calling thread, registering the thread the first time.
+    @pre None.
+    @post The thread's buffer will be returned.
+    */
+   static ThreadTrace& currentThread();
+
+   /**
+    Returns the time since tracing started.
+    @pre None.
+    @post The time in nanoseconds will be returned.
+    */
+   static std::uint64_t now();
+
+   //events kept for each thread; later spans are dropped
+   static const std::size_t MAX_THREAD_EVENTS = 1 << 18;
+
+   static std::atomic<bool> enabled; //true while spans are recorded
+   static unsigned sampleEvery; //outermost spans for each one recorded
+   static std::string fileName; //where stop writes the trace
+   static std::chrono::steady_clock::time_point epoch; //when tracing started
+   static std::mutex threadsMutex; //guards threads
+   static std::vector<ThreadTrace*> threads; //every thread that has traced
+   static thread_local ThreadTrace* current; //the calling thread's spans
+};
+
+#define TRACE_CONCAT_LINE(prefix, line) prefix##line
+#define TRACE_NAME(prefix, line) TRACE_CONCAT_LINE(prefix, line)
+
+#ifdef STORE_NO_TRACE
+#define TRACE_SPAN(name)
+#define TRACE_PHASE(name)
+#else
+#define TRACE_SPAN(name) Trace::Span TRACE_NAME(traceSpan, __LINE__)(name)
+#define TRACE_PHASE(name) Trace::Span TRACE_NAME(traceSpan, __LINE__)(name, true)
+#endif
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ file name: TransactionLog.cpp
+ author: Hall, Ashley
+ The TransactionLog class records every transaction made at the store in the
+ order it was made. The log is append-only and stored by column: the sequence
+ number, customer ID, action char, and catalog item ID of each record are kept
+ in four separate contiguous vectors, so appending a record never allocates
+ memory for the record itself and scans over a single column touch only that
+ column. Records are addressed by their position in the log. Each Customer
+ keeps the positions of its own records, which serves as the per-customer
+ index into the log. Items are formatted through the store's ItemCatalog,
+ which the TransactionLog does not own.
+ */
+
+#include "TransactionLog.h"
+
+/**
+ TransactionLog constructor.
+ @param catalog The catalog holding the items referred to by the records.
+ @pre catalog must outlive the TransactionLog.
+ @post An empty TransactionLog will be created. The first record will have sequence number 1.
+ */
+TransactionLog::TransactionLog(const ItemCatalog* catalog)
+: itemCatalog(catalog), nextSequence(1)
+{
+}
+
+/**
+ Makes room for a number of records so the columns will not grow while they are appended.
+ @param count The number of records the log should hold without growing.
+ @pre None.
+ @post Each column will have capacity for count records.
+ */
+void TransactionLog::reserve(std::size_t count)
+{
+   sequences.reserve(count);
+   customerIds.reserve(count);
+   actions.reserve(count);
+   itemIds.reserve(count);
+}
+
+/**
+ Appends a record to the end of the log.
+ @param customerId The numeric ID of the customer.
+ @param action The char 'B' or 'S'.
+ @param itemId The catalog ID of the item bought or sold.
+ @return The position of the new record in the log.
+ @pre action and itemId must be valid.
+ @post The record will be the last record in the log and its sequence number will be one greater than
+ the previous record's.
+ */
+std::uint32_t TransactionLog::append(unsigned long long customerId,
+                                     char action, int itemId)
+{
+   std::uint32_t position = sequences.size();
+   sequences.push_back(nextSequence++);
+   customerIds.push_back(customerId);
+   actions.push_back(action);
+   itemIds.push_back(itemId);
+   return position;
+}
+
+/**
+ Returns the number of records in the log.
+ @pre None.
+ @post The number of records will be returned.
+ */
+std::size_t TransactionLog::size() const
+{
+   return sequences.size();
+}
+
+/**
+ Returns the sequence number of a record.
+ @param position The position of the record.
+ @pre position must be less than size().
+ @post The record's sequence number will be returned.
+ */
+unsigned long long TransactionLog::getSequence(std::uint32_t position) const
+{
+   return sequences[position];
+}
+
+/**
+ Returns the numeric ID of the customer of a record.
+ @param position The position of the record.
+ @pre position must be less than size().
+ @post The record's customer ID will be returned.
+ */
+unsigned long long TransactionLog::getCustomerId(std::uint32_t position) const
+{
+   return customerIds[position];
+}
+
+/**
+ Returns the action char of a record.
+ @param position The position of the record.
+ @pre position must be less than size().
+ @post 'B' or 'S' will be returned.
+ */
+char TransactionLog::getAction(std::uint32_t position) const
+{
+   return actions[position];
+}
+
+/**
+ Returns the catalog item ID of a record.
+ @param position The position of the record.
+ @pre position must be less than size().
+ @post The record's item ID will be returned.
+ */
+int TransactionLog::getItemId(std::uint32_t position) const
+{
+   return itemIds[position];
+}
+
+/**
+ Returns the catalog holding the items referred to by the records.
+ @pre None.
+ @post The catalog will be returned.
+ */
+const ItemCatalog* TransactionLog::getCatalog() const
+{
+   return itemCatalog;
+}
+
+/**
+ Writes a record as a line of a transaction history into an output buffer.
+ @param position The position of the record.
+ @param buffer The buffer to write to.
+ @pre position must be less than size().
+ @post The line "action: item" followed by a line break will be appended to the buffer.
+ */
+void TransactionLog::formatRecord(std::uint32_t position,
+                                  OutputBuffer& buffer) const
+{
+   buffer.append(actions[position]).append(": ");
+   itemCatalog->getItem(itemIds[position])->format(buffer);
+   buffer.append('\n');
+}
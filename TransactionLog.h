@@ -0,0 +1,124 @@
+/*
+ file name: TransactionLog.h
+ author: Hall, Ashley
+ The TransactionLog class records every transaction made at the store in the
+ order it was made. The log is append-only and stored by column: the sequence
+ number, customer ID, action char, and catalog item ID of each record are kept
+ in four separate contiguous vectors, so appending a record never allocates
+ memory for the record itself and scans over a single column touch only that
+ column. Records are addressed by their position in the log. Each Customer
+ keeps the positions of its own records, which serves as the per-customer
+ index into the log. Items are formatted through the store's ItemCatalog,
+ which the TransactionLog does not own.
+ */
+
+#ifndef TRANSACTIONLOG_H
+#define TRANSACTIONLOG_H
+
+#include <cstdint>
+#include <vector>
+
+#include "ItemCatalog.h"
+#include "OutputBuffer.h"
+
+class TransactionLog
+{
+public:
+
+   /**
+    TransactionLog constructor.
+    @param catalog The catalog holding the items referred to by the records.
+    @pre catalog must outlive the TransactionLog.
+    @post An empty TransactionLog will be created. The first record will have sequence number 1.
+    */
+   explicit TransactionLog(const ItemCatalog* catalog);
+
+   /**
+    Makes room for a number of records so the columns will not grow while they are appended.
+    @param count The number of records the log should hold without growing.
+    @pre None.
+    @post Each column will have capacity for count records.
+    */
+   void reserve(std::size_t count);
+
+   /**
+    Appends a record to the end of the log.
+    @param customerId The numeric ID of the customer.
+    @param action The char 'B' or 'S'.
+    @param itemId The catalog ID of the item bought or sold.
+    @return The position of the new record in the log.
+    @pre action and itemId must be valid.
+    @post The record will be the last record in the log and its sequence number will be one greater than
+    the previous record's.
+    */
+   std::uint32_t append(unsigned long long customerId, char action,
+                        int itemId);
+
+   /**
+    Returns the number of records in the log.
+    @pre None.
+    @post The number of records will be returned.
+    */
+   std::size_t size() const;
+
+   /**
+    Returns the sequence number of a record.
+    @param position The position of the record.
+    @pre position must be less than size().
+    @post The record's sequence number will be returned.
+    */
+   unsigned long long getSequence(std::uint32_t position) const;
+
+   /**
+    Returns the numeric ID of the customer of a record.
+    @param position The position of the record.
+    @pre position must be less than size().
+    @post The record's customer ID will be returned.
+    */
+   unsigned long long getCustomerId(std::uint32_t position) const;
+
+   /**
+    Returns the action char of a record.
+    @param position The position of the record.
+    @pre position must be less than size().
+    @post 'B' or 'S' will be returned.
+    */
+   char getAction(std::uint32_t position) const;
+
+   /**
+    Returns the catalog item ID of a record.
+    @param position The position of the record.
+    @pre position must be less than size().
+    @post The record's item ID will be returned.
+    */
+   int getItemId(std::uint32_t position) const;
+
+   /**
+    Returns the catalog holding the items referred to by the records.
+    @pre None.
+    @post The catalog will be returned.
+    */
+   const ItemCatalog* getCatalog() const;
+
+   /**
+    Writes a record as a line of a transaction history into an output buffer.
+    @param position The position of the record.
+    @param buffer The buffer to write to.
+    @pre position must be less than size().
+    @post The line "action: item" followed by a line break will be appended to the buffer.
+    */
+   void formatRecord(std::uint32_t position, OutputBuffer& buffer) const;
+
+private:
+
+   const ItemCatalog* itemCatalog; //catalog of the items in the records
+   unsigned long long nextSequence; //sequence number of the next record
+
+   //columns, one element per record
+   std::vector<unsigned long long> sequences;
+   std::vector<unsigned long long> customerIds;
+   std::vector<char> actions;
+   std::vector<int> itemIds;
+};
+
+#endif
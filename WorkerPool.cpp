@@ -0,0 +1,141 @@
+/*
+ file name: WorkerPool.cpp
+ author: Hall, Ashley
+ The WorkerPool class runs a numbered set of independent tasks on a fixed
+ group of threads. The threads are started once and wait between runs, so a
+ pool can be reused for several jobs without creating threads each time. The
+ thread that calls run also takes tasks, and run does not return until every
+ task has finished. Tasks are handed out in increasing order of their number,
+ but they may finish in any order.
+ */
+
+#include "WorkerPool.h"
+
+/**
+ WorkerPool constructor.
+ @param threadCount The number of threads that run tasks, including the thread that calls run.
+ @pre None.
+ @post threadCount - 1 worker threads will be started and will wait for tasks. A threadCount below 1
+ is treated as 1.
+ */
+WorkerPool::WorkerPool(int threadCount)
+: currentTask(nullptr), currentTaskCount(0), runNumber(0), activeWorkers(0),
+  stopping(false), nextTask(0)
+{
+   for ( int i = 1; i < threadCount; i++ )
+      workers.emplace_back(&WorkerPool::workerLoop, this);
+}
+
+/**
+ WorkerPool destructor. Stops the worker threads.
+ @pre run must not be executing.
+ @post Every worker thread will have been joined.
+ */
+WorkerPool::~WorkerPool()
+{
+   {
+      std::lock_guard<std::mutex> lock(poolMutex);
+      stopping = true;
+   }
+   workReady.notify_all();
+   for ( std::size_t i = 0; i < workers.size(); i++ )
+      workers[i].join();
+}
+
+/**
+ Runs a number of tasks on the pool's threads.
+ @param taskCount The number of tasks.
+ @param task The function to call with the number of each task, from 0 to taskCount - 1.
+ @pre task must be safe to call from several threads at once for different task numbers.
+ @post task will have been called exactly once for every task number and every call will have
+ returned.
+ */
+void WorkerPool::run(std::size_t taskCount,
+                     const std::function<void(std::size_t)>& task)
+{
+   if ( workers.empty() )
+   {
+      for ( std::size_t i = 0; i < taskCount; i++ )
+         task(i);
+      return;
+   }
+
+   {
+      std::lock_guard<std::mutex> lock(poolMutex);
+      currentTask = &task;
+      currentTaskCount = taskCount;
+      nextTask = 0;
+      runNumber++;
+   }
+   workReady.notify_all();
+
+   //the calling thread takes tasks too
+   takeTasks(task, taskCount);
+
+   //every task has been handed out, wait for the workers still running one
+   std::unique_lock<std::mutex> lock(poolMutex);
+   workDone.wait(lock, [this] { return activeWorkers == 0; });
+   //a worker that wakes after this point finds no tasks
+   currentTask = nullptr;
+   currentTaskCount = 0;
+}
+
+/**
+ Returns the number of threads that run tasks.
+ @pre None.
+ @post The number of worker threads plus one for the calling thread will be returned.
+ */
+int WorkerPool::getThreadCount() const
+{
+   return workers.size() + 1;
+}
+
+/**
+ Waits for runs to start and takes tasks from them until the pool is stopped.
+ @pre None.
+ @post The thread will return once the pool is being destroyed.
+ */
+void WorkerPool::workerLoop()
+{
+   unsigned long long lastRun = 0;
+   while ( true )
+   {
+      const std::function<void(std::size_t)>* task;
+      std::size_t taskCount;
+      {
+         std::unique_lock<std::mutex> lock(poolMutex);
+         workReady.wait(lock,
+            [this, lastRun] { return stopping || runNumber != lastRun; });
+         if ( stopping )
+            return;
+         lastRun = runNumber;
+         if ( currentTaskCount == 0 )
+            continue;
+         task = currentTask;
+         taskCount = currentTaskCount;
+         activeWorkers++;
+      }
+
+      takeTasks(*task, taskCount);
+
+      {
+         std::lock_guard<std::mutex> lock(poolMutex);
+         activeWorkers--;
+      }
+      workDone.notify_all();
+   }
+}
+
+/**
+ Takes and runs tasks of the current run until none are left.
+ @param task The function of the current run.
+ @param taskCount The number of tasks in the current run.
+ @pre None.
+ @post Every task number taken by this thread will have been run.
+ */
+void WorkerPool::takeTasks(const std::function<void(std::size_t)>& task,
+                           std::size_t taskCount)
+{
+   for ( std::size_t i = nextTask++; i < taskCount; i = nextTask++ )
+      task(i);
+}
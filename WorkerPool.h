@@ -0,0 +1,97 @@
+/*
+ file name: WorkerPool.h
+ author: Hall, Ashley
+ The WorkerPool class runs a numbered set of independent tasks on a fixed
+ group of threads. The threads are started once and wait between runs, so a
+ pool can be reused for several jobs without creating threads each time. The
+ thread that calls run also takes tasks, and run does not return until every
+ task has finished. Tasks are handed out in increasing order of their number,
+ but they may finish in any order.
+ */
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool
+{
+public:
+
+   /**
+    WorkerPool constructor.
+    @param threadCount The number of threads that run tasks, including the thread that calls run.
+    @pre None.
+    @post threadCount - 1 worker threads will be started and will wait for tasks. A threadCount below 1
+    is treated as 1.
+    */
+   explicit WorkerPool(int threadCount);
+
+   /**
+    WorkerPool destructor. Stops the worker threads.
+    @pre run must not be executing.
+    @post Every worker thread will have been joined.
+    */
+   virtual ~WorkerPool();
+
+   WorkerPool(const WorkerPool&) = delete;
+   WorkerPool& operator=(const WorkerPool&) = delete;
+
+   /**
+    Runs a number of tasks on the pool's threads.
+    @param taskCount The number of tasks.
+    @param task The function to call with the number of each task, from 0 to taskCount - 1.
+    @pre task must be safe to call from several threads at once for different task numbers.
+    @post task will have been called exactly once for every task number and every call will have
+    returned.
+    */
+   void run(std::size_t taskCount, const std::function<void(std::size_t)>& task);
+
+   /**
+    Returns the number of threads that run tasks.
+    @pre None.
+    @post The number of worker threads plus one for the calling thread will be returned.
+    */
+   int getThreadCount() const;
+
+private:
+
+   /**
+    Waits for runs to start and takes tasks from them until the pool is stopped.
+    @pre None.
+    @post The thread will return once the pool is being destroyed.
+    */
+   void workerLoop();
+
+   /**
+    Takes and runs tasks of the current run until none are left.
+    @param task The function of the current run.
+    @param taskCount The number of tasks in the current run.
+    @pre None.
+    @post Every task number taken by this thread will have been run.
+    */
+   void takeTasks(const std::function<void(std::size_t)>& task,
+                  std::size_t taskCount);
+
+   std::vector<std::thread> workers; //threads other than the caller of run
+
+   std::mutex poolMutex; //guards every member below except nextTask
+   std::condition_variable workReady; //signalled when a run starts or the pool stops
+   std::condition_variable workDone; //signalled when the last worker leaves a run
+
+   const std::function<void(std::size_t)>* currentTask; //task of the current run
+   std::size_t currentTaskCount; //number of tasks in the current run, 0 between runs
+   unsigned long long runNumber; //incremented when a run starts
+   int activeWorkers; //worker threads taking tasks from the current run
+   bool stopping; //set when the pool is destroyed
+
+   std::atomic<std::size_t> nextTask; //number of the next task to hand out
+};
+
+#endif
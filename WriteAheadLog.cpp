@@ -0,0 +1,238 @@
+/*
+ file name: WriteAheadLog.cpp
+ author: Hall, Ashley
+ The WriteAheadLog class records the buy and sell commands applied to a
+ StoreInventory in an append-only binary file, so the store can be restored
+ after a crash from its last checkpoint and the records written since. Each
+ record holds the command's line number in the command file, the customer ID,
+ the action, the item type, and the item's data fields, and ends with a
+ checksum. Records are collected in memory and written and synced to disk
+ together by commit, so one disk sync covers a whole group of commands. A
+ crash during a commit can leave a partial record at the end of the file;
+ replay stops at the first record that is incomplete or fails its checksum and
+ cuts the file back to the records before it.
+ */
+
+#include "WriteAheadLog.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "BinaryReader.h"
+#include "BinaryWriter.h"
+#include "MappedFile.h"
+
+/**
+ WriteAheadLog constructor.
+ @pre None.
+ @post A WriteAheadLog with no open file will be created.
+ */
+WriteAheadLog::WriteAheadLog() : fileDescriptor(-1), recordCount(0) {}
+
+/**
+ WriteAheadLog destructor. Commits the waiting records and closes the file.
+ @pre None.
+ @post The records appended will have been written to the file.
+ */
+WriteAheadLog::~WriteAheadLog()
+{
+   if ( fileDescriptor >= 0 )
+   {
+      commit();
+      ::close(fileDescriptor);
+   }
+}
+
+/**
+ Opens a log file, creating it if it does not exist.
+ @param fileName The name of the file.
+ @return True if the file was opened. False otherwise.
+ @pre None.
+ @post New records will be added after the records already in the file.
+ */
+bool WriteAheadLog::open(const std::string& fileName)
+{
+   int newDescriptor = ::open(fileName.c_str(), O_RDWR | O_CREAT | O_APPEND,
+                              0644);
+   if ( newDescriptor < 0 )
+      return false;
+
+   if ( fileDescriptor >= 0 )
+   {
+      commit();
+      ::close(fileDescriptor);
+   }
+   fileDescriptor = newDescriptor;
+   logFileName = fileName;
+   pending.clear();
+   recordCount = 0;
+   return true;
+}
+
+/**
+ Determines whether a log file is open.
+ @pre None.
+ @post True will be returned if open succeeded. False otherwise.
+ */
+bool WriteAheadLog::isOpen() const
+{
+   return fileDescriptor >= 0;
+}
+
+/**
+ Reads the records in the file.
+ @param apply The function called with each record in the order they were written.
+ @return The number of records read.
+ @pre The log must be open and no records may have been appended since it was opened.
+ @post apply will have been called for every complete record. If the file ends with an incomplete or
+ corrupt record, the file will be cut back to the end of the last good record.
+ */
+std::size_t WriteAheadLog::replay(
+   const std::function<void(const Record&)>& apply)
+{
+   MappedFile contents;
+   if ( !contents.open(logFileName) )
+      return 0;
+
+   BinaryReader reader(contents.getContents());
+   std::size_t goodLength = 0;
+   while ( !reader.atEnd() )
+   {
+      //a record is its payload followed by the payload's checksum
+      std::string_view recordPayload;
+      std::uint32_t sum;
+      if ( !reader.getString(recordPayload) || !reader.getU32(sum)
+          || sum != checksum(recordPayload) )
+         break;
+
+      Record record;
+      std::uint8_t action;
+      std::uint8_t itemType;
+      BinaryReader fields(recordPayload);
+      if ( !fields.getU64(record.commandNumber)
+          || !fields.getU64(record.customerId) || !fields.getU8(action)
+          || !fields.getU8(itemType) || !fields.getString(record.itemData) )
+         break;
+      record.action = action;
+      record.itemType = itemType;
+
+      apply(record);
+      recordCount++;
+      goodLength = reader.getPosition();
+   }
+
+   //drop a record torn by a crash so new records follow the good ones
+   if ( !reader.atEnd() )
+   {
+      if ( ftruncate(fileDescriptor, goodLength) == 0 )
+         fdatasync(fileDescriptor);
+   }
+   return recordCount;
+}
+
+/**
+ Adds a record to the group waiting to be committed.
+ @param record The record.
+ @pre The log must be open.
+ @post The record will be written to the file by the next commit.
+ */
+void WriteAheadLog::append(const Record& record)
+{
+   payload.clear();
+   BinaryWriter payloadWriter(payload);
+   payloadWriter.putU64(record.commandNumber);
+   payloadWriter.putU64(record.customerId);
+   payloadWriter.putU8(record.action);
+   payloadWriter.putU8(record.itemType);
+   payloadWriter.putString(record.itemData);
+
+   BinaryWriter writer(pending);
+   writer.putString(payload);
+   writer.putU32(checksum(payload));
+   recordCount++;
+}
+
+/**
+ Writes the waiting records to the file and waits for them to reach the disk.
+ @return True if the records were written. False if the file reported an error.
+ @pre None.
+ @post The records appended before the call will be durable. Nothing is done if none are waiting.
+ */
+bool WriteAheadLog::commit()
+{
+   if ( pending.empty() || fileDescriptor < 0 )
+      return true;
+   bool written = writeAll(pending) && fdatasync(fileDescriptor) == 0;
+   pending.clear();
+   return written;
+}
+
+/**
+ Empties the log file, after its records have been saved in a checkpoint.
+ @return True if the file was emptied. False otherwise.
+ @pre None.
+ @post Waiting records will have been discarded and the file will hold no records.
+ */
+bool WriteAheadLog::reset()
+{
+   pending.clear();
+   recordCount = 0;
+   if ( fileDescriptor < 0 )
+      return false;
+   return ftruncate(fileDescriptor, 0) == 0 && fdatasync(fileDescriptor) == 0;
+}
+
+/**
+ Returns the number of records in the file and waiting to be committed.
+ @pre None.
+ @post The number of records since the file was opened or reset will be returned.
+ */
+std::size_t WriteAheadLog::getRecordCount() const
+{
+   return recordCount;
+}
+
+/**
+ Computes the checksum used by the log and the store's checkpoints.
+ @param bytes The bytes to sum.
+ @return The 32-bit FNV-1a hash of bytes.
+ @pre None.
+ @post The checksum will be returned.
+ */
+std::uint32_t WriteAheadLog::checksum(std::string_view bytes)
+{
+   const std::uint32_t FNV_OFFSET = 2166136261u;
+   const std::uint32_t FNV_PRIME = 16777619u;
+
+   std::uint32_t hash = FNV_OFFSET;
+   for ( std::size_t i = 0; i < bytes.size(); i++ )
+   {
+      hash ^= static_cast<unsigned char>(bytes[i]);
+      hash *= FNV_PRIME;
+   }
+   return hash;
+}
+
+/**
+ Writes bytes to the file.
+ @param bytes The bytes to write.
+ @return True if every byte was written. False otherwise.
+ @pre The log must be open.
+ @post The bytes will have been written, retrying partial and interrupted writes.
+ */
+bool WriteAheadLog::writeAll(std::string_view bytes)
+{
+   while ( !bytes.empty() )
+   {
+      ssize_t written = ::write(fileDescriptor, bytes.data(), bytes.size());
+      if ( written < 0 )
+      {
+         if ( errno == EINTR )
+            continue;
+         return false;
+      }
+      bytes.remove_prefix(written);
+   }
+   return true;
+}
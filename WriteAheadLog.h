@@ -0,0 +1,141 @@
+/*
+ file name: WriteAheadLog.h
+ author: Hall, Ashley
+ The WriteAheadLog class records the buy and sell commands applied to a
+ StoreInventory in an append-only binary file, so the store can be restored
+ after a crash from its last checkpoint and the records written since. Each
+ record holds the command's line number in the command file, the customer ID,
+ the action, the item type, and the item's data fields, and ends with a
+ checksum. Records are collected in memory and written and synced to disk
+ together by commit, so one disk sync covers a whole group of commands. A
+ crash during a commit can leave a partial record at the end of the file;
+ replay stops at the first record that is incomplete or fails its checksum and
+ cuts the file back to the records before it.
+ */
+
+#ifndef WRITEAHEADLOG_H
+#define WRITEAHEADLOG_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+class WriteAheadLog
+{
+public:
+
+   /*
+    One applied buy or sell command.
+    */
+   struct Record
+   {
+      std::uint64_t commandNumber; //line number of the command in the command file
+      std::uint64_t customerId; //numeric ID of the customer
+      char action; //'B' or 'S'
+      char itemType; //symbol of the item's Collectible subclass
+      std::string_view itemData; //the item's fields as read by Collectible::setData
+   };
+
+   /**
+    WriteAheadLog constructor.
+    @pre None.
+    @post A WriteAheadLog with no open file will be created.
+    */
+   WriteAheadLog();
+
+   /**
+    WriteAheadLog destructor. Commits the waiting records and closes the file.
+    @pre None.
+    @post The records appended will have been written to the file.
+    */
+   virtual ~WriteAheadLog();
+
+   WriteAheadLog(const WriteAheadLog&) = delete;
+   WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+   /**
+    Opens a log file, creating it if it does not exist.
+    @param fileName The name of the file.
+    @return True if the file was opened. False otherwise.
+    @pre None.
+    @post New records will be added after the records already in the file.
+    */
+   bool open(const std::string& fileName);
+
+   /**
+    Determines whether a log file is open.
+    @pre None.
+    @post True will be returned if open succeeded. False otherwise.
+    */
+   bool isOpen() const;
+
+   /**
+    Reads the records in the file.
+    @param apply The function called with each record in the order they were written.
+    @return The number of records read.
+    @pre The log must be open and no records may have been appended since it was opened.
+    @post apply will have been called for every complete record. If the file ends with an incomplete or
+    corrupt record, the file will be cut back to the end of the last good record.
+    */
+   std::size_t replay(const std::function<void(const Record&)>& apply);
+
+   /**
+    Adds a record to the group waiting to be committed.
+    @param record The record.
+    @pre The log must be open.
+    @post The record will be written to the file by the next commit.
+    */
+   void append(const Record& record);
+
+   /**
+    Writes the waiting records to the file and waits for them to reach the disk.
+    @return True if the records were written. False if the file reported an error.
+    @pre None.
+    @post The records appended before the call will be durable. Nothing is done if none are waiting.
+    */
+   bool commit();
+
+   /**
+    Empties the log file, after its records have been saved in a checkpoint.
+    @return True if the file was emptied. False otherwise.
+    @pre None.
+    @post Waiting records will have been discarded and the file will hold no records.
+    */
+   bool reset();
+
+   /**
+    Returns the number of records in the file and waiting to be committed.
+    @pre None.
+    @post The number of records since the file was opened or reset will be returned.
+    */
+   std::size_t getRecordCount() const;
+
+   /**
+    Computes the checksum used by the log and the store's checkpoints.
+    @param bytes The bytes to sum.
+    @return The 32-bit FNV-1a hash of bytes.
+    @pre None.
+    @post The checksum will be returned.
+    */
+   static std::uint32_t checksum(std::string_view bytes);
+
+private:
+
+   /**
+    Writes bytes to the file.
+    @param bytes The bytes to write.
+    @return True if every byte was written. False otherwise.
+    @pre The log must be open.
+    @post The bytes will have been written, retrying partial and interrupted writes.
+    */
+   bool writeAll(std::string_view bytes);
+
+   int fileDescriptor; //descriptor of the log file, -1 if none is open
+   std::string logFileName; //name of the log file
+   std::string pending; //encoded records waiting to be committed
+   std::string payload; //reused while encoding one record
+   std::size_t recordCount; //records in the file and in pending
+};
+
+#endif
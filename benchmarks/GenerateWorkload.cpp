@@ -0,0 +1,73 @@
+/*
+ file name: GenerateWorkload.cpp
+ author: Hall, Ashley
+ Writes a synthetic hw4customers.txt, hw4inventory.txt, and hw4commands.txt
+ with a WorkloadGenerator, so the store can be run on inputs of any size.
+ Options: --dir DIR (default .), --customers N, --items N, --stock N,
+ --commands N, --sorted (customers and inventory in sorted order), --zipf S
+ (item popularity skew, 0 for uniform), --mix SELL,BUY,DISPLAY (percentages of
+ the commands; the rest are customer summaries), and --seed N.
+ Build from the repository directory with:
+ g++ -std=c++17 -O2 -I. -o GenerateWorkload benchmarks/GenerateWorkload.cpp
+ benchmarks/WorkloadGenerator.cpp OutputBuffer.cpp
+ */
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "WorkloadGenerator.h"
+
+/**
+ Writes the contents of a buffer to a file.
+ @param fileName The name of the file. It is created or truncated.
+ @param buffer The contents.
+ @return True if the file was written. False otherwise.
+ @pre None
+ @post The file will hold the contents of the buffer.
+ */
+bool writeFile(const std::string& fileName, const OutputBuffer& buffer)
+{
+   std::ofstream file(fileName, std::ios::binary);
+   file.write(buffer.view().data(), buffer.view().size());
+   return static_cast<bool>(file);
+}
+
+
+int main(int argc, char* argv[])
+{
+   WorkloadGenerator::Settings settings;
+   std::string directory = ".";
+   for ( int i = 1; i < argc; i++ )
+   {
+      int used = WorkloadGenerator::readOption(argc, argv, i, settings);
+      if ( used < 0 )
+         return 1;
+      else if ( used > 0 )
+         i += used - 1;
+      else if ( std::strcmp(argv[i], "--dir") == 0 && i + 1 < argc )
+         directory = argv[++i];
+      else
+      {
+         std::cerr << "Unknown option: " << argv[i] << std::endl;
+         return 1;
+      }
+   }
+
+   WorkloadGenerator generator(settings);
+   OutputBuffer customers;
+   OutputBuffer inventory;
+   OutputBuffer commands;
+   generator.writeCustomers(customers);
+   generator.writeInventory(inventory);
+   generator.writeCommands(commands);
+   if ( !writeFile(directory + "/hw4customers.txt", customers)
+       || !writeFile(directory + "/hw4inventory.txt", inventory)
+       || !writeFile(directory + "/hw4commands.txt", commands) )
+   {
+      std::cerr << "File could not be written." << std::endl;
+      return 1;
+   }
+   return 0;
+}
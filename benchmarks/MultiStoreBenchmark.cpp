@@ -0,0 +1,134 @@
+/*
+ file name: MultiStoreBenchmark.cpp
+ author: Hall, Ashley
+ Measures the aggregate command throughput of a MultiStore as the number of
+ shards grows. A number of stores is filled with generated customers and
+ inventory, and a generated command file of buy and sell commands, spread
+ evenly over the stores, is processed once for each shard count, from 1 up to
+ the number of processors. The stores' output is written to /dev/null. For
+ each run the program prints the shard count, the elapsed time, the commands
+ executed per second, and the speedup over a single shard.
+ Usage: MultiStoreBenchmark [stores] [commands per store] [max shards]
+ Build from the repository directory with:
+ g++ -std=c++17 -O2 -pthread -I. -o MultiStoreBenchmark
+ benchmarks/MultiStoreBenchmark.cpp $(ls *.cpp | grep -v main.cpp)
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "MultiStore.h"
+
+//customers and inventory lines of each store
+const int CUSTOMERS = 500;
+const int ITEMS = 2000;
+
+/**
+ Returns the text of an inventory line or of the item fields of a command.
+ @param item The number of the item, from 0 to ITEMS - 1.
+ @return The item's type and fields, without a count.
+ @pre None
+ @post The same number will always give the same item.
+ */
+std::string itemFields(int item)
+{
+   const char* PLAYERS[] = {"Hank Aaron", "Babe Ruth", "Mickey Mantle"};
+   const char* GRADES[] = {"Mint", "Near Mint", "Good"};
+   std::string year = std::to_string(1900 + item / 9 % 120);
+   switch ( item % 3 )
+   {
+      case 0:
+         return "M, " + year + ", " + std::to_string(item % 70) + ", Liberty";
+      case 1:
+         return "C, " + year + ", " + GRADES[item / 3 % 3] + ", Title"
+            + std::to_string(item / 27) + ", Marvel";
+      default:
+         return "S, " + year + ", " + GRADES[item / 3 % 3] + ", "
+            + PLAYERS[item / 27 % 3] + ", Topps";
+   }
+}
+
+/**
+ Fills a store with generated customers and inventory.
+ @param store The store to fill.
+ @pre The store must be empty.
+ @post The store will hold CUSTOMERS customers and ITEMS items.
+ */
+void fillStore(StoreInventory& store)
+{
+   //names may only hold letters, so the digits of the number are spelled
+   std::string customers;
+   for ( int i = 0; i < CUSTOMERS; i++ )
+   {
+      std::string name = std::to_string(i);
+      for ( char& c : name )
+         c += 'a' - '0';
+      customers += std::to_string(i) + ", Smith N" + name + "\n";
+   }
+   store.addCustomersFromText(customers);
+
+   std::string inventory;
+   for ( int i = 0; i < ITEMS; i++ )
+   {
+      std::string fields = itemFields(i);
+      inventory += fields.substr(0, 1) + ", 5" + fields.substr(1) + "\n";
+   }
+   store.buildInventoryFromText(inventory);
+}
+
+
+int main(int argc, char* argv[])
+{
+   int storeCount = argc > 1 ? std::atoi(argv[1]) : 256;
+   int commandsPerStore = argc > 2 ? std::atoi(argv[2]) : 20000;
+   int maxShards = argc > 3 ? std::atoi(argv[3])
+                            : std::thread::hardware_concurrency();
+   if ( storeCount < 1 || commandsPerStore < 1 || maxShards < 1 )
+   {
+      std::cerr << "Usage: " << argv[0]
+                << " [stores] [commands per store] [max shards]" << std::endl;
+      return 1;
+   }
+
+   //buy and sell commands for random customers and items of random stores
+   std::mt19937 random(42);
+   std::string commands;
+   long commandCount = static_cast<long>(storeCount) * commandsPerStore;
+   for ( long i = 0; i < commandCount; i++ )
+   {
+      commands += std::to_string(random() % storeCount) + ":"
+         + (random() % 2 == 0 ? "B, " : "S, ")
+         + std::to_string(random() % CUSTOMERS) + ", "
+         + itemFields(random() % ITEMS) + "\n";
+   }
+
+   double singleShardRate = 0;
+   for ( int shards = 1; shards <= maxShards; shards *= 2 )
+   {
+      MultiStore stores(shards);
+      for ( int i = 0; i < storeCount; i++ )
+         stores.addStore(i)->setOutputFile("/dev/null");
+      stores.forEachStore([](unsigned long, StoreInventory& store)
+         {
+            fillStore(store);
+         });
+
+      std::chrono::steady_clock::time_point start =
+         std::chrono::steady_clock::now();
+      stores.processCommandsFromText(commands);
+      std::chrono::duration<double> elapsed =
+         std::chrono::steady_clock::now() - start;
+
+      double rate = commandCount / elapsed.count();
+      if ( shards == 1 )
+         singleShardRate = rate;
+      std::cout << "shards " << shards << " seconds " << elapsed.count()
+                << " commands/s " << static_cast<long>(rate) << " speedup "
+                << rate / singleShardRate << std::endl;
+   }
+   return 0;
+}
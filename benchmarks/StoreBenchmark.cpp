@@ -0,0 +1,334 @@
+/*
+ file name: StoreBenchmark.cpp
+ author: Hall, Ashley
+ Measures the store on a synthetic workload from a WorkloadGenerator. It
+ times inserting, retrieving, and removing every coin of the inventory in a
+ SearchTree, each customer and inventory loader, processCommandsFromFile over
+ the whole command file, and each command executed on its own. Every
+ benchmark prints its operations per second and the peak resident set size of
+ the process so far, and those whose operations are timed one by one also
+ print the latency percentiles. The store's output is written to /dev/null.
+ Options: the workload options of GenerateWorkload (--customers N, --items N,
+ --stock N, --commands N, --sorted, --zipf S, --mix SELL,BUY,DISPLAY, and
+ --seed N) and --threads N, the number of loader threads of the parallel
+ loaders (default the number of processors).
+ Build from the repository directory with:
+ g++ -std=c++17 -O2 -pthread -I. -o StoreBenchmark benchmarks/StoreBenchmark.cpp
+ benchmarks/WorkloadGenerator.cpp $(ls *.cpp | grep -v main.cpp)
+ */
+
+#include <sys/resource.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Coin.h"
+#include "LatencyHistogram.h"
+#include "LineTokenizer.h"
+#include "StoreInventory.h"
+#include "WorkloadGenerator.h"
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ Returns the peak resident set size of the process.
+ @return The largest amount of memory the process has had resident, in megabytes.
+ @pre None
+ @post The high-water mark since the process started will be returned. It never decreases, so each
+ benchmark reports the peak of every benchmark before it too.
+ */
+double peakRssMegabytes()
+{
+   struct rusage usage;
+   getrusage(RUSAGE_SELF, &usage);
+   return usage.ru_maxrss / 1024.0;
+}
+
+/**
+ Prints the results of one benchmark.
+ @param name The name of the benchmark.
+ @param operations The number of operations timed.
+ @param seconds The time taken by all of the operations.
+ @param latencies The time of each operation in nanoseconds, or nullptr if the operations were only
+ timed together.
+ @pre None
+ @post One line of throughput and memory, and one of latencies if there are any, will be printed.
+ */
+void report(const std::string& name, std::size_t operations, double seconds,
+            const LatencyHistogram* latencies)
+{
+   std::cout << name << ": " << operations << " ops in " << seconds << " s, "
+             << static_cast<long long>(operations / seconds) << " ops/s, peak RSS "
+             << peakRssMegabytes() << " MB" << std::endl;
+   if ( latencies != nullptr )
+   {
+      OutputBuffer buffer;
+      buffer.append("   latency ");
+      latencies->format(buffer);
+      std::cout << buffer.view() << std::flush;
+   }
+}
+
+/**
+ Times one operation.
+ @param operation The operation.
+ @param latencies The histogram to record the time of the operation in.
+ @pre None
+ @post The operation will have been called once and its time in nanoseconds recorded.
+ */
+template<typename Operation>
+void timeOperation(Operation operation, LatencyHistogram& latencies)
+{
+   Clock::time_point start = Clock::now();
+   operation();
+   latencies.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      Clock::now() - start).count());
+}
+
+/**
+ Returns the seconds elapsed since a time.
+ @param start The time.
+ @pre None
+ @post The time from start until now will be returned.
+ */
+double secondsSince(Clock::time_point start)
+{
+   return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ Benchmarks inserting, retrieving, and removing the coins of the workload in a SearchTree.
+ @param settings The workload.
+ @pre None
+ @post Every coin will have been inserted once, retrieved by popularity as often as the workload
+ has commands, and removed once, and the results printed.
+ */
+void benchmarkTree(const WorkloadGenerator::Settings& settings)
+{
+   //the coins are every third item, created from the fields the generator writes
+   WorkloadGenerator generator(settings);
+   std::vector<Coin*> coins;
+   OutputBuffer text;
+   LineTokenizer tokenizer;
+   for ( std::size_t item = 0; item < settings.items; item += 3 )
+   {
+      text.clear();
+      generator.writeItem(item, text);
+      Coin* coin = new Coin;
+      coin->setData(tokenizer.split(text.view()).subspan(1));
+      coins.push_back(coin);
+   }
+   if ( !settings.sortedInsertion )
+      std::shuffle(coins.begin(), coins.end(), generator.getRandom());
+
+   //the tree takes ownership of the coins, so it is given copies
+   SearchTree<Coin> tree;
+   LatencyHistogram latencies;
+   Clock::time_point start = Clock::now();
+   for ( std::size_t i = 0; i < coins.size(); i++ )
+   {
+      Coin* copy = new Coin(*coins[i]);
+      timeOperation([&tree, copy]() { tree.insert(copy); }, latencies);
+   }
+   report("tree insert", coins.size(), secondsSince(start), &latencies);
+
+   //the item numbers of the coins are the multiples of 3
+   std::vector<const Coin*> byItem(coins.size());
+   for ( std::size_t i = 0; i < coins.size(); i++ )
+      byItem[i] = coins[i];
+   std::sort(byItem.begin(), byItem.end(),
+             [](const Coin* left, const Coin* right) { return *left < *right; });
+   latencies.reset();
+   start = Clock::now();
+   for ( std::size_t i = 0; i < settings.commands; i++ )
+   {
+      const Coin* key = byItem[generator.nextItem() / 3];
+      timeOperation([&tree, key]() { tree.retrieve(*key); }, latencies);
+   }
+   report("tree retrieve", settings.commands, secondsSince(start), &latencies);
+
+   latencies.reset();
+   start = Clock::now();
+   for ( std::size_t i = 0; i < coins.size(); i++ )
+   {
+      const Coin* key = coins[i];
+      timeOperation([&tree, key]() { tree.remove(*key); }, latencies);
+   }
+   report("tree remove", coins.size(), secondsSince(start), &latencies);
+
+   for ( std::size_t i = 0; i < coins.size(); i++ )
+      delete coins[i];
+}
+
+/**
+ Benchmarks one loader on a fresh store.
+ @param name The name of the benchmark.
+ @param lines The number of lines loaded.
+ @param threadCount The number of loader threads.
+ @param load The loader, called with the store.
+ @pre None
+ @post The loader will have been called once and the results printed.
+ */
+void benchmarkLoader(const std::string& name, std::size_t lines,
+                     int threadCount,
+                     const std::function<void(StoreInventory&)>& load)
+{
+   StoreInventory store;
+   store.setErrorFile("/dev/null");
+   store.setLoaderThreads(threadCount);
+   Clock::time_point start = Clock::now();
+   load(store);
+   report(name, lines, secondsSince(start), nullptr);
+}
+
+/**
+ Writes the contents of a buffer to a file.
+ @param fileName The name of the file. It is created or truncated.
+ @param buffer The contents.
+ @pre None
+ @post The file will hold the contents of the buffer.
+ */
+void writeFile(const std::string& fileName, const OutputBuffer& buffer)
+{
+   std::ofstream file(fileName, std::ios::binary);
+   file.write(buffer.view().data(), buffer.view().size());
+}
+
+
+int main(int argc, char* argv[])
+{
+   WorkloadGenerator::Settings settings;
+   int threadCount = std::max(1u, std::thread::hardware_concurrency());
+   for ( int i = 1; i < argc; i++ )
+   {
+      int used = WorkloadGenerator::readOption(argc, argv, i, settings);
+      if ( used < 0 )
+         return 1;
+      else if ( used > 0 )
+         i += used - 1;
+      else if ( std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc
+               && std::atoi(argv[i + 1]) > 0 )
+         threadCount = std::atoi(argv[++i]);
+      else
+      {
+         std::cerr << "Unknown option: " << argv[i] << std::endl;
+         return 1;
+      }
+   }
+
+   WorkloadGenerator generator(settings);
+   OutputBuffer customers;
+   OutputBuffer inventory;
+   OutputBuffer commands;
+   generator.writeCustomers(customers);
+   generator.writeInventory(inventory);
+   generator.writeCommands(commands);
+
+   //the file loaders read the workload from a directory of its own
+   char directory[] = "/tmp/StoreBenchmarkXXXXXX";
+   if ( mkdtemp(directory) == nullptr )
+   {
+      std::cerr << "Temporary directory could not be created." << std::endl;
+      return 1;
+   }
+   std::string customerFileName = std::string(directory) + "/hw4customers.txt";
+   std::string inventoryFileName = std::string(directory) + "/hw4inventory.txt";
+   std::string commandFileName = std::string(directory) + "/hw4commands.txt";
+   writeFile(customerFileName, customers);
+   writeFile(inventoryFileName, inventory);
+   writeFile(commandFileName, commands);
+
+   benchmarkTree(settings);
+
+   benchmarkLoader("customers from file", settings.customers, 1,
+                   [&customerFileName](StoreInventory& store)
+      {
+         std::ifstream file(customerFileName);
+         store.addCustomersFromFile(file);
+      });
+   benchmarkLoader("customers from text", settings.customers, 1,
+                   [&customers](StoreInventory& store)
+      {
+         store.addCustomersFromText(customers.view());
+      });
+   benchmarkLoader("customers from text, "
+                   + std::to_string(threadCount) + " threads",
+                   settings.customers, threadCount,
+                   [&customers](StoreInventory& store)
+      {
+         store.addCustomersFromText(customers.view());
+      });
+   benchmarkLoader("inventory from file", settings.items, 1,
+                   [&inventoryFileName](StoreInventory& store)
+      {
+         std::ifstream file(inventoryFileName);
+         store.buildInventoryFromFile(file);
+      });
+   benchmarkLoader("inventory from text", settings.items, 1,
+                   [&inventory](StoreInventory& store)
+      {
+         store.buildInventoryFromText(inventory.view());
+      });
+   benchmarkLoader("inventory from text, "
+                   + std::to_string(threadCount) + " threads",
+                   settings.items, threadCount,
+                   [&inventory](StoreInventory& store)
+      {
+         store.buildInventoryFromText(inventory.view());
+      });
+
+   //the whole command file, in the store's default windows
+   {
+      StoreInventory store;
+      store.setOutputFile("/dev/null");
+      store.setErrorFile("/dev/null");
+      store.addCustomersFromText(customers.view());
+      store.buildInventoryFromText(inventory.view());
+      std::ifstream file(commandFileName);
+      Clock::time_point start = Clock::now();
+      store.processCommandsFromFile(file);
+      report("commands from file", settings.commands, secondsSince(start),
+             nullptr);
+   }
+
+   //each command applied on its own, as the daemon's flushed mode does
+   {
+      StoreInventory store;
+      store.setOutputFile("/dev/null");
+      store.setErrorFile("/dev/null");
+      store.setTradeWindow(1);
+      store.addCustomersFromText(customers.view());
+      store.buildInventoryFromText(inventory.view());
+      LatencyHistogram latencies;
+      std::string_view contents = commands.view();
+      std::size_t position = 0;
+      std::string_view line;
+      Clock::time_point start = Clock::now();
+      while ( LineTokenizer::nextLine(contents, position, line) )
+      {
+         timeOperation([&store, line]()
+            {
+               store.processCommand(line);
+               store.finishCommands();
+            }, latencies);
+      }
+      report("single commands", settings.commands, secondsSince(start),
+             &latencies);
+   }
+
+   unlink(customerFileName.c_str());
+   unlink(inventoryFileName.c_str());
+   unlink(commandFileName.c_str());
+   rmdir(directory);
+   return 0;
+}
@@ -0,0 +1,292 @@
+/*
+ file name: WorkloadGenerator.cpp
+ author: Hall, Ashley
+ The WorkloadGenerator class writes synthetic customer, inventory, and command
+ files in the formats the store reads, at any scale. Every item and customer
+ is derived from its number, so the files are reproducible from the settings
+ and the seed. Customers and inventory lines can be written in sorted order,
+ the worst case for the unbalanced trees, or shuffled. Commands choose their
+ items with a Zipf distribution, so a few items are traded far more often than
+ the rest, and mix sells, buys, inventory displays, and customer summaries in
+ configurable proportions.
+ */
+
+#include "WorkloadGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+
+/**
+ WorkloadGenerator constructor.
+ @param settings The scale and distribution of the workload.
+ @pre The percentages must not add up to more than 100. The commands left over are customer
+ summaries.
+ @post A generator whose files follow settings will be created.
+ */
+WorkloadGenerator::WorkloadGenerator(const Settings& settings)
+: settings(settings), random(settings.seed)
+{
+   //rank r is chosen with a weight of 1 / r^s
+   std::size_t itemCount = std::max<std::size_t>(settings.items, 1);
+   popularity.resize(itemCount);
+   double total = 0;
+   for ( std::size_t rank = 0; rank < itemCount; rank++ )
+   {
+      total += 1 / std::pow(static_cast<double>(rank + 1),
+                            settings.zipfExponent);
+      popularity[rank] = total;
+   }
+   for ( std::size_t rank = 0; rank < itemCount; rank++ )
+      popularity[rank] /= total;
+
+   //the popular items are spread over every type and the whole sort order
+   itemOfRank.resize(itemCount);
+   std::iota(itemOfRank.begin(), itemOfRank.end(), 0);
+   std::shuffle(itemOfRank.begin(), itemOfRank.end(), random);
+}
+
+/**
+ Writes the customer file.
+ @param buffer The buffer to write to.
+ @pre None.
+ @post One line per customer, with IDs from 0 and names of letters only, will be appended. The
+ names are in sorted order or shuffled by the seed, as the inventory is.
+ */
+void WorkloadGenerator::writeCustomers(OutputBuffer& buffer) const
+{
+   std::vector<std::size_t> names(settings.customers);
+   std::iota(names.begin(), names.end(), 0);
+   if ( !settings.sortedInsertion )
+   {
+      std::mt19937_64 shuffler(settings.seed + 2);
+      std::shuffle(names.begin(), names.end(), shuffler);
+   }
+
+   for ( std::size_t i = 0; i < settings.customers; i++ )
+   {
+      buffer.appendUnsigned(i).append(", ");
+      writeWord(names[i], buffer);
+      buffer.append(" Customer\n");
+   }
+}
+
+/**
+ Writes the inventory file.
+ @param buffer The buffer to write to.
+ @pre None.
+ @post One line per item with a count of stockPerItem will be appended, in sorted order or
+ shuffled by the seed.
+ */
+void WorkloadGenerator::writeInventory(OutputBuffer& buffer) const
+{
+   std::vector<std::size_t> order(settings.items);
+   std::iota(order.begin(), order.end(), 0);
+   if ( !settings.sortedInsertion )
+   {
+      std::mt19937_64 shuffler(settings.seed + 1);
+      std::shuffle(order.begin(), order.end(), shuffler);
+   }
+
+   //an inventory line is a command's item with the count after the type
+   OutputBuffer item;
+   for ( std::size_t i = 0; i < order.size(); i++ )
+   {
+      item.clear();
+      writeItem(order[i], item);
+      std::string_view fields = item.view();
+      buffer.append(fields.substr(0, 1)).append(", ")
+         .appendInt(settings.stockPerItem).append(fields.substr(1))
+         .append('\n');
+   }
+}
+
+/**
+ Writes the command file.
+ @param buffer The buffer to write to.
+ @pre None.
+ @post The commands will be appended, choosing items by popularity and commands by the mix.
+ */
+void WorkloadGenerator::writeCommands(OutputBuffer& buffer)
+{
+   std::uniform_int_distribution<int> percent(0, 99);
+   std::uniform_int_distribution<std::size_t> customer(
+      0, std::max<std::size_t>(settings.customers, 1) - 1);
+   for ( std::size_t i = 0; i < settings.commands; i++ )
+   {
+      int choice = percent(random);
+      if ( choice < settings.sellPercent + settings.buyPercent )
+      {
+         buffer.append(choice < settings.sellPercent ? "S, " : "B, ")
+            .appendUnsigned(customer(random)).append(", ");
+         writeItem(nextItem(), buffer);
+         buffer.append('\n');
+      }
+      else if ( choice < settings.sellPercent + settings.buyPercent
+                         + settings.displayPercent )
+         buffer.append("D\n");
+      else
+         buffer.append("A, ").appendUnsigned(customer(random)).append('\n');
+   }
+}
+
+/**
+ Writes the type and data fields of an item, as in a sell or buy command.
+ @param item The number of the item, less than the number of items.
+ @param buffer The buffer to write to.
+ @pre None.
+ @post The type and fields, separated by commas, will be appended. Numbers close together in the
+ same type give items close together in the type's sort order.
+ */
+void WorkloadGenerator::writeItem(std::size_t item, OutputBuffer& buffer) const
+{
+   const char* GRADES[] = {"Mint", "Near Mint", "Good"};
+
+   //the word is the first field each type sorts by
+   std::size_t number = item / ITEM_TYPES;
+   int year = 1900 + static_cast<int>(number % 100);
+   switch ( item % ITEM_TYPES )
+   {
+      case 0:
+         buffer.append("M, ").appendInt(year).append(", ")
+            .appendInt(1 + number % 70).append(", ");
+         writeWord(number, buffer);
+         break;
+      case 1:
+         buffer.append("C, ").appendInt(year).append(", ")
+            .append(GRADES[number % 3]).append(", Title, ");
+         writeWord(number, buffer);
+         break;
+      default:
+         buffer.append("S, ").appendInt(year).append(", ")
+            .append(GRADES[number % 3]).append(", ");
+         writeWord(number, buffer);
+         buffer.append(", Topps");
+         break;
+   }
+}
+
+/**
+ Chooses an item by popularity.
+ @return The number of the item.
+ @pre None.
+ @post An item will be returned with a probability that falls with the zipfExponent power of its
+ popularity rank.
+ */
+std::size_t WorkloadGenerator::nextItem()
+{
+   std::uniform_real_distribution<double> uniform(0, 1);
+   std::size_t rank = std::lower_bound(popularity.begin(), popularity.end(),
+                                       uniform(random)) - popularity.begin();
+   return itemOfRank[std::min(rank, itemOfRank.size() - 1)];
+}
+
+/**
+ Returns the generator's random number engine.
+ @pre None.
+ @post The engine, seeded from the settings, will be returned.
+ */
+std::mt19937_64& WorkloadGenerator::getRandom()
+{
+   return random;
+}
+
+/**
+ Reads one workload option from a command line into settings.
+ @param argc The number of arguments.
+ @param argv The arguments.
+ @param index The position of the option.
+ @param settings The settings to change.
+ @return The number of arguments the option used, 0 if argv[index] is not a workload option, or
+ -1 if its value is missing or invalid.
+ @pre index must be less than argc.
+ @post The options are --customers N, --items N, --stock N, --commands N, --sorted, --zipf S,
+ --mix SELL,BUY,DISPLAY, and --seed N. An error message will be output for an invalid value.
+ */
+int WorkloadGenerator::readOption(int argc, char* argv[], int index,
+                                  Settings& settings)
+{
+   const char* option = argv[index];
+   if ( std::strcmp(option, "--sorted") == 0 )
+   {
+      settings.sortedInsertion = true;
+      return 1;
+   }
+   if ( std::strcmp(option, "--customers") != 0
+       && std::strcmp(option, "--items") != 0
+       && std::strcmp(option, "--stock") != 0
+       && std::strcmp(option, "--commands") != 0
+       && std::strcmp(option, "--zipf") != 0
+       && std::strcmp(option, "--mix") != 0
+       && std::strcmp(option, "--seed") != 0 )
+      return 0;
+
+   if ( index + 1 >= argc )
+   {
+      std::cerr << "Missing value for " << option << std::endl;
+      return -1;
+   }
+   const char* value = argv[index + 1];
+   bool valid = true;
+   if ( std::strcmp(option, "--customers") == 0 )
+      settings.customers = std::strtoull(value, nullptr, 10);
+   else if ( std::strcmp(option, "--items") == 0 )
+   {
+      settings.items = std::strtoull(value, nullptr, 10);
+      valid = settings.items > 0;
+   }
+   else if ( std::strcmp(option, "--stock") == 0 )
+   {
+      settings.stockPerItem = std::atoi(value);
+      valid = settings.stockPerItem > 0;
+   }
+   else if ( std::strcmp(option, "--commands") == 0 )
+      settings.commands = std::strtoull(value, nullptr, 10);
+   else if ( std::strcmp(option, "--zipf") == 0 )
+   {
+      settings.zipfExponent = std::atof(value);
+      valid = settings.zipfExponent >= 0;
+   }
+   else if ( std::strcmp(option, "--seed") == 0 )
+      settings.seed = std::strtoul(value, nullptr, 10);
+   else
+   {
+      valid = std::sscanf(value, "%d,%d,%d", &settings.sellPercent,
+                          &settings.buyPercent, &settings.displayPercent) == 3
+         && settings.sellPercent >= 0 && settings.buyPercent >= 0
+         && settings.displayPercent >= 0
+         && settings.sellPercent + settings.buyPercent
+            + settings.displayPercent <= 100;
+   }
+
+   if ( !valid )
+   {
+      std::cerr << "Invalid value for " << option << ": " << value << std::endl;
+      return -1;
+   }
+   return 2;
+}
+
+/**
+ Writes a number as a fixed-width word of capital and small letters.
+ @param number The number.
+ @param buffer The buffer to write to.
+ @pre None.
+ @post Six letters will be appended. Smaller numbers give words that sort first.
+ */
+void WorkloadGenerator::writeWord(std::size_t number, OutputBuffer& buffer)
+{
+   const int LETTERS = 6;
+   char word[LETTERS];
+   for ( int i = LETTERS - 1; i >= 0; i-- )
+   {
+      word[i] = static_cast<char>('a' + number % 26);
+      number /= 26;
+   }
+   word[0] = static_cast<char>(word[0] - 'a' + 'A');
+   buffer.append(std::string_view(word, LETTERS));
+}
@@ -0,0 +1,139 @@
+/*
+ file name: WorkloadGenerator.h
+ author: Hall, Ashley
+ The WorkloadGenerator class writes synthetic customer, inventory, and command
+ files in the formats the store reads, at any scale. Every item and customer
+ is derived from its number, so the files are reproducible from the settings
+ and the seed. Customers and inventory lines can be written in sorted order,
+ the worst case for the unbalanced trees, or shuffled. Commands choose their
+ items with a Zipf distribution, so a few items are traded far more often than
+ the rest, and mix sells, buys, inventory displays, and customer summaries in
+ configurable proportions.
+ */
+
+#ifndef WORKLOADGENERATOR_H
+#define WORKLOADGENERATOR_H
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "OutputBuffer.h"
+
+class WorkloadGenerator
+{
+public:
+
+   /*
+    The scale and distribution of a workload.
+    */
+   struct Settings
+   {
+      std::size_t customers = 10000; //lines in the customer file
+      std::size_t items = 30000; //distinct items in the inventory file
+      int stockPerItem = 5; //count of each item in the inventory file
+      std::size_t commands = 200000; //lines in the command file
+      bool sortedInsertion = false; //true to write names and items in sorted order
+      double zipfExponent = 1.0; //skew of item popularity, 0 for uniform
+      int sellPercent = 45; //percentage of sell commands
+      int buyPercent = 45; //percentage of buy commands
+      int displayPercent = 0; //percentage of inventory displays
+      unsigned seed = 1; //seed of the random choices
+   };
+
+   /**
+    WorkloadGenerator constructor.
+    @param settings The scale and distribution of the workload.
+    @pre The percentages must not add up to more than 100. The commands left over are customer
+    summaries.
+    @post A generator whose files follow settings will be created.
+    */
+   explicit WorkloadGenerator(const Settings& settings);
+
+   /**
+    Writes the customer file.
+    @param buffer The buffer to write to.
+    @pre None.
+    @post One line per customer, with IDs from 0 and names of letters only, will be appended. The
+    names are in sorted order or shuffled by the seed, as the inventory is.
+    */
+   void writeCustomers(OutputBuffer& buffer) const;
+
+   /**
+    Writes the inventory file.
+    @param buffer The buffer to write to.
+    @pre None.
+    @post One line per item with a count of stockPerItem will be appended, in sorted order or
+    shuffled by the seed.
+    */
+   void writeInventory(OutputBuffer& buffer) const;
+
+   /**
+    Writes the command file.
+    @param buffer The buffer to write to.
+    @pre None.
+    @post The commands will be appended, choosing items by popularity and commands by the mix.
+    */
+   void writeCommands(OutputBuffer& buffer);
+
+   /**
+    Writes the type and data fields of an item, as in a sell or buy command.
+    @param item The number of the item, less than the number of items.
+    @param buffer The buffer to write to.
+    @pre None.
+    @post The type and fields, separated by commas, will be appended. Numbers close together in the
+    same type give items close together in the type's sort order.
+    */
+   void writeItem(std::size_t item, OutputBuffer& buffer) const;
+
+   /**
+    Chooses an item by popularity.
+    @return The number of the item.
+    @pre None.
+    @post An item will be returned with a probability that falls with the zipfExponent power of its
+    popularity rank.
+    */
+   std::size_t nextItem();
+
+   /**
+    Returns the generator's random number engine.
+    @pre None.
+    @post The engine, seeded from the settings, will be returned.
+    */
+   std::mt19937_64& getRandom();
+
+   /**
+    Reads one workload option from a command line into settings.
+    @param argc The number of arguments.
+    @param argv The arguments.
+    @param index The position of the option.
+    @param settings The settings to change.
+    @return The number of arguments the option used, 0 if argv[index] is not a workload option, or
+    -1 if its value is missing or invalid.
+    @pre index must be less than argc.
+    @post The options are --customers N, --items N, --stock N, --commands N, --sorted, --zipf S,
+    --mix SELL,BUY,DISPLAY, and --seed N. An error message will be output for an invalid value.
+    */
+   static int readOption(int argc, char* argv[], int index, Settings& settings);
+
+private:
+
+   /**
+    Writes a number as a fixed-width word of capital and small letters.
+    @param number The number.
+    @param buffer The buffer to write to.
+    @pre None.
+    @post Six letters will be appended. Smaller numbers give words that sort first.
+    */
+   static void writeWord(std::size_t number, OutputBuffer& buffer);
+
+   Settings settings; //scale and distribution of the workload
+   std::mt19937_64 random; //source of every random choice
+   std::vector<double> popularity; //cumulative probability of each rank
+   std::vector<std::size_t> itemOfRank; //item at each popularity rank
+
+   //item types, each written by writeItem in turn
+   static const int ITEM_TYPES = 3;
+};
+
+#endif
@@ -4,6 +4,43 @@
  Creates a StoreInventory object, fills it with customers and inventory items
  from the customerFile and inventoryFile, respectively, and processes commands
  on the StoreInventory object from a commandFile.
+ The files are memory-mapped and parsed in place. Running the program with the
+ option --stream reads them line by line through std::ifstream instead. The
+ option --threads N parses the customer and inventory files on N threads. The
+ option --trade-window N applies up to N consecutive buy and sell commands
+ together; 1 applies each command as it is read. The option --trade-threads N
+ applies the trades of each window to the different item type trees on N
+ threads. The option --pipeline parses the commands on a thread of their own
+ while the main thread executes them. The options --output FILE and --errors
+ FILE write the command output and the input file errors to files instead of
+ standard output and standard error. The option --wal DIR logs the buy and
+ sell commands in DIR, which is created if it does not exist, and checkpoints
+ the store there every --checkpoint-interval N logged commands. If DIR holds a
+ checkpoint from an earlier run the store is restored from it and its log
+ instead of the customer and inventory files, and the command lines it already
+ applied are skipped; commands read by the daemon mode are new and numbered
+ after them. The option --snapshot FILE starts the store from a binary
+ snapshot instead of the customer and inventory files, and --save-snapshot
+ FILE saves one after the commands have been processed. The option --daemon
+ loads the store and then processes commands from standard input as they
+ arrive, writing the output of each command as soon as it has been applied,
+ until the input ends or SIGINT or SIGTERM is received. --fifo PATH does the
+ same with commands written to the FIFO at PATH, which is reopened whenever
+ its writers close it. With --batch the commands that arrive in one read are
+ applied and output together. On exit the daemon writes the count, mean,
+ percentiles, and maximum of the command latencies to standard error. The
+ option --stores DIR hosts every store in DIR in one process: each
+ subdirectory named by a store number holds that store's customer and
+ inventory files, every line of the command file starts with a store number
+ and a colon, and each store's output and errors are written to hw4output.txt
+ and hw4errors.txt in its subdirectory. The stores are divided among --shards
+ N threads, by default one per processor, that execute their commands in
+ parallel. The option --stats FILE writes the latency percentiles of each
+ command type and the error and operation counters to FILE as JSON when the
+ commands end; with --stores the statistics of all of the stores are combined.
+ The option --trace FILE writes a Chrome trace-event JSON file of the time
+ spent in each phase of loading and of one in every --trace-sample N commands,
+ by default 64.
  Assumptions:
  The customer, inventory, and command files are named: hw4customers.txt,
  hw4inventory.txt, and hw4commands.txt, respectively.
@@ -12,50 +49,516 @@
  */
 
 
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
 #include "StoreInventory.h"
+#include "MappedFile.h"
+#include "MultiStore.h"
+#include "Trace.h"
+
+
+/**
+ Loads the files through std::ifstream and processes the commands.
+ @param storeInv The store to load.
+ @param customerFileName The name of the customer file.
+ @param inventoryFileName The name of the inventory file.
+ @param commandFileName The name of the command file, or an empty name when the commands are
+ read from a stream instead.
+ @param loadStore False to skip the customer and inventory files, when the store was restored from
+ its write-ahead log or a snapshot.
+ @return 0 if every file was opened. 1 otherwise.
+ @pre None
+ @post The store will be loaded and the commands processed, or an error message will be output.
+ */
+int loadFromStreams(StoreInventory& storeInv,
+                    const std::string& customerFileName,
+                    const std::string& inventoryFileName,
+                    const std::string& commandFileName, bool loadStore)
+{
+   //read from the customer, inventory, and command files
+   std::ifstream customerFile;
+   std::ifstream inventoryFile;
+   if ( loadStore )
+   {
+      customerFile.open(customerFileName);
+      if (!customerFile) {
+         std::cerr << "File could not be opened." << std::endl;
+         return 1;
+      }
+
+      inventoryFile.open(inventoryFileName);
+      if (!inventoryFile) {
+         std::cerr << "File could not be opened." << std::endl;
+         return 1;
+      }
+   }
+
+   std::ifstream commandFile;
+   if ( !commandFileName.empty() )
+   {
+      commandFile.open(commandFileName);
+      if (!commandFile) {
+         std::cerr << "File could not be opened." << std::endl;
+         return 1;
+      }
+   }
+
+   if ( loadStore )
+   {
+      //add customers to storeInv
+      storeInv.addCustomersFromFile(customerFile);
+
+      //add Collectible items to storeInv
+      storeInv.buildInventoryFromFile(inventoryFile);
+   }
 
+   //process commands on storeInv
+   if ( !commandFileName.empty() )
+      storeInv.processCommandsFromFile(commandFile);
+
+   return 0;
+}
 
-int main()
+/**
+ Loads the files through memory mappings and processes the commands.
+ @param storeInv The store to load.
+ @param customerFileName The name of the customer file.
+ @param inventoryFileName The name of the inventory file.
+ @param commandFileName The name of the command file, or an empty name when the commands are
+ read from a stream instead.
+ @param loadStore False to skip the customer and inventory files, when the store was restored from
+ its write-ahead log or a snapshot.
+ @return 0 if every file was opened. 1 otherwise.
+ @pre None
+ @post The store will be loaded and the commands processed, or an error message will be output.
+ */
+int loadFromMappings(StoreInventory& storeInv,
+                     const std::string& customerFileName,
+                     const std::string& inventoryFileName,
+                     const std::string& commandFileName, bool loadStore)
+{
+   //map the customer, inventory, and command files
+   MappedFile customerFile;
+   MappedFile inventoryFile;
+   if ( loadStore )
+   {
+      if (!customerFile.open(customerFileName)) {
+         std::cerr << "File could not be opened." << std::endl;
+         return 1;
+      }
+
+      if (!inventoryFile.open(inventoryFileName)) {
+         std::cerr << "File could not be opened." << std::endl;
+         return 1;
+      }
+   }
+
+   MappedFile commandFile;
+   if ( !commandFileName.empty() && !commandFile.open(commandFileName) ) {
+      std::cerr << "File could not be opened." << std::endl;
+      return 1;
+   }
+
+   if ( loadStore )
+   {
+      //add customers to storeInv
+      storeInv.addCustomersFromText(customerFile.getContents());
+
+      //add Collectible items to storeInv
+      storeInv.buildInventoryFromText(inventoryFile.getContents());
+   }
+
+   //process commands on storeInv
+   if ( !commandFileName.empty() )
+      storeInv.processCommandsFromText(commandFile.getContents());
+
+   return 0;
+}
+
+//set by SIGINT and SIGTERM to end the daemon mode
+volatile std::sig_atomic_t stopRequested = 0;
+
+/**
+ Requests the end of the daemon mode.
+ @pre None
+ @post stopRequested will be set.
+ */
+void requestStop(int)
+{
+   stopRequested = 1;
+}
+
+/**
+ Processes commands from standard input, or from a FIFO that is reopened each time its writers
+ close it, until the input ends or SIGINT or SIGTERM is received.
+ @param storeInv The loaded store.
+ @param fifoName The name of the FIFO, or nullptr to read standard input.
+ @param flushEachCommand False to apply and output the commands of each read together.
+ @return 0 if the commands were served. 1 if the FIFO could not be opened.
+ @pre None
+ @post The commands received will have been processed and their latencies written to standard
+ error.
+ */
+int serveCommands(StoreInventory& storeInv, const char* fifoName,
+                  bool flushEachCommand)
+{
+   //interrupt a blocked read or open rather than restart it
+   struct sigaction action = {};
+   action.sa_handler = requestStop;
+   sigemptyset(&action.sa_mask);
+   sigaction(SIGINT, &action, nullptr);
+   sigaction(SIGTERM, &action, nullptr);
+
+   int result = 0;
+   if ( fifoName == nullptr )
+      storeInv.processCommandsFromStream(STDIN_FILENO, flushEachCommand);
+   else
+   {
+      while ( !stopRequested )
+      {
+         //opening blocks until a writer connects
+         int fileDescriptor = ::open(fifoName, O_RDONLY);
+         if ( fileDescriptor < 0 )
+         {
+            if ( errno == EINTR )
+               continue;
+            std::cerr << "File could not be opened." << std::endl;
+            result = 1;
+            break;
+         }
+         storeInv.processCommandsFromStream(fileDescriptor, flushEachCommand);
+         ::close(fileDescriptor);
+      }
+   }
+
+   storeInv.flushOutput();
+   OutputBuffer report;
+   report.append("Command latency: ");
+   storeInv.getStreamLatencies().format(report);
+   std::cerr << report.view();
+   return result;
+}
+
+/**
+ Writes command statistics to a file as JSON.
+ @param stats The statistics.
+ @param fileName The name of the file. It is created or truncated.
+ @return 0 if the file was written. 1 otherwise.
+ @pre None
+ @post The file will hold the statistics, or an error message will be output.
+ */
+int writeStats(const CommandStats& stats, const std::string& fileName)
+{
+   OutputBuffer json;
+   stats.formatJson(json);
+   std::ofstream statsFile(fileName);
+   statsFile << json.view();
+   if ( !statsFile )
+   {
+      std::cerr << "Statistics could not be written." << std::endl;
+      return 1;
+   }
+   return 0;
+}
+
+/**
+ Writes the trace file if tracing was started.
+ @param result The exit status of the run.
+ @return result, or 1 if the trace file could not be written.
+ @pre No thread but the caller may be running store code.
+ @post The trace file will hold the spans recorded, or an error message will be output.
+ */
+int finishTrace(int result)
+{
+   if ( Trace::isStarted() && !Trace::stop() )
+   {
+      std::cerr << "Trace could not be written." << std::endl;
+      return 1;
+   }
+   return result;
+}
+
+/**
+ Loads every store in a directory into a MultiStore and processes the commands for all of them.
+ @param directory The directory holding a subdirectory for each store, named by the store's
+ number, with the store's customer and inventory files.
+ @param commandFileName The name of the command file. Every line starts with a store number and a
+ colon.
+ @param shardCount The number of threads that execute commands.
+ @param tradeWindow The trade window of every store, or 0 for the default.
+ @param statsFileName The file to write the statistics of all of the stores to, or nullptr.
+ @return 0 if every file was opened. 1 otherwise.
+ @pre None
+ @post The commands will have been processed, and each store's output written to hw4output.txt and
+ its input errors to hw4errors.txt in the store's directory, or an error message will be output.
+ */
+int runStores(const std::string& directory, const std::string& commandFileName,
+              int shardCount, long tradeWindow, const char* statsFileName)
+{
+   MultiStore stores(shardCount);
+
+   //every subdirectory named by a number holds a store
+   DIR* storeDirectory = opendir(directory.c_str());
+   if ( storeDirectory == nullptr )
+   {
+      std::cerr << "File could not be opened." << std::endl;
+      return 1;
+   }
+   while ( dirent* entry = readdir(storeDirectory) )
+   {
+      char* end;
+      unsigned long storeId = std::strtoul(entry->d_name, &end, 10);
+      if ( entry->d_name[0] >= '0' && entry->d_name[0] <= '9' && *end == '\0' )
+         stores.addStore(storeId);
+   }
+   closedir(storeDirectory);
+
+   MappedFile commandFile;
+   if ( !commandFile.open(commandFileName) )
+   {
+      std::cerr << "File could not be opened." << std::endl;
+      return 1;
+   }
+
+   //load the stores in parallel
+   std::atomic<int> failures(0);
+   stores.forEachStore([&directory, tradeWindow, &failures](
+      unsigned long storeId, StoreInventory& store)
+      {
+         std::string storeDirectory = directory + "/" + std::to_string(storeId);
+         if ( tradeWindow > 0 )
+            store.setTradeWindow(tradeWindow);
+         if ( !store.setOutputFile(storeDirectory + "/hw4output.txt")
+             || !store.setErrorFile(storeDirectory + "/hw4errors.txt")
+             || loadFromMappings(store, storeDirectory + "/hw4customers.txt",
+                                 storeDirectory + "/hw4inventory.txt", "",
+                                 true) != 0 )
+            failures++;
+      });
+   if ( failures > 0 )
+      return 1;
+
+   stores.processCommandsFromText(commandFile.getContents());
+   if ( statsFileName == nullptr )
+      return 0;
+
+   CommandStats allStats;
+   std::mutex statsMutex;
+   stores.forEachStore([&allStats, &statsMutex](unsigned long,
+                                                StoreInventory& store)
+      {
+         std::lock_guard<std::mutex> lock(statsMutex);
+         allStats.merge(store.getCommandStats());
+      });
+   return writeStats(allStats, statsFileName);
+}
+
+
+int main(int argc, char* argv[])
 {
 
    std::string customerFileName =  "hw4customers.txt";
-   
+
    std::string inventoryFileName = "hw4inventory.txt";
-   
+
    std::string commandFileName = "hw4commands.txt";
-   
-   
-   //read from the customer, inventory, and command files
-   std::ifstream customerFile(customerFileName);
-   if (!customerFile) {
+
+   //read the options
+   bool useStreams = false;
+   bool pipelined = false;
+   bool daemon = false;
+   bool flushEachCommand = true;
+   const char* fifoName = nullptr;
+   const char* storeDirectory = nullptr;
+   int shardCount = std::thread::hardware_concurrency();
+   const char* outputFileName = nullptr;
+   const char* errorFileName = nullptr;
+   const char* logDirectory = nullptr;
+   const char* snapshotFileName = nullptr;
+   const char* saveSnapshotFileName = nullptr;
+   const char* statsFileName = nullptr;
+   const char* traceFileName = nullptr;
+   long traceSample = 64;
+   long checkpointInterval = 0;
+   int loaderThreads = 1;
+   long tradeWindow = 0;
+   int tradeThreads = 1;
+   for ( int i = 1; i < argc; i++ )
+   {
+      if ( std::strcmp(argv[i], "--stream") == 0 )
+         useStreams = true;
+      else if ( std::strcmp(argv[i], "--pipeline") == 0 )
+         pipelined = true;
+      else if ( std::strcmp(argv[i], "--daemon") == 0 )
+         daemon = true;
+      else if ( std::strcmp(argv[i], "--fifo") == 0 && i + 1 < argc )
+      {
+         daemon = true;
+         fifoName = argv[++i];
+      }
+      else if ( std::strcmp(argv[i], "--stores") == 0 && i + 1 < argc )
+         storeDirectory = argv[++i];
+      else if ( std::strcmp(argv[i], "--shards") == 0 && i + 1 < argc )
+      {
+         shardCount = std::atoi(argv[++i]);
+         if ( shardCount < 1 )
+         {
+            std::cerr << "Invalid shard count: " << argv[i] << std::endl;
+            return 1;
+         }
+      }
+      else if ( std::strcmp(argv[i], "--batch") == 0 )
+         flushEachCommand = false;
+      else if ( std::strcmp(argv[i], "--output") == 0 && i + 1 < argc )
+         outputFileName = argv[++i];
+      else if ( std::strcmp(argv[i], "--errors") == 0 && i + 1 < argc )
+         errorFileName = argv[++i];
+      else if ( std::strcmp(argv[i], "--wal") == 0 && i + 1 < argc )
+         logDirectory = argv[++i];
+      else if ( std::strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc )
+         snapshotFileName = argv[++i];
+      else if ( std::strcmp(argv[i], "--save-snapshot") == 0 && i + 1 < argc )
+         saveSnapshotFileName = argv[++i];
+      else if ( std::strcmp(argv[i], "--stats") == 0 && i + 1 < argc )
+         statsFileName = argv[++i];
+      else if ( std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc )
+         traceFileName = argv[++i];
+      else if ( std::strcmp(argv[i], "--trace-sample") == 0 && i + 1 < argc )
+      {
+         traceSample = std::atol(argv[++i]);
+         if ( traceSample < 1 )
+         {
+            std::cerr << "Invalid trace sample: " << argv[i] << std::endl;
+            return 1;
+         }
+      }
+      else if ( std::strcmp(argv[i], "--checkpoint-interval") == 0
+               && i + 1 < argc )
+      {
+         checkpointInterval = std::atol(argv[++i]);
+         if ( checkpointInterval < 1 )
+         {
+            std::cerr << "Invalid checkpoint interval: " << argv[i] << std::endl;
+            return 1;
+         }
+      }
+      else if ( std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc )
+      {
+         loaderThreads = std::atoi(argv[++i]);
+         if ( loaderThreads < 1 )
+         {
+            std::cerr << "Invalid thread count: " << argv[i] << std::endl;
+            return 1;
+         }
+      }
+      else if ( std::strcmp(argv[i], "--trade-threads") == 0 && i + 1 < argc )
+      {
+         tradeThreads = std::atoi(argv[++i]);
+         if ( tradeThreads < 1 )
+         {
+            std::cerr << "Invalid thread count: " << argv[i] << std::endl;
+            return 1;
+         }
+      }
+      else if ( std::strcmp(argv[i], "--trade-window") == 0 && i + 1 < argc )
+      {
+         tradeWindow = std::atol(argv[++i]);
+         if ( tradeWindow < 1 )
+         {
+            std::cerr << "Invalid trade window: " << argv[i] << std::endl;
+            return 1;
+         }
+      }
+      else
+      {
+         std::cerr << "Unknown option: " << argv[i] << std::endl;
+         return 1;
+      }
+   }
+
+   //trace the run from the start of loading
+   if ( traceFileName != nullptr && !Trace::start(traceFileName, traceSample) )
+   {
       std::cerr << "File could not be opened." << std::endl;
       return 1;
    }
-   
-   std::ifstream inventoryFile(inventoryFileName);
-   if (!inventoryFile) {
+
+   //many stores are hosted by a MultiStore instead
+   if ( storeDirectory != nullptr )
+      return finishTrace(runStores(storeDirectory, commandFileName, shardCount,
+                                   tradeWindow, statsFileName));
+
+   //instantiate a StoreInventory object
+   StoreInventory storeInv;
+   storeInv.setLoaderThreads(loaderThreads);
+   if ( tradeWindow > 0 )
+      storeInv.setTradeWindow(tradeWindow);
+   storeInv.setTradeThreads(tradeThreads);
+   storeInv.setPipelined(pipelined);
+   if ( outputFileName != nullptr && !storeInv.setOutputFile(outputFileName) )
+   {
       std::cerr << "File could not be opened." << std::endl;
       return 1;
    }
-   
-   std::ifstream commandFile(commandFileName);
-   if (!commandFile) {
+   if ( errorFileName != nullptr && !storeInv.setErrorFile(errorFileName) )
+   {
       std::cerr << "File could not be opened." << std::endl;
       return 1;
    }
-   
-   //instantiate a StoreInventory object
-   StoreInventory storeInv;
-   
-   //add customers to storeInv
-   storeInv.addCustomersFromFile(customerFile);
-   
-   //add Collectible items to storeInv
-   storeInv.buildInventoryFromFile(inventoryFile);
-   
-   //process commands on storeInv
-   storeInv.processCommandsFromFile(commandFile);
-   
-   
-   return 0;
+
+   //restore the store from its log, or start logging a new one
+   bool recovered = false;
+   if ( checkpointInterval > 0 )
+      storeInv.setCheckpointInterval(checkpointInterval);
+   if ( logDirectory != nullptr && !storeInv.openLog(logDirectory, recovered) )
+   {
+      std::cerr << "Write-ahead log could not be opened." << std::endl;
+      return 1;
+   }
+
+   //a snapshot replaces the customer and inventory files
+   bool loadStore = !recovered;
+   if ( loadStore && snapshotFileName != nullptr )
+   {
+      if ( !storeInv.loadSnapshot(snapshotFileName) )
+      {
+         std::cerr << "Snapshot could not be loaded." << std::endl;
+         return 1;
+      }
+      loadStore = false;
+   }
+
+   //the daemon mode reads its commands from a stream instead of a file
+   if ( daemon )
+      commandFileName.clear();
+
+   int result;
+   if ( useStreams )
+      result = loadFromStreams(storeInv, customerFileName, inventoryFileName,
+                               commandFileName, loadStore);
+   else
+      result = loadFromMappings(storeInv, customerFileName, inventoryFileName,
+                                commandFileName, loadStore);
+   if ( result == 0 && daemon )
+      result = serveCommands(storeInv, fifoName, flushEachCommand);
+
+   if ( result == 0 && saveSnapshotFileName != nullptr
+       && !storeInv.saveSnapshot(saveSnapshotFileName) )
+   {
+      std::cerr << "Snapshot could not be saved." << std::endl;
+      return 1;
+   }
+   if ( result == 0 && statsFileName != nullptr )
+      result = writeStats(storeInv.getCommandStats(), statsFileName);
+   return finishTrace(result);
 }